@@ -0,0 +1,130 @@
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "./core/serialized_object.h"
+
+#include "./benchmark.h"
+
+#define BENCH_WIDTH 1920
+#define BENCH_HEIGHT 1080
+#define BENCH_ITERATIONS 20
+
+using namespace std;
+using namespace Splash;
+
+/*************/
+// A regular grid of vertices, texture coordinates and normals, as sent for a Mesh
+SerializedObject makeMesh()
+{
+    const int resolution = 256;
+    vector<float> data;
+    for (int y = 0; y < resolution; ++y)
+        for (int x = 0; x < resolution; ++x)
+        {
+            auto u = static_cast<float>(x) / resolution;
+            auto v = static_cast<float>(y) / resolution;
+            data.insert(data.end(), {u * 2.f - 1.f, v * 2.f - 1.f, 0.f, 1.f, u, v, 0.f, 0.f, 1.f, 0.f});
+        }
+
+    auto buffer = SerializedObject(data.size() * sizeof(float));
+    memcpy(buffer.data(), data.data(), buffer.size());
+    return buffer;
+}
+
+/*************/
+// A smooth gradient with some grain, close to a camera frame
+SerializedObject makeImage(int channels)
+{
+    mt19937 generator(42);
+    uniform_int_distribution<int> grain(-4, 4);
+
+    auto buffer = SerializedObject(BENCH_WIDTH * BENCH_HEIGHT * channels);
+    auto pixels = reinterpret_cast<uint8_t*>(buffer.data());
+    for (int y = 0; y < BENCH_HEIGHT; ++y)
+        for (int x = 0; x < BENCH_WIDTH; ++x)
+            for (int c = 0; c < channels; ++c)
+            {
+                auto value = (x * 255 / BENCH_WIDTH + y * 255 / BENCH_HEIGHT * c) / (c + 1) + grain(generator);
+                pixels[(y * BENCH_WIDTH + x) * channels + c] = static_cast<uint8_t>(std::max(0, std::min(255, value)));
+            }
+    return buffer;
+}
+
+/*************/
+// Random data, which behaves as already compressed Hap frames
+SerializedObject makeNoise()
+{
+    mt19937 generator(42);
+    auto buffer = SerializedObject(BENCH_WIDTH * BENCH_HEIGHT / 2);
+    auto words = reinterpret_cast<uint32_t*>(buffer.data());
+    for (size_t i = 0; i < buffer.size() / sizeof(uint32_t); ++i)
+        words[i] = generator();
+    return buffer;
+}
+
+/*************/
+void benchmark(Benchmark& bench, const string& name, SerializedObject source)
+{
+    using namespace chrono;
+
+    double compressTime = 0.0;
+    double decompressTime = 0.0;
+    size_t compressedSize = source.size();
+    bool sentRaw = false;
+
+    for (int i = 0; i < BENCH_ITERATIONS; ++i)
+    {
+        auto buffer = SerializedObject(source.size());
+        memcpy(buffer.data(), source.data(), source.size());
+
+        auto start = steady_clock::now();
+        auto compressed = buffer.compress();
+        compressTime += duration_cast<duration<double>>(steady_clock::now() - start).count();
+
+        if (!compressed)
+        {
+            sentRaw = true;
+            continue;
+        }
+
+        compressedSize = compressed->size();
+        start = steady_clock::now();
+        compressed->decompress();
+        decompressTime += duration_cast<duration<double>>(steady_clock::now() - start).count();
+    }
+
+    Benchmark::Result result;
+    result.name = "compress " + name;
+    result.iterations = BENCH_ITERATIONS;
+    result.seconds = compressTime;
+    result.bytes = source.size();
+    result.metrics["ratio"] = static_cast<double>(source.size()) / compressedSize;
+    result.metrics["sent_uncompressed"] = sentRaw;
+    bench.add(result);
+
+    if (sentRaw)
+        return;
+
+    result.name = "decompress " + name;
+    result.seconds = decompressTime;
+    result.metrics.clear();
+    bench.add(result);
+}
+
+/*************/
+int main(int argc, char** argv)
+{
+    Benchmark bench("buffer_compression", argc, argv);
+
+    benchmark(bench, "mesh", makeMesh());
+    benchmark(bench, "rgb", makeImage(3));
+    benchmark(bench, "yuyv", makeImage(2));
+    benchmark(bench, "hap", makeNoise());
+
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <hap.h>
+
+#include "./utils/cgutils.h"
+
+#include "./benchmark.h"
+
+#define BENCH_ITERATIONS 50
+
+using namespace std;
+using namespace Splash;
+
+/*************/
+// DXT1 blocks following a smooth gradient, which compress about as well as a real video frame
+vector<uint8_t> makeDxt1(unsigned int width, unsigned int height)
+{
+    auto blocksX = width / 4;
+    auto blocksY = height / 4;
+    vector<uint8_t> blocks(blocksX * blocksY * 8);
+
+    for (unsigned int y = 0; y < blocksY; ++y)
+        for (unsigned int x = 0; x < blocksX; ++x)
+        {
+            auto block = &blocks[(y * blocksX + x) * 8];
+            uint16_t color0 = static_cast<uint16_t>(((x * 31 / blocksX) << 11) | ((y * 63 / blocksY) << 5) | 16);
+            uint16_t color1 = static_cast<uint16_t>(color0 + 1);
+            uint32_t indices = (x + y) % 4 == 0 ? 0x55aa55aa : 0x00000000;
+            memcpy(block, &color0, sizeof(color0));
+            memcpy(block + 2, &color1, sizeof(color1));
+            memcpy(block + 4, &indices, sizeof(indices));
+        }
+
+    return blocks;
+}
+
+/*************/
+void benchmark(Benchmark& bench, const string& name, unsigned int width, unsigned int height, unsigned int chunks)
+{
+    auto texture = makeDxt1(width, height);
+
+    const void* inputBuffers[] = {texture.data()};
+    unsigned long inputBytes[] = {texture.size()};
+    unsigned int textureFormats[] = {HapTextureFormat_RGB_DXT1};
+    unsigned int compressors[] = {HapCompressorSnappy};
+    unsigned int chunkCounts[] = {chunks};
+
+    vector<uint8_t> frame(HapMaxEncodedLength(1, inputBytes, textureFormats, chunkCounts));
+    unsigned long frameBytes = 0;
+    if (HapEncode(1, inputBuffers, inputBytes, textureFormats, compressors, chunkCounts, frame.data(), frame.size(), &frameBytes) != HapResult_No_Error)
+    {
+        cerr << "Unable to encode the Hap frame for " << name << endl;
+        return;
+    }
+
+    vector<uint8_t> decoded(texture.size());
+    string format;
+    auto& result = bench.run("hapDecodeFrame " + name,
+        BENCH_ITERATIONS,
+        [&](int) { hapDecodeFrame(frame.data(), frameBytes, decoded.data(), decoded.size(), format); },
+        texture.size());
+    result.metrics["ratio"] = static_cast<double>(texture.size()) / frameBytes;
+}
+
+/*************/
+int main(int argc, char** argv)
+{
+    Benchmark bench("hap", argc, argv);
+
+    benchmark(bench, "1080p, 1 chunk", 1920, 1080, 1);
+    benchmark(bench, "1080p, 8 chunks", 1920, 1080, 8);
+    benchmark(bench, "4K, 1 chunk", 3840, 2160, 1);
+    benchmark(bench, "4K, 8 chunks", 3840, 2160, 8);
+    benchmark(bench, "8K, 16 chunks", 7680, 4320, 16);
+
+    return 0;
+}
@@ -0,0 +1,52 @@
+#include <string>
+
+#include "./core/imagebuffer.h"
+#include "./image/image.h"
+
+#include "./benchmark.h"
+
+#define BENCH_ITERATIONS 50
+
+using namespace std;
+using namespace Splash;
+
+/*************/
+void benchmark(Benchmark& bench, const string& name, unsigned int width, unsigned int height)
+{
+    ImageBufferSpec spec(width, height, 4, 32);
+    Image source(nullptr, spec);
+    Image target(nullptr);
+
+    // Serialization shares the image with the serialized object, without copying it
+    bench.run("Image::serialize " + name, BENCH_ITERATIONS, [&](int) { auto obj = source.serialize(); }, spec.rawSize());
+
+    // Flattening copies the image after the header, as done before sending it through a socket
+    bench.run("Image::serialize + flatten " + name,
+        BENCH_ITERATIONS,
+        [&](int) {
+            auto obj = source.serialize();
+            obj->flatten();
+        },
+        spec.rawSize());
+
+    bench.run("Image::serialize + flatten + deserialize " + name,
+        BENCH_ITERATIONS,
+        [&](int) {
+            auto obj = source.serialize();
+            obj->flatten();
+            target.deserialize(obj);
+        },
+        spec.rawSize());
+}
+
+/*************/
+int main(int argc, char** argv)
+{
+    Benchmark bench("image", argc, argv);
+
+    benchmark(bench, "1080p", 1920, 1080);
+    benchmark(bench, "4K", 3840, 2160);
+    benchmark(bench, "8K", 7680, 4320);
+
+    return 0;
+}
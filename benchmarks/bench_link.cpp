@@ -0,0 +1,140 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unistd.h>
+
+#include "./core/link.h"
+#include "./core/root_object.h"
+#include "./core/serialized_object.h"
+
+#include "./benchmark.h"
+
+#define BENCH_MESSAGE_ITERATIONS 10000
+#define BENCH_BUFFER_ITERATIONS 200
+#define BENCH_TIMEOUT_MS 1000
+
+using namespace std;
+using namespace Splash;
+
+/*************/
+// A root object answering pings and buffers, or counting the answers
+class BenchRoot : public RootObject
+{
+  public:
+    BenchRoot(const string& name, const string& peerName)
+        : _peerName(peerName)
+    {
+        _name = name;
+        _linkSocketPrefix = "bench_" + to_string(static_cast<int>(getpid()));
+        _link = make_shared<Link>(this, _name);
+
+        addAttribute("ping", [&](const Values& args) {
+            _link->sendMessage(_peerName, "pong", args);
+            return true;
+        });
+
+        addAttribute("pong", [&](const Values&) {
+            signal();
+            return true;
+        });
+    }
+
+    void connect() { _link->connectTo(_peerName); }
+    Link* getLink() { return _link.get(); }
+
+    /**
+     * \brief Wait for an answer, pong or buffer acknowledgment
+     * \return Return false if no answer arrived in time
+     */
+    bool wait()
+    {
+        unique_lock<mutex> lock(_answerMutex);
+        auto received = _answerCondition.wait_for(lock, chrono::milliseconds(BENCH_TIMEOUT_MS), [&]() { return _answers != 0; });
+        if (received)
+            --_answers;
+        return received;
+    }
+
+  protected:
+    void handleSerializedObject(const string& /*name*/, shared_ptr<SerializedObject> /*obj*/) final { _link->sendMessage(_peerName, "pong", {}); }
+
+  private:
+    string _peerName;
+    mutex _answerMutex{};
+    condition_variable _answerCondition{};
+    uint64_t _answers{0};
+
+    void signal()
+    {
+        {
+            lock_guard<mutex> lock(_answerMutex);
+            ++_answers;
+        }
+        _answerCondition.notify_one();
+    }
+};
+
+/*************/
+void benchmarkBuffer(Benchmark& bench, BenchRoot& sender, const string& name, size_t size)
+{
+    auto source = make_shared<SerializedObject>(size);
+    memset(source->data(), 0x7f, size);
+
+    uint64_t timeouts = 0;
+    auto& result = bench.run(name,
+        BENCH_BUFFER_ITERATIONS,
+        [&](int) {
+            sender.getLink()->sendBuffer("buffer", source);
+            if (!sender.wait())
+                ++timeouts;
+        },
+        size);
+    result.metrics["timeouts"] = timeouts;
+}
+
+/*************/
+int main(int argc, char** argv)
+{
+    Benchmark bench("link", argc, argv);
+
+    BenchRoot world("bench_world", "bench_scene");
+    BenchRoot scene("bench_scene", "bench_world");
+    world.connect();
+    scene.connect();
+
+    uint64_t timeouts = 0;
+    auto& messageResult = bench.run("message round trip", BENCH_MESSAGE_ITERATIONS, [&](int i) {
+        world.getLink()->sendMessage("bench_scene", "ping", {i, 1.f, "some/file/path.png"});
+        if (!world.wait())
+            ++timeouts;
+    });
+    messageResult.metrics["timeouts"] = timeouts;
+
+    timeouts = 0;
+    auto& batchResult = bench.run("message batch of 16 round trip", BENCH_MESSAGE_ITERATIONS / 16, [&](int i) {
+        world.getLink()->startBatch();
+        for (int j = 0; j < 16; ++j)
+            world.getLink()->sendMessage("bench_scene", "ping", {i, j, 1.f});
+        world.getLink()->flushBatch();
+        for (int j = 0; j < 16; ++j)
+            if (!world.wait())
+                ++timeouts;
+    });
+    batchResult.metrics["timeouts"] = timeouts;
+
+    world.getLink()->useSharedMemory(false);
+    benchmarkBuffer(bench, world, "buffer round trip socket 64kB", 1 << 16);
+    benchmarkBuffer(bench, world, "buffer round trip socket 1080p", 1920 * 1080 * 4);
+    benchmarkBuffer(bench, world, "buffer round trip socket 4K", 3840 * 2160 * 4);
+
+    world.getLink()->useSharedMemory(true);
+    benchmarkBuffer(bench, world, "buffer round trip shm 64kB", 1 << 16);
+    benchmarkBuffer(bench, world, "buffer round trip shm 1080p", 1920 * 1080 * 4);
+    benchmarkBuffer(bench, world, "buffer round trip shm 4K", 3840 * 2160 * 4);
+
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+
+#include "./mesh/mesh.h"
+#include "./mesh/meshloader.h"
+
+#include "./benchmark.h"
+
+#define BENCH_ITERATIONS 10
+
+using namespace std;
+using namespace Splash;
+
+/*************/
+// A regular grid of quads with texture coordinates and normals, written as a Wavefront OBJ file
+string writeGrid(int resolution)
+{
+    auto path = "/tmp/splash_bench_mesh_" + to_string(static_cast<int>(getpid())) + "_" + to_string(resolution) + ".obj";
+    ofstream file(path, ios::out);
+
+    file << "o grid" << endl;
+    for (int y = 0; y <= resolution; ++y)
+        for (int x = 0; x <= resolution; ++x)
+        {
+            auto u = static_cast<float>(x) / resolution;
+            auto v = static_cast<float>(y) / resolution;
+            file << "v " << u * 2.f - 1.f << " " << v * 2.f - 1.f << " 0.0" << endl;
+            file << "vt " << u << " " << v << endl;
+        }
+    file << "vn 0.0 0.0 1.0" << endl;
+
+    for (int y = 0; y < resolution; ++y)
+        for (int x = 0; x < resolution; ++x)
+        {
+            auto index = y * (resolution + 1) + x + 1;
+            auto next = index + resolution + 1;
+            file << "f " << index << "/" << index << "/1 " << index + 1 << "/" << index + 1 << "/1 " << next + 1 << "/" << next + 1 << "/1 " << next << "/" << next << "/1"
+                 << endl;
+        }
+
+    return path;
+}
+
+/*************/
+void benchmark(Benchmark& bench, const string& name, int resolution)
+{
+    auto path = writeGrid(resolution);
+    auto triangles = 2 * resolution * resolution;
+
+    Loader::Obj loader;
+    auto& loadResult = bench.run("Loader::Obj::load " + name, BENCH_ITERATIONS, [&](int) { loader.load(path); });
+    loadResult.metrics["triangles"] = triangles;
+
+    Mesh source(nullptr);
+    source.read(path);
+    Mesh target(nullptr);
+
+    auto size = source.serialize()->size();
+    bench.run("Mesh::serialize " + name, BENCH_ITERATIONS, [&](int) { auto obj = source.serialize(); }, size);
+    bench.run("Mesh::serialize + deserialize " + name,
+        BENCH_ITERATIONS,
+        [&](int) {
+            auto obj = source.serialize();
+            target.deserialize(obj);
+        },
+        size);
+
+    remove(path.c_str());
+}
+
+/*************/
+int main(int argc, char** argv)
+{
+    Benchmark bench("mesh", argc, argv);
+
+    benchmark(bench, "grid 64", 64);
+    benchmark(bench, "grid 256", 256);
+    benchmark(bench, "grid 512", 512);
+
+    return 0;
+}
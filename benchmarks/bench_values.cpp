@@ -0,0 +1,94 @@
+#include <atomic>
+#include <cstdlib>
+#include <deque>
+#include <new>
+#include <string>
+
+#include "./core/base_object.h"
+#include "./core/value.h"
+
+#include "./benchmark.h"
+
+#define BENCH_ITERATIONS 100000
+
+using namespace std;
+using namespace Splash;
+
+/*************/
+// Every heap allocation of the process goes through these, so that they can be counted
+static atomic_ullong allocationCount{0};
+
+void* operator new(size_t size)
+{
+    ++allocationCount;
+    if (auto ptr = malloc(size))
+        return ptr;
+    throw bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+/*************/
+// An object with the kind of attributes found on cameras and images
+class BenchObject : public BaseObject
+{
+  public:
+    BenchObject()
+    {
+        addAttribute("position",
+            [&](const Values& args) {
+                _position[0] = args[0].as<float>();
+                _position[1] = args[1].as<float>();
+                _position[2] = args[2].as<float>();
+                return true;
+            },
+            [&]() -> Values { return {_position[0], _position[1], _position[2]}; },
+            {'n', 'n', 'n'});
+
+        addAttribute("file",
+            [&](const Values& args) {
+                _file = args[0].as<string>();
+                return true;
+            },
+            [&]() -> Values { return {_file}; },
+            {'s'});
+    }
+
+  private:
+    float _position[3]{0.f, 0.f, 0.f};
+    string _file{};
+};
+
+/*************/
+int main(int argc, char** argv)
+{
+    Benchmark bench("values", argc, argv);
+    bench.addCounter("allocs_per_op", []() { return allocationCount.load(); });
+
+    bench.run("Value(int)", BENCH_ITERATIONS, [](int i) { Value value(i); });
+    bench.run("Value(float, name)", BENCH_ITERATIONS, [](int i) { Value value(static_cast<float>(i), "name"); });
+    bench.run("Values{3 floats}", BENCH_ITERATIONS, [](int i) { Values values{1.f * i, 2.f, 3.f}; });
+    bench.run("deque<Value>{3 floats}", BENCH_ITERATIONS, [](int i) { deque<Value> values{1.f * i, 2.f, 3.f}; });
+    bench.run("Values{8 ints}", BENCH_ITERATIONS, [](int i) { Values values{i, 1, 2, 3, 4, 5, 6, 7}; });
+    bench.run("Values{string, nested}", BENCH_ITERATIONS, [](int i) { Values values{"some/file/path.png", Values{i, 2.f}}; });
+    bench.run("Values copy {3 floats}", BENCH_ITERATIONS, [source = Values{1.f, 2.f, 3.f}](int) { Values values(source); });
+    bench.run("Values copy {string, nested}", BENCH_ITERATIONS, [source = Values{"some/file/path.png", Values{1, 2.f}}](int) { Values values(source); });
+
+    BenchObject object;
+    bench.run("setAttribute(position)", BENCH_ITERATIONS, [&](int i) { object.setAttribute("position", {1.f * i, 2.f, 3.f}); });
+    bench.run("setAttribute(file)", BENCH_ITERATIONS, [&](int) { object.setAttribute("file", {"some/file/path.png"}); });
+
+    Values result;
+    bench.run("getAttribute(position)", BENCH_ITERATIONS, [&](int) { object.getAttribute("position", result); });
+    bench.run("getAttribute(file)", BENCH_ITERATIONS, [&](int) { object.getAttribute("file", result); });
+
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <libavutil/imgutils.h>
+#include <libswscale/swscale.h>
+}
+
+#include "./benchmark.h"
+
+#define BENCH_ITERATIONS 50
+
+using namespace std;
+using namespace Splash;
+
+/*************/
+// Convert between two pixel formats with the same context settings as Image_FFmpeg and Sink_Shmdata_Encoded
+void benchmark(Benchmark& bench, const string& name, int width, int height, AVPixelFormat from, AVPixelFormat to)
+{
+    uint8_t* source[4];
+    int sourceLinesize[4];
+    uint8_t* destination[4];
+    int destinationLinesize[4];
+    auto sourceSize = av_image_alloc(source, sourceLinesize, width, height, from, 32);
+    auto destinationSize = av_image_alloc(destination, destinationLinesize, width, height, to, 32);
+    if (sourceSize < 0 || destinationSize < 0)
+    {
+        cerr << "Unable to allocate the images for " << name << endl;
+        return;
+    }
+
+    // A gradient, so that the conversion does not work on constant data
+    for (int i = 0; i < sourceSize; ++i)
+        source[0][i] = static_cast<uint8_t>(i);
+
+    auto context = sws_getContext(width, height, from, width, height, to, SWS_BILINEAR, nullptr, nullptr, nullptr);
+    bench.run(name,
+        BENCH_ITERATIONS,
+        [&](int) { sws_scale(context, source, sourceLinesize, 0, height, destination, destinationLinesize); },
+        av_image_get_buffer_size(to, width, height, 1));
+
+    sws_freeContext(context);
+    av_freep(&source[0]);
+    av_freep(&destination[0]);
+}
+
+/*************/
+// Pack the planes of a decoded frame one after the other, as done by Image_FFmpeg for formats uploaded natively
+void benchmarkPacking(Benchmark& bench, const string& name, int width, int height, AVPixelFormat format)
+{
+    uint8_t* source[4];
+    int sourceLinesize[4];
+    // Decoders usually pad the lines, which forces a copy per line
+    auto sourceSize = av_image_alloc(source, sourceLinesize, width, height, format, 64);
+    if (sourceSize < 0)
+    {
+        cerr << "Unable to allocate the image for " << name << endl;
+        return;
+    }
+
+    auto size = av_image_get_buffer_size(format, width, height, 1);
+    vector<uint8_t> destination(size);
+    bench.run(name, BENCH_ITERATIONS, [&](int) { av_image_copy_to_buffer(destination.data(), size, source, sourceLinesize, format, width, height, 1); }, size);
+
+    av_freep(&source[0]);
+}
+
+/*************/
+int main(int argc, char** argv)
+{
+    Benchmark bench("yuv", argc, argv);
+
+    const vector<pair<string, pair<int, int>>> resolutions{{"1080p", {1920, 1080}}, {"4K", {3840, 2160}}, {"8K", {7680, 4320}}};
+
+    // Decoded video frames, converted before being uploaded
+    for (const auto& resolution : resolutions)
+        benchmark(bench, "YUV420P to YUYV422 " + resolution.first, resolution.second.first, resolution.second.second, AV_PIX_FMT_YUV420P, AV_PIX_FMT_YUYV422);
+
+    // Decoded video frames, kept in their planar format
+    for (const auto& resolution : resolutions)
+        benchmarkPacking(bench, "YUV420P packing " + resolution.first, resolution.second.first, resolution.second.second, AV_PIX_FMT_YUV420P);
+    for (const auto& resolution : resolutions)
+        benchmarkPacking(bench, "YUV422P10LE packing " + resolution.first, resolution.second.first, resolution.second.second, AV_PIX_FMT_YUV422P10LE);
+
+    // Rendered frames, converted before being encoded
+    for (const auto& resolution : resolutions)
+        benchmark(bench, "RGB32 to YUV420P " + resolution.first, resolution.second.first, resolution.second.second, AV_PIX_FMT_RGB32, AV_PIX_FMT_YUV420P);
+
+    return 0;
+}
@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2018 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @benchmark.h
+ * The Benchmark class, timing operations and writing the results as JSON
+ */
+
+#ifndef SPLASH_BENCHMARK_H
+#define SPLASH_BENCHMARK_H
+
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include <json/json.h>
+
+#include "./config.h"
+
+namespace Splash
+{
+
+/*************/
+/**
+ * Runs the benchmarks of a suite, prints them as a table and, if a path was
+ * given with -o on the command line, writes them as JSON so that results can
+ * be compared across releases on the same hardware.
+ */
+class Benchmark
+{
+  public:
+    struct Result
+    {
+        std::string name{};
+        uint64_t iterations{0};
+        double seconds{0.0};
+        uint64_t bytes{0};                        //!< Bytes processed per iteration, if relevant
+        std::map<std::string, double> metrics{}; //!< Additional metrics, per operation unless stated otherwise
+    };
+
+    /**
+     * \brief Constructor
+     * \param suite Suite name
+     * \param argc Argument count
+     * \param argv Arguments, "-o [file]" sets the JSON output file
+     */
+    Benchmark(const std::string& suite, int argc, char** argv)
+        : _suite(suite)
+    {
+        for (int i = 1; i < argc - 1; ++i)
+            if (std::string(argv[i]) == "-o")
+                _outputPath = argv[i + 1];
+
+        std::cout << _suite << std::endl;
+        std::cout << std::left << std::setw(40) << "operation" << std::right << std::setw(10) << "iterations" << std::setw(15) << "time/op" << std::setw(14) << "throughput"
+                  << std::endl;
+    }
+
+    /**
+     * \brief Destructor, writes the JSON output if needed
+     */
+    ~Benchmark() { write(); }
+
+    /**
+     * \brief Add a counter read before and after each benchmark, its difference being reported per operation
+     * \param name Counter name
+     * \param counter Function returning the counter value
+     */
+    void addCounter(const std::string& name, const std::function<uint64_t()>& counter) { _counters[name] = counter; }
+
+    /**
+     * \brief Time a function, after running it once to warm up
+     * \param name Benchmark name
+     * \param iterations Number of iterations
+     * \param func Function to time, called with the iteration index
+     * \param bytes Bytes processed per iteration, to compute a throughput
+     * \return Return the result, to which metrics can be added
+     */
+    template <typename F>
+    Result& run(const std::string& name, uint64_t iterations, F&& func, uint64_t bytes = 0)
+    {
+        using namespace std::chrono;
+
+        func(0);
+
+        // Counters are read into preallocated storage, so that reading them does not change them
+        std::vector<uint64_t> countersBefore(_counters.size());
+        std::vector<uint64_t> countersAfter(_counters.size());
+        size_t index = 0;
+        for (const auto& counter : _counters)
+            countersBefore[index++] = counter.second();
+
+        auto start = steady_clock::now();
+        for (uint64_t i = 0; i < iterations; ++i)
+            func(i);
+        auto seconds = duration_cast<duration<double>>(steady_clock::now() - start).count();
+
+        index = 0;
+        for (const auto& counter : _counters)
+            countersAfter[index++] = counter.second();
+
+        Result result;
+        result.name = name;
+        result.iterations = iterations;
+        result.seconds = seconds;
+        result.bytes = bytes;
+        index = 0;
+        for (const auto& counter : _counters)
+        {
+            result.metrics[counter.first] = static_cast<double>(countersAfter[index] - countersBefore[index]) / iterations;
+            ++index;
+        }
+
+        print(result);
+        _results.push_back(result);
+        return _results.back();
+    }
+
+    /**
+     * \brief Add a result measured by the caller
+     * \param result Result
+     * \return Return the result, to which metrics can be added
+     */
+    Result& add(const Result& result)
+    {
+        print(result);
+        _results.push_back(result);
+        return _results.back();
+    }
+
+  private:
+    std::string _suite;
+    std::string _outputPath{""};
+    std::map<std::string, std::function<uint64_t()>> _counters{};
+    std::vector<Result> _results{};
+
+    /**
+     * \brief Print a result on the standard output
+     * \param result Result
+     */
+    void print(const Result& result) const
+    {
+        auto timePerOp = result.iterations ? result.seconds / result.iterations : 0.0;
+        std::cout << std::left << std::setw(40) << result.name << std::right << std::setw(10) << result.iterations << std::fixed << std::setprecision(2);
+        if (timePerOp < 1e-3)
+            std::cout << std::setw(12) << timePerOp * 1e9 << " ns";
+        else
+            std::cout << std::setw(12) << timePerOp * 1e3 << " ms";
+        if (result.bytes != 0 && result.seconds > 0.0)
+            std::cout << std::setw(9) << static_cast<double>(result.bytes) * result.iterations / result.seconds / 1e6 << " MB/s";
+        for (const auto& metric : result.metrics)
+            std::cout << "  " << metric.first << ": " << metric.second;
+        std::cout << std::endl;
+    }
+
+    /**
+     * \brief Write all results to the JSON output file, if any
+     */
+    void write() const
+    {
+        if (_outputPath.empty())
+            return;
+
+        Json::Value root;
+        root["suite"] = _suite;
+        root["version"] = PACKAGE_VERSION;
+
+        char hostname[256] = {0};
+        gethostname(hostname, sizeof(hostname) - 1);
+        root["host"] = hostname;
+        root["timestamp"] = static_cast<Json::Int64>(std::time(nullptr));
+
+        Json::Value results(Json::arrayValue);
+        for (const auto& result : _results)
+        {
+            Json::Value value;
+            value["name"] = result.name;
+            value["iterations"] = static_cast<Json::UInt64>(result.iterations);
+            value["ns_per_op"] = result.iterations ? result.seconds * 1e9 / result.iterations : 0.0;
+            if (result.bytes != 0)
+            {
+                value["bytes_per_op"] = static_cast<Json::UInt64>(result.bytes);
+                value["mb_per_s"] = result.seconds > 0.0 ? static_cast<double>(result.bytes) * result.iterations / result.seconds / 1e6 : 0.0;
+            }
+            for (const auto& metric : result.metrics)
+                value[metric.first] = metric.second;
+            results.append(value);
+        }
+        root["results"] = results;
+
+        std::ofstream out(_outputPath, std::ios::out | std::ios::binary);
+        if (!out.is_open())
+        {
+            std::cerr << "Benchmark::" << __FUNCTION__ << " - Unable to open file " << _outputPath << std::endl;
+            return;
+        }
+        out << root.toStyledString();
+    }
+};
+
+} // namespace Splash
+
+#endif // SPLASH_BENCHMARK_H
@@ -28,6 +28,9 @@
 /* Defined to 1 if the Datapath SDK is detected */
 #cmakedefine01 HAVE_DATAPATH
 
+/* Defined to 1 if GLFW has a null platform (3.4 and newer), needed for headless rendering */
+#cmakedefine01 HAVE_HEADLESS
+
 /* Support mmx instructions */
 #cmakedefine01 HAVE_MMX
 
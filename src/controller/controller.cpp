@@ -255,8 +255,7 @@ void ControllerObject::setObjectAttribute(const string& name, const string& attr
         return;
 
     auto message = values;
-    message.push_front(attr);
-    message.push_front(name);
+    message.insert(message.begin(), {name, attr});
     scene->sendMessageToWorld("sendAll", message);
 }
 
@@ -271,8 +270,7 @@ void ControllerObject::setObjectsOfType(const string& type, const string& attr,
         if (obj.second->getType() == type)
         {
             auto msg = values;
-            msg.push_front(attr);
-            msg.push_front(obj.first);
+            msg.insert(msg.begin(), {obj.first, attr});
             scene->sendMessageToWorld("sendAll", msg);
         }
 }
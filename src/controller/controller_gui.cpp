@@ -13,9 +13,12 @@
 #include "./controller/widget/widget_text_box.h"
 #include "./controller/widget/widget_textures_view.h"
 #include "./controller/widget/widget_warp.h"
+#include "./core/buffer_pool.h"
 #include "./core/scene.h"
+#include "./core/thread_pool.h"
 #include "./graphics/camera.h"
 #include "./graphics/object.h"
+#include "./graphics/shader.h"
 #include "./graphics/texture.h"
 #include "./graphics/texture_image.h"
 #include "./graphics/window.h"
@@ -1150,6 +1153,20 @@ void Gui::initImWidgets()
         stream << "  Windows rendering: " << setprecision(4) << win << " ms\n";
         stream << "  Swapping and events: " << setprecision(4) << buf << " ms\n";
 
+        auto poolStats = BufferPool::get().getStats();
+        stream << "Buffer pool:\n";
+        stream << "  Hits / misses: " << poolStats.hits << " / " << poolStats.misses << "\n";
+        stream << "  Resident: " << setprecision(4) << static_cast<float>(poolStats.residentSize) / 1048576.f << " MB in " << poolStats.residentCount << " buffers\n";
+
+        auto threadPoolStats = ThreadPool::get().getStats();
+        stream << "Thread pool:\n";
+        stream << "  Workers: " << threadPoolStats.workers << " - Queued tasks: " << threadPoolStats.queued << "\n";
+        stream << "  Executed / stolen tasks: " << threadPoolStats.executed << " / " << threadPoolStats.stolen << "\n";
+
+        auto uniformStats = Shader::getUniformUploadStats();
+        stream << "Uniform uploads:\n";
+        stream << "  Last frame: " << uniformStats.lastFrame << " - Total: " << uniformStats.total << "\n";
+
         return stream.str();
     });
     _guiWidgets.push_back(dynamic_pointer_cast<GuiWidget>(timingBox));
@@ -96,7 +96,7 @@ PyDoc_STRVAR(pythonGetTimings_doc__,
 
 PyObject* PythonEmbedded::pythonGetTimings(PyObject* /*self*/, PyObject* /*args*/)
 {
-    auto& timings = Timer::get().getDurationMap();
+    auto timings = Timer::get().getDurationMap();
     PyObject* pythonTimerDict = PyDict_New();
     for (auto& t : timings)
     {
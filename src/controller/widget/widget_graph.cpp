@@ -12,7 +12,7 @@ void GuiGraph::render()
 {
     if (ImGui::CollapsingHeader(_name.c_str()))
     {
-        auto& durationMap = Timer::get().getDurationMap();
+        auto durationMap = Timer::get().getDurationMap();
 
         for (auto& t : durationMap)
         {
@@ -29,6 +29,7 @@ void GuiGraph::render()
         if (_durationGraph.size() == 0)
             return;
 
+        auto statsMap = Timer::get().getStatsMap();
         auto width = ImGui::GetWindowSize().x;
         for (auto& duration : _durationGraph)
         {
@@ -42,8 +43,12 @@ void GuiGraph::render()
 
             maxValue = ceil(maxValue * 0.1f) * 10.f;
 
-            ImGui::PlotLines(
-                "", values.data(), values.size(), values.size(), (duration.first + " - " + to_string((int)maxValue) + "ms").c_str(), 0.f, maxValue, ImVec2(width - 30, 80));
+            auto label = duration.first + " - " + to_string((int)maxValue) + "ms";
+            auto statsIt = statsMap.find(duration.first);
+            if (statsIt != statsMap.end())
+                label += " - p50 " + to_string(statsIt->second.p50) + "us / p99 " + to_string(statsIt->second.p99) + "us";
+
+            ImGui::PlotLines("", values.data(), values.size(), values.size(), label.c_str(), 0.f, maxValue, ImVec2(width - 30, 80));
         }
     }
 }
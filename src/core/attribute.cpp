@@ -43,6 +43,10 @@ Attribute& Attribute::operator=(Attribute&& a)
         _defaultSetAndGet = a._defaultSetAndGet;
         _doUpdateDistant = a._doUpdateDistant;
         _savable = a._savable;
+        _coalesce = a._coalesce;
+        _generation = a._generation.load();
+        _boundTarget = a._boundTarget;
+        _boundType = a._boundType;
     }
 
     return *this;
@@ -51,16 +55,9 @@ Attribute& Attribute::operator=(Attribute&& a)
 /*************/
 bool Attribute::operator()(const Values& args)
 {
-    if (_isLocked)
+    if (!prepareSet())
         return false;
 
-    // Run all set callbacks
-    {
-        lock_guard<mutex> lockCb(_callbackMutex);
-        for (auto& cb : _callbacks)
-            cb.second(_objectName, _name);
-    }
-
     if (!_setFunc && _defaultSetAndGet)
     {
         lock_guard<mutex> lock(_defaultFuncMutex);
@@ -70,6 +67,7 @@ bool Attribute::operator()(const Values& args)
         for (const auto& a : args)
             _valuesTypes.push_back(a.getTypeAsChar());
 
+        _generation.fetch_add(1, memory_order_acq_rel);
         return true;
     }
     else if (!_setFunc)
@@ -98,7 +96,11 @@ bool Attribute::operator()(const Values& args)
         }
     }
 
-    return _setFunc(args);
+    if (!_setFunc(args))
+        return false;
+
+    _generation.fetch_add(1, memory_order_acq_rel);
+    return true;
 }
 
 /*************/
@@ -117,6 +119,20 @@ Values Attribute::operator()() const
     return _getFunc();
 }
 
+/*************/
+bool Attribute::prepareSet()
+{
+    if (_isLocked)
+        return false;
+
+    // Run all set callbacks
+    lock_guard<mutex> lockCb(_callbackMutex);
+    for (auto& cb : _callbacks)
+        cb.second(_objectName, _name);
+
+    return true;
+}
+
 /*************/
 Values Attribute::getArgsTypes() const
 {
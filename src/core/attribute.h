@@ -32,6 +32,7 @@
 #include <list>
 #include <map>
 #include <string>
+#include <typeindex>
 #include <unordered_map>
 
 #include "./core/coretypes.h"
@@ -129,12 +130,67 @@ class Attribute
      */
     Values operator()() const;
 
+    /**
+     * \brief Set the attribute from a single typed value. If the attribute is bound to a variable of this type, it is written directly
+     * \param value Value to set
+     * \return Returns true if the set did occur.
+     */
+    template <typename T>
+    bool set(const T& value)
+    {
+        auto target = getBoundTarget<T>();
+        if (!target)
+            return operator()(Values({value}));
+
+        if (!prepareSet())
+            return false;
+        *target = value;
+        _generation.fetch_add(1, std::memory_order_acq_rel);
+        return true;
+    }
+
+    /**
+     * \brief Bind the attribute to the variable its setter writes to, to read and write it without going through Values
+     * This is only valid for attributes whose setter has no other effect than storing a single value to this variable
+     * \param target Variable holding the attribute value, which has to live as long as the attribute
+     */
+    template <typename T>
+    void bind(T* target)
+    {
+        _boundTarget = target;
+        _boundType = std::type_index(typeid(T));
+    }
+
+    /**
+     * \brief Get the variable the attribute is bound to
+     * \return Returns a pointer to the variable, or nullptr if the attribute is not bound to a variable of type T
+     */
+    template <typename T>
+    T* getBoundTarget() const
+    {
+        if (_boundType != std::type_index(typeid(T)))
+            return nullptr;
+        return static_cast<T*>(_boundTarget);
+    }
+
     /**
      * \brief Tells whether the setter and getters are the default ones or not.
      * \return Returns true if the setter and getter are the default ones.
      */
     bool isDefault() const { return _defaultSetAndGet; }
 
+    /**
+     * \brief Ask whether queued asynchronous sets of this attribute can be collapsed to the latest one
+     * \return Returns true if only the latest queued value matters
+     */
+    bool coalesce() const { return _coalesce; }
+
+    /**
+     * \brief Set whether queued asynchronous sets of this attribute can be collapsed to the latest one
+     * \param coalesce If true, older queued values are dropped. Only suitable for attributes holding a plain state
+     */
+    void coalesce(bool coalesce) { _coalesce = coalesce; }
+
     /**
      * \brief Ask whether to update the Scene object (if this attribute is hosted by a World object).
      * \return Returns true if the World should update this attribute in the distant Scene object.
@@ -147,6 +203,12 @@ class Attribute
      */
     void doUpdateDistant(bool update) { _doUpdateDistant = update; }
 
+    /**
+     * \brief Get the generation of the attribute, incremented each time it is successfully set.
+     * \return Returns the current generation.
+     */
+    uint64_t getGeneration() const { return _generation.load(std::memory_order_acquire); }
+
     /**
      * \brief Get the types of the wanted arguments.
      * \return Returns the expected types in a Values.
@@ -237,6 +299,7 @@ class Attribute
     bool _defaultSetAndGet{true};
     bool _doUpdateDistant{false}; // True if the World should send this attr values to Scenes
     bool _savable{true};          // True if this attribute should be saved
+    bool _coalesce{false};        // True if only the latest queued asynchronous set matters
 
     std::string _objectName{};        // Name of the object holding this attribute
     std::string _description{};       // Attribute description
@@ -244,12 +307,112 @@ class Attribute
     std::vector<char> _valuesTypes{}; // List of the types held in _values
     Sync _syncMethod{Sync::no_sync};  //!< Synchronization to consider while setting this attribute
 
+    std::atomic_ullong _generation{0}; //!< Incremented each time the attribute is set
+
     std::mutex _callbackMutex{};
     std::map<uint32_t, Callback> _callbacks{};
 
     bool _isLocked{false};
+
+    void* _boundTarget{nullptr};                               //!< Variable the attribute is bound to, if any
+    std::type_index _boundType{std::type_index(typeid(void))}; //!< Type of the bound variable
+
+    /**
+     * \brief Check that the attribute can be set, and run the set callbacks
+     * \return Returns false if the attribute is locked
+     */
+    bool prepareSet();
+};
+
+/*************/
+/**
+ * Typed handle to an attribute, which can be kept by the caller to read or write
+ * the attribute without looking it up by name. If the attribute is bound to a
+ * variable of type T, no Values is involved at all.
+ * The handle is valid as long as the attribute is not removed from its object.
+ */
+template <typename T>
+class AttributeHandle
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param attribute Attribute to give access to
+     * \param updatedParams Flag of the owner object, set when a non default attribute is modified
+     */
+    AttributeHandle() = default;
+    AttributeHandle(Attribute* attribute, bool* updatedParams)
+        : _attribute(attribute)
+        , _updatedParams(updatedParams)
+    {
+    }
+
+    /**
+     * \brief Check whether the handle points to an attribute
+     */
+    explicit operator bool() const { return _attribute != nullptr; }
+
+    /**
+     * \brief Get the attribute value
+     * \return Returns the value, converted to T if the attribute is not bound to a variable of this type
+     */
+    T get() const
+    {
+        if (auto target = _attribute->getBoundTarget<T>())
+            return *target;
+
+        auto values = (*_attribute)();
+        if (values.empty())
+            return T();
+        return values[0].as<T>();
+    }
+
+    /**
+     * \brief Set the attribute value
+     * \param value Value to set
+     * \return Returns true if the set did occur
+     */
+    bool set(const T& value)
+    {
+        if (_updatedParams && !_attribute->isDefault())
+            *_updatedParams = true;
+        return _attribute->set(value);
+    }
+
+    /**
+     * \brief Ask whether the attribute is locked
+     * \return Returns true if the attribute is locked
+     */
+    bool isLocked() const { return _attribute->isLocked(); }
+
+    /**
+     * \brief Get the attribute the handle points to
+     * \return Returns a reference to the attribute
+     */
+    Attribute& operator*() const { return *_attribute; }
+    Attribute* operator->() const { return _attribute; }
+
+  private:
+    Attribute* _attribute{nullptr};
+    bool* _updatedParams{nullptr};
 };
 
+/*************/
+template <>
+inline Values AttributeHandle<Values>::get() const
+{
+    return (*_attribute)();
+}
+
+/*************/
+template <>
+inline bool AttributeHandle<Values>::set(const Values& values)
+{
+    if (_updatedParams && !_attribute->isDefault())
+        *_updatedParams = true;
+    return (*_attribute)(values);
+}
+
 } // end of namespace
 
 #endif // SPLASH_ATTRIBUTE_H
@@ -10,10 +10,9 @@ namespace Splash
 {
 
 /*************/
-void BaseObject::addTask(const function<void()>& task)
+void BaseObject::addTask(function<void()>&& task, const string& key)
 {
-    lock_guard<recursive_mutex> lock(_taskMutex);
-    _taskQueue.push_back(task);
+    _taskQueue.push(std::move(task), key);
 }
 
 /*************/
@@ -184,6 +183,16 @@ Attribute::Sync BaseObject::getAttributeSyncMethod(const string& name)
         return Attribute::Sync::no_sync;
 }
 
+/*************/
+bool BaseObject::isAttributeCoalesced(const string& name) const
+{
+    auto attr = _attribFunctions.find(name);
+    if (attr != _attribFunctions.end())
+        return attr->second.coalesce();
+    else
+        return false;
+}
+
 /*************/
 void BaseObject::runAsyncTask(const function<void(void)>& func)
 {
@@ -234,22 +243,22 @@ void BaseObject::removeAttribute(const string& name)
 }
 
 /*************/
-void BaseObject::setAttributeParameter(const string& name, bool savable, bool updateDistant)
+void BaseObject::setAttributeParameter(const string& name, bool savable, bool updateDistant, bool coalesce)
 {
     auto attr = _attribFunctions.find(name);
     if (attr != _attribFunctions.end())
     {
         attr->second.savable(savable);
         attr->second.doUpdateDistant(updateDistant);
+        attr->second.coalesce(coalesce);
     }
 }
 
 /*************/
 void BaseObject::runTasks()
 {
-    lock_guard<recursive_mutex> lock(_taskMutex);
-    for (auto& task : _taskQueue)
-        task();
-    _taskQueue.clear();
+    // Tasks added by the tasks themselves are also run
+    while (_taskQueue.run() != 0)
+        continue;
 }
 } // namespace Splash
@@ -35,6 +35,7 @@
 
 #include "./core/attribute.h"
 #include "./core/coretypes.h"
+#include "./core/task_queue.h"
 #include "./utils/log.h"
 #include "./utils/timer.h"
 
@@ -119,6 +120,20 @@ class BaseObject
      */
     Values getAttributesDescriptions();
 
+    /**
+     * \brief Get a typed handle to an attribute, to access it repeatedly without looking it up by name
+     * \param name Attribute name
+     * \return Return the handle, which evaluates to false if the attribute does not exist
+     */
+    template <typename T>
+    AttributeHandle<T> getAttributeHandle(const std::string& name)
+    {
+        auto attribute = _attribFunctions.find(name);
+        if (attribute == _attribFunctions.end())
+            return {};
+        return {&attribute->second, &_updatedParams};
+    }
+
     /**
      * \brief Get the attribute synchronization method
      * \param name Attribute name
@@ -131,6 +146,13 @@ class BaseObject
      */
     virtual void runTasks();
 
+    /**
+     * \brief Check whether queued asynchronous sets of an attribute can be collapsed to the latest one
+     * \param name Attribute name
+     * \return Return true if the attribute has been flagged as coalesced
+     */
+    bool isAttributeCoalesced(const std::string& name) const;
+
   protected:
     std::string _name{""};                                              //!< Object name
     std::unordered_map<std::string, Attribute> _attribFunctions; //!< Map of all attributes
@@ -139,14 +161,14 @@ class BaseObject
     std::future<void> _asyncTask{};
     std::mutex _asyncTaskMutex{};
 
-    std::list<std::function<void()>> _taskQueue;
-    std::recursive_mutex _taskMutex;
+    TaskQueue _taskQueue{};
 
     /**
-     * Add a new task to the queue
+     * Add a new task to the queue, without ever blocking
      * \param task Task function
+     * \param key Coalescing key: among the queued tasks sharing a key, only the latest one is run
      */
-    void addTask(const std::function<void()>& task);
+    void addTask(std::function<void()>&& task, const std::string& key = "");
 
     /**
      * \brief Add a new attribute to this object
@@ -181,6 +203,19 @@ class BaseObject
      */
     void setAttributeDescription(const std::string& name, const std::string& description);
 
+    /**
+     * \brief Bind an attribute to the variable its setter writes to, for typed handles to access it directly
+     * \param name Attribute name
+     * \param target Variable holding the attribute value
+     */
+    template <typename T>
+    void bindAttribute(const std::string& name, T* target)
+    {
+        auto attr = _attribFunctions.find(name);
+        if (attr != _attribFunctions.end())
+            attr->second.bind(target);
+    }
+
     /**
      * \brief Set attribute synchronization method
      * \param Method Synchronization method, can be any of the Attribute::Sync values
@@ -198,8 +233,9 @@ class BaseObject
      * \param name Attribute name
      * \param savable Savability
      * \param updateDistant If true and the object has a World as root, updates the attribute of the corresponding Scene object
+     * \param coalesce If true, queued asynchronous sets of the attribute are collapsed to the latest one
      */
-    void setAttributeParameter(const std::string& name, bool savable, bool updateDistant);
+    void setAttributeParameter(const std::string& name, bool savable, bool updateDistant, bool coalesce = false);
 
     /**
      * \brief Register new attributes
@@ -1,6 +1,8 @@
 #include "./core/buffer_object.h"
 
 #include "./core/root_object.h"
+#include "./core/thread_pool.h"
+#include "./utils/log.h"
 
 using namespace std;
 
@@ -35,10 +37,17 @@ void BufferObject::setSerializedObject(shared_ptr<SerializedObject> obj)
         _serializedObject = move(obj);
         _newSerializedObject = true;
 
-        // Deserialize it right away, in a separate thread
-        _deserializeFuture = async(launch::async, [this]() {
+        // Deserialize it right away, in a worker thread
+        _deserializeFuture = ThreadPool::get().submit([this]() {
             lock_guard<shared_timed_mutex> lock(_writeMutex);
-            deserialize();
+            // Objects sent within the same process may still share their payload with the sender
+            if (!deserializesPayload())
+                _serializedObject->flatten();
+            if (!_serializedObject->decompress())
+                Log::get() << Log::WARNING << "BufferObject::setSerializedObject - Unable to decompress the buffer received for " << _name << Log::endl;
+            else
+                deserialize();
+            _deserializedCount.fetch_add(1, std::memory_order_acq_rel);
             _serializedObjectWaiting.store(false, std::memory_order_acq_rel);
         });
     }
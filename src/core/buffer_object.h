@@ -54,6 +54,15 @@ class BufferObject : public GraphObject
         registerAttributes();
     }
 
+    /**
+     * \brief Destructor, waits for the deserialization task which uses the object
+     */
+    virtual ~BufferObject() override
+    {
+        if (_deserializeFuture.valid())
+            _deserializeFuture.wait();
+    }
+
     /**
      * Lock the buffer, useful while reading. Use with care
      * Note that only write mutex is needed, as it also disables reading
@@ -119,17 +128,37 @@ class BufferObject : public GraphObject
      */
     void setSerializedObject(std::shared_ptr<SerializedObject> obj);
 
+    /**
+     * \brief Get the number of serialized objects received and processed so far
+     * \return Return the number of processed objects
+     */
+    uint64_t getDeserializedCount() const { return _deserializedCount.load(std::memory_order_acquire); }
+
+    /**
+     * \brief Wait for the object to be up to date with the virtual clock, when rendering offline
+     * \param timeout Maximum duration to wait, in us
+     * \return Return true if the object is up to date
+     */
+    virtual bool waitForVirtualClock(uint64_t /*timeout*/) { return true; }
+
   protected:
     mutable Spinlock _readMutex;                      //!< Read mutex locked when the object is read from
     mutable std::shared_timed_mutex _writeMutex;      //!< Write mutex locked when the object is written to
     std::atomic_bool _serializedObjectWaiting{false}; //!< True if a serialized object has been set and waits for processing
-    std::future<void> _deserializeFuture{};           //!< Holds the deserialization thread
+    std::future<void> _deserializeFuture{};           //!< Holds the deserialization task
+    std::atomic<uint64_t> _deserializedCount{0};      //!< Number of serialized objects processed
     int64_t _timestamp{0};                            //!< Timestamp
     bool _updatedBuffer{false};                       //!< True if the BufferObject has been updated
 
     std::shared_ptr<SerializedObject> _serializedObject{nullptr}; //!< Internal buffer object
     bool _newSerializedObject{false};                             //!< Set to true during serialized object processing
 
+    /**
+     * \brief Whether deserialize() reads the payload of serialized objects sent within the same process by itself
+     * \return Return true if the payload does not have to be flattened before deserialization
+     */
+    virtual bool deserializesPayload() const { return false; }
+
     /**
      * \brief Updates the timestamp of the object. Also, set the update flag to true.
      */
@@ -0,0 +1,180 @@
+#include "./core/buffer_pool.h"
+
+using namespace std;
+
+namespace Splash
+{
+
+/*************/
+size_t BufferPool::getCapacity(size_t size)
+{
+    if (size < SPLASH_BUFFER_POOL_MIN_SIZE)
+        return 0;
+
+    // Round up to a quarter of the power of two below size, which wastes at most 25% of the buffer
+    size_t powerOfTwo = 1;
+    while (powerOfTwo <= size / 2)
+        powerOfTwo <<= 1;
+    size_t step = powerOfTwo / 4;
+    return (size + step - 1) / step * step;
+}
+
+/*************/
+char* BufferPool::acquire(size_t capacity)
+{
+    {
+        lock_guard<mutex> lock(_mutex);
+        auto& bucket = _buckets[capacity];
+        touch(bucket);
+        if (!bucket.buffers.empty())
+        {
+            auto buffer = bucket.buffers.back();
+            bucket.buffers.pop_back();
+            _residentSize -= capacity;
+            --_residentCount;
+            ++_hits;
+            return buffer;
+        }
+    }
+
+    ++_misses;
+    return new char[capacity];
+}
+
+/*************/
+void BufferPool::release(char* buffer, size_t capacity)
+{
+    if (!buffer)
+        return;
+
+    {
+        lock_guard<mutex> lock(_mutex);
+        auto& bucket = _buckets[capacity];
+        touch(bucket);
+
+        if (_residentSize + capacity > _maxResidentSize)
+            evict(capacity, capacity);
+
+        if (_residentSize + capacity <= _maxResidentSize)
+        {
+            bucket.buffers.push_back(buffer);
+            _residentSize += capacity;
+            ++_residentCount;
+            return;
+        }
+    }
+
+    delete[] buffer;
+}
+
+/*************/
+void BufferPool::clear()
+{
+    lock_guard<mutex> lock(_mutex);
+    for (auto& bucket : _buckets)
+        for (auto buffer : bucket.second.buffers)
+            delete[] buffer;
+    _buckets.clear();
+    _residentSize = 0;
+    _residentCount = 0;
+}
+
+/*************/
+BufferPool::Stats BufferPool::getStats() const
+{
+    lock_guard<mutex> lock(_mutex);
+    Stats stats;
+    stats.hits = _hits;
+    stats.misses = _misses;
+    stats.residentSize = _residentSize;
+    stats.residentCount = _residentCount;
+    return stats;
+}
+
+/*************/
+size_t BufferPool::getMaxResidentSize() const
+{
+    lock_guard<mutex> lock(_mutex);
+    return _maxResidentSize;
+}
+
+/*************/
+void BufferPool::setMaxResidentSize(size_t size)
+{
+    lock_guard<mutex> lock(_mutex);
+    _maxResidentSize = size;
+    if (_residentSize > _maxResidentSize)
+        evict(0, 0);
+}
+
+/*************/
+chrono::milliseconds BufferPool::getIdleTime() const
+{
+    lock_guard<mutex> lock(_mutex);
+    return _idleTime;
+}
+
+/*************/
+void BufferPool::setIdleTime(chrono::milliseconds idleTime)
+{
+    lock_guard<mutex> lock(_mutex);
+    _idleTime = idleTime;
+}
+
+/*************/
+void BufferPool::trim()
+{
+    lock_guard<mutex> lock(_mutex);
+    trimIdleBuckets(chrono::steady_clock::now());
+}
+
+/*************/
+void BufferPool::evict(size_t size, size_t keptCapacity)
+{
+    // Largest buffers first, they are the most likely to be left over from a previous resolution
+    for (auto bucketIt = _buckets.rbegin(); bucketIt != _buckets.rend() && _residentSize + size > _maxResidentSize; ++bucketIt)
+    {
+        if (bucketIt->first == keptCapacity)
+            continue;
+
+        auto& buffers = bucketIt->second.buffers;
+        while (!buffers.empty() && _residentSize + size > _maxResidentSize)
+        {
+            delete[] buffers.back();
+            buffers.pop_back();
+            _residentSize -= bucketIt->first;
+            --_residentCount;
+        }
+    }
+}
+
+/*************/
+void BufferPool::trimIdleBuckets(chrono::steady_clock::time_point now, const Bucket* keptBucket)
+{
+    _lastTrim = now;
+    for (auto bucketIt = _buckets.begin(); bucketIt != _buckets.end();)
+    {
+        if (&bucketIt->second == keptBucket || now - bucketIt->second.lastUse < _idleTime)
+        {
+            ++bucketIt;
+            continue;
+        }
+
+        for (auto buffer : bucketIt->second.buffers)
+            delete[] buffer;
+        _residentSize -= bucketIt->first * bucketIt->second.buffers.size();
+        _residentCount -= bucketIt->second.buffers.size();
+        bucketIt = _buckets.erase(bucketIt);
+    }
+}
+
+/*************/
+void BufferPool::touch(Bucket& bucket)
+{
+    auto now = chrono::steady_clock::now();
+    bucket.lastUse = now;
+    if (now - _lastTrim >= chrono::milliseconds(SPLASH_BUFFER_POOL_TRIM_PERIOD))
+        trimIdleBuckets(now, &bucket);
+}
+
+} // end of namespace
@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2018 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @buffer_pool.h
+ * Pool of large memory buffers, recycled instead of being freed to avoid allocator churn and page faults
+ */
+
+#ifndef SPLASH_BUFFER_POOL_H
+#define SPLASH_BUFFER_POOL_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#define SPLASH_BUFFER_POOL_MIN_SIZE 65536
+#define SPLASH_BUFFER_POOL_MAX_RESIDENT_SIZE (1ull << 30) // Default limit, set through the bufferPoolSize attribute of the World
+#define SPLASH_BUFFER_POOL_IDLE_TIME 10000               // Default time after which unused buckets are freed, in ms
+#define SPLASH_BUFFER_POOL_TRIM_PERIOD 1000              // Minimum time between two checks for idle buckets, in ms
+
+namespace Splash
+{
+
+/*************/
+/**
+ * Buffers are sorted in buckets by capacity, with four buckets per power of two.
+ * A released buffer is kept for later use as long as the resident size stays
+ * below the limit, evicting buffers from other buckets if needed.
+ * Buckets which have not been used for a while are freed, so that buffers left
+ * over from a previous resolution do not stay resident.
+ */
+class BufferPool
+{
+  public:
+    struct Stats
+    {
+        uint64_t hits{0};          //!< Number of buffers acquired from the pool
+        uint64_t misses{0};        //!< Number of buffers which had to be allocated
+        uint64_t residentSize{0};  //!< Size of the buffers kept in the pool, in bytes
+        uint64_t residentCount{0}; //!< Number of buffers kept in the pool
+    };
+
+    /**
+     * \brief Get the singleton
+     * \return Return the pool singleton
+     */
+    static BufferPool& get()
+    {
+        // The pool is never destroyed, as buffers can be released by static objects at exit
+        static auto instance = new BufferPool;
+        return *instance;
+    }
+
+    /**
+     * \brief Get the capacity of the bucket holding buffers of the given size
+     * \param size Buffer size
+     * \return Return the bucket capacity, or 0 if the size is too small to be pooled
+     */
+    static size_t getCapacity(size_t size);
+
+    /**
+     * \brief Get a buffer with at least the given capacity
+     * \param capacity Buffer capacity, as returned by getCapacity
+     * \return Return a pointer to the buffer
+     */
+    char* acquire(size_t capacity);
+
+    /**
+     * \brief Give back a buffer to the pool
+     * \param buffer Buffer, as returned by acquire
+     * \param capacity Buffer capacity
+     */
+    void release(char* buffer, size_t capacity);
+
+    /**
+     * \brief Free all the buffers kept in the pool
+     */
+    void clear();
+
+    /**
+     * \brief Get the pool counters
+     * \return Return the counters
+     */
+    Stats getStats() const;
+
+    /**
+     * \brief Get the maximum size of the buffers kept in the pool
+     * \return Return the size in bytes
+     */
+    size_t getMaxResidentSize() const;
+
+    /**
+     * \brief Set the maximum size of the buffers kept in the pool
+     * \param size Size in bytes
+     */
+    void setMaxResidentSize(size_t size);
+
+    /**
+     * \brief Get the time after which the buffers of an unused bucket are freed
+     * \return Return the idle time
+     */
+    std::chrono::milliseconds getIdleTime() const;
+
+    /**
+     * \brief Set the time after which the buffers of an unused bucket are freed
+     * \param idleTime Idle time
+     */
+    void setIdleTime(std::chrono::milliseconds idleTime);
+
+    /**
+     * \brief Free the buffers of the buckets which have not been used for longer than the idle time.
+     * This is also done regularly while acquiring and releasing buffers
+     */
+    void trim();
+
+  private:
+    struct Bucket
+    {
+        std::vector<char*> buffers{};
+        std::chrono::steady_clock::time_point lastUse{}; //!< Last time a buffer of this capacity was acquired or released
+    };
+
+    mutable std::mutex _mutex{};
+    std::map<size_t, Bucket> _buckets{}; //!< Free buffers, sorted by capacity
+    size_t _maxResidentSize{SPLASH_BUFFER_POOL_MAX_RESIDENT_SIZE};
+    std::chrono::milliseconds _idleTime{SPLASH_BUFFER_POOL_IDLE_TIME};
+    std::chrono::steady_clock::time_point _lastTrim{};
+    size_t _residentSize{0};
+    size_t _residentCount{0};
+    std::atomic_ullong _hits{0};
+    std::atomic_ullong _misses{0};
+
+    BufferPool() = default;
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    /**
+     * \brief Free buffers from buckets other than the given one, until the given size fits in the pool
+     * \param size Size needed
+     * \param keptCapacity Capacity of the bucket to keep
+     */
+    void evict(size_t size, size_t keptCapacity);
+
+    /**
+     * \brief Free the buffers of the idle buckets, the mutex must be held
+     * \param now Current time
+     * \param keptBucket Bucket to keep whatever its last use, if any
+     */
+    void trimIdleBuckets(std::chrono::steady_clock::time_point now, const Bucket* keptBucket = nullptr);
+
+    /**
+     * \brief Mark the bucket as used, and trim the idle buckets if not done recently. The mutex must be held
+     * \param bucket Bucket being used
+     */
+    void touch(Bucket& bucket);
+};
+
+} // end of namespace
+
+#endif // SPLASH_BUFFER_POOL_H
@@ -2,6 +2,8 @@
 
 #include <algorithm>
 
+#include "./core/root_object.h"
+
 using namespace std;
 
 namespace Splash
@@ -95,7 +97,7 @@ Json::Value GraphObject::getConfigurationAsJson() const
 }
 
 /*************/
-unordered_map<string, Values> GraphObject::getDistantAttributes() const
+unordered_map<string, Values> GraphObject::getDistantAttributes(bool all)
 {
     unordered_map<string, Values> attribs;
     for (auto& attr : _attribFunctions)
@@ -103,10 +105,29 @@ unordered_map<string, Values> GraphObject::getDistantAttributes() const
         if (!attr.second.doUpdateDistant())
             continue;
 
+        // Attributes using the default setter and getter can only change when set
+        auto generation = attr.second.getGeneration();
+        auto stateIt = _distantAttributesState.find(attr.first);
+        if (!all && stateIt != _distantAttributesState.end() && stateIt->second.generation == generation && attr.second.isDefault())
+            continue;
+
         Values values;
         if (getAttribute(attr.first, values, false, true) == false || values.size() == 0)
             continue;
 
+        // Other attributes may have a getter returning a value which changes without being set
+        if (stateIt != _distantAttributesState.end())
+        {
+            stateIt->second.generation = generation;
+            if (!all && stateIt->second.values == values)
+                continue;
+            stateIt->second.values = values;
+        }
+        else
+        {
+            _distantAttributesState[attr.first] = {generation, values};
+        }
+
         attribs[attr.first] = values;
     }
 
@@ -119,9 +140,19 @@ bool GraphObject::setRenderingPriority(Priority priority)
     if (priority < Priority::PRE_CAMERA || priority >= Priority::POST_WINDOW)
         return false;
     _renderingPriority = priority;
+    if (_root)
+        _root->setRenderGraphDirty();
     return true;
 }
 
+/*************/
+void GraphObject::setGhost(bool ghost)
+{
+    _ghost = ghost;
+    if (_root)
+        _root->setRenderGraphDirty();
+}
+
 /*************/
 CallbackHandle GraphObject::registerCallback(const string& attr, Attribute::Callback cb)
 {
@@ -169,6 +200,8 @@ void GraphObject::registerAttributes()
     addAttribute("priorityShift",
         [&](const Values& args) {
             _priorityShift = args[0].as<int>();
+            if (_root)
+                _root->setRenderGraphDirty();
             return true;
         },
         [&]() -> Values { return {_priorityShift}; },
@@ -153,9 +153,11 @@ class GraphObject : public BaseObject, public std::enable_shared_from_this<Graph
     /**
      * \brief Get the map of the attributes which should be updated from World to Scene
      * \brief This is the case when the distant object is different from the World one
+     * \brief Only the attributes which changed since the previous call are returned, unless all are asked for
+     * \param all If true, return all the distant attributes, for the distant objects to converge if a message was lost
      * \return Returns a map of the distant attributes
      */
-    std::unordered_map<std::string, Values> getDistantAttributes() const;
+    std::unordered_map<std::string, Values> getDistantAttributes(bool all = false);
 
     /**
      * \brief Return a vector of the linked objects
@@ -190,13 +192,13 @@ class GraphObject : public BaseObject, public std::enable_shared_from_this<Graph
      * \brief Set the name of the object.
      * \param name name of the object.
      */
-    inline void setName(const std::string& name) { _name = name; }
+    inline virtual void setName(const std::string& name) { _name = name; }
 
     /**
      * Set the object as a ghost, meaning it mimics an object in another scene
      * \param ghost If true, set as ghost
      */
-    inline void setGhost(bool ghost) { _ghost = ghost; }
+    void setGhost(bool ghost);
 
     /**
      * Get whether the object ghosts an object in another scene
@@ -286,6 +288,16 @@ class GraphObject : public BaseObject, public std::enable_shared_from_this<Graph
     RootObject* _root;                                      //!< Root object, Scene or World
     std::vector<std::weak_ptr<GraphObject>> _linkedObjects; //!< Linked objects
 
+    /**
+     * State of a distant attribute when it was last sent
+     */
+    struct DistantAttributeState
+    {
+        uint64_t generation{0};
+        Values values{};
+    };
+    std::unordered_map<std::string, DistantAttributeState> _distantAttributesState{}; //!< Last sent state of the distant attributes
+
     /**
      * Inform that the given object is a parent
      * \param obj Parent object
@@ -35,6 +35,10 @@ string ImageBufferSpec::to_string()
     spec += ";";
     spec += std::to_string(static_cast<int>(videoFrame));
     spec += ";";
+    spec += std::to_string(static_cast<int>(colorMatrix));
+    spec += ";";
+    spec += std::to_string(static_cast<int>(fullRange));
+    spec += ";";
 
     return spec;
 }
@@ -98,6 +102,22 @@ void ImageBufferSpec::from_string(const string& spec)
     roi = roi.substr(curr + 1);
     curr = roi.find(";");
     videoFrame = static_cast<bool>(stoi(roi.substr(0, curr)));
+
+    // Color matrix, for YUV formats
+    if (curr == string::npos)
+        return;
+    roi = roi.substr(curr + 1);
+    curr = roi.find(";");
+    if (curr == string::npos)
+        return;
+    colorMatrix = static_cast<ColorMatrix>(stoi(roi.substr(0, curr)));
+
+    // Color range
+    roi = roi.substr(curr + 1);
+    curr = roi.find(";");
+    if (curr == string::npos)
+        return;
+    fullRange = static_cast<bool>(stoi(roi.substr(0, curr)));
 }
 
 /*************/
@@ -116,8 +136,7 @@ void ImageBuffer::init(const ImageBufferSpec& spec)
 {
     _spec = spec;
 
-    uint32_t size = spec.width * spec.height * spec.pixelBytes();
-    _buffer.resize(size);
+    _buffer.resize(spec.rawSize());
 }
 
 /*************/
@@ -48,6 +48,13 @@ class ImageBufferSpec
         FLOAT = 4
     };
 
+    enum class ColorMatrix : uint32_t
+    {
+        BT601 = 0,
+        BT709 = 1,
+        BT2020 = 2
+    };
+
     /**
      * \brief Constructor
      */
@@ -100,6 +107,8 @@ class ImageBufferSpec
     ImageBufferSpec::Type type{Type::UINT8};
     std::string format{};
     bool videoFrame{true};
+    ColorMatrix colorMatrix{ColorMatrix::BT601}; //!< Matrix to convert YUV formats to RGB
+    bool fullRange{false};                       //!< True if YUV formats use the full range, false for the video range
 
     inline bool operator==(const ImageBufferSpec& spec) const
     {
@@ -115,6 +124,10 @@ class ImageBufferSpec
             return false;
         if (format != spec.format)
             return false;
+        if (colorMatrix != spec.colorMatrix)
+            return false;
+        if (fullRange != spec.fullRange)
+            return false;
 
         return true;
     }
@@ -140,10 +153,36 @@ class ImageBufferSpec
     int pixelBytes() const { return bpp / 8; }
 
     /**
-     * \brief Get image size in bytes
+     * \brief Get whether the spec describes a planar YUV format
+     * \return Return true for YUV420P, YUV420P10, NV12, YUV422P and YUV422P10
+     */
+    bool isPlanarYUV() const { return format == "YUV420P" || format == "YUV420P10" || format == "NV12" || format == "YUV422P" || format == "YUV422P10"; }
+
+    /**
+     * \brief Get the width of the chroma planes of planar YUV formats, rounded up for odd widths
+     * \return Return the chroma width, in samples
+     */
+    uint32_t chromaWidth() const { return (width + 1) / 2; }
+
+    /**
+     * \brief Get the height of the chroma planes of planar YUV formats, rounded up for odd heights
+     * \return Return the chroma height, in rows
+     */
+    uint32_t chromaHeight() const { return format == "YUV422P" || format == "YUV422P10" ? height : (height + 1) / 2; }
+
+    /**
+     * \brief Get image size in bytes. Planar formats hold a luma plane followed by two chroma planes, or an interleaved one for NV12
      * \return Return image size
      */
-    int rawSize() const { return pixelBytes() * width * height; }
+    int rawSize() const
+    {
+        if (isPlanarYUV())
+        {
+            auto sampleBytes = type == Type::UINT16 ? 2ull : 1ull;
+            return static_cast<int>(sampleBytes * (static_cast<uint64_t>(width) * height + 2ull * chromaWidth() * chromaHeight()));
+        }
+        return static_cast<int>(static_cast<uint64_t>(width) * height * bpp / 8);
+    }
 };
 
 /*************/
@@ -161,6 +200,17 @@ class ImageBuffer
      */
     ImageBuffer(const ImageBufferSpec& spec);
 
+    /**
+     * \brief Constructor using the given buffer as inner buffer, its size must match the spec
+     * \param spec Image spec
+     * \param buffer Buffer to use as inner buffer
+     */
+    ImageBuffer(const ImageBufferSpec& spec, ResizableArray<char>&& buffer)
+        : _spec(spec)
+        , _buffer(std::move(buffer))
+    {
+    }
+
     /**
      * \brief Destructor
      */
@@ -14,18 +14,46 @@ namespace Splash
 {
 
 /*************/
-Link::Link(RootObject* root, const string& name)
+Link::Link(RootObject* root, const string& name, int listenPort)
 {
     try
     {
         _rootObject = root;
         _name = name;
+        _listenPort = listenPort;
         _context = make_shared<zmq::context_t>(2);
 
-        _socketMessageOut = make_shared<zmq::socket_t>(*_context, ZMQ_PUB);
-        _socketMessageIn = make_shared<zmq::socket_t>(*_context, ZMQ_SUB);
-        _socketBufferOut = make_shared<zmq::socket_t>(*_context, ZMQ_PUB);
-        _socketBufferIn = make_shared<zmq::socket_t>(*_context, ZMQ_SUB);
+        if (_listenPort == 0)
+        {
+            _socketMessageOut = make_shared<zmq::socket_t>(*_context, ZMQ_PUB);
+            _socketMessageIn = make_shared<zmq::socket_t>(*_context, ZMQ_SUB);
+            _socketBufferOut = make_shared<zmq::socket_t>(*_context, ZMQ_PUB);
+            _socketBufferIn = make_shared<zmq::socket_t>(*_context, ZMQ_SUB);
+        }
+        else
+        {
+            // The remote peer connects to all our sockets, as it is the one knowing where we are.
+            // Push sockets block when the peer is slow or not connected yet, up to a timeout after which the message is dropped.
+            // Messages get a long timeout as the peer may still be connecting, buffers a short one as a newer one will follow
+            _socketMessageOut = make_shared<zmq::socket_t>(*_context, ZMQ_PUSH);
+            _socketMessageIn = make_shared<zmq::socket_t>(*_context, ZMQ_PULL);
+            _socketBufferOut = make_shared<zmq::socket_t>(*_context, ZMQ_PUSH);
+            _socketBufferIn = make_shared<zmq::socket_t>(*_context, ZMQ_PULL);
+
+            int messageTimeout = SPLASH_LINK_TCP_MESSAGE_TIMEOUT;
+            _socketMessageOut->setsockopt(ZMQ_SNDTIMEO, &messageTimeout, sizeof(messageTimeout));
+
+            int hwm = 1;
+            int bufferTimeout = SPLASH_LINK_TCP_TIMEOUT;
+            _socketBufferOut->setsockopt(ZMQ_SNDHWM, &hwm, sizeof(hwm));
+            _socketBufferOut->setsockopt(ZMQ_SNDTIMEO, &bufferTimeout, sizeof(bufferTimeout));
+
+            _socketMessageOut->bind(("tcp://*:" + to_string(_listenPort + 2)).c_str());
+            _socketBufferOut->bind(("tcp://*:" + to_string(_listenPort + 3)).c_str());
+
+            // Buffers can not be shared with another host
+            _useSharedMemory = false;
+        }
     }
     catch (const zmq::error_t& e)
     {
@@ -38,6 +66,11 @@ Link::Link(RootObject* root, const string& name)
     if (!socketPrefix.empty())
         _basePath += socketPrefix + string("_");
 
+    auto shmPrefix = string("/splash_");
+    if (!socketPrefix.empty())
+        shmPrefix += socketPrefix + string("_");
+    _shmRing = make_unique<SharedMemoryRing>(shmPrefix + "shm_" + _name);
+
     _bufferInThread = thread([&]() { handleInputBuffers(); });
     _messageInThread = thread([&]() { handleInputMessages(); });
 }
@@ -45,6 +78,13 @@ Link::Link(RootObject* root, const string& name)
 /*************/
 Link::~Link()
 {
+    {
+        lock_guard<mutex> lockPeers(_remotePeersMutex);
+        for (auto& peerIt : _remotePeers)
+            stopRemotePeer(peerIt.second.get());
+        _remotePeers.clear();
+    }
+
     int lingerValue = 0;
     try
     {
@@ -72,6 +112,13 @@ void Link::connectTo(const string& name)
     else
         return;
 
+    // When listening, the peer connects to us
+    if (_listenPort != 0)
+    {
+        _connectedToOuter = true;
+        return;
+    }
+
     try
     {
         // High water mark set to zero for the outputs
@@ -79,7 +126,7 @@ void Link::connectTo(const string& name)
         _socketMessageOut->setsockopt(ZMQ_SNDHWM, &hwm, sizeof(hwm));
         _socketBufferOut->setsockopt(ZMQ_SNDHWM, &hwm, sizeof(hwm));
 
-        // TODO: for now, all connections are through IPC.
+        // Peers on the same host are reached through IPC, remote ones through connectTo(name, host, port)
         _socketMessageOut->connect((_basePath + "msg_" + name).c_str());
         _socketBufferOut->connect((_basePath + "buf_" + name).c_str());
     }
@@ -111,9 +158,113 @@ void Link::connectTo(const std::string& name, RootObject* peer)
     _connectedToInner = true;
 }
 
+/*************/
+void Link::connectTo(const string& name, const string& host, int port)
+{
+    lock_guard<mutex> lockPeers(_remotePeersMutex);
+    if (_remotePeers.find(name) != _remotePeers.end())
+        return;
+
+    auto peer = make_unique<RemotePeer>();
+    peer->name = name;
+
+    try
+    {
+        auto basePath = "tcp://" + host + ":";
+        int timeout = SPLASH_LINK_TCP_TIMEOUT;
+
+        peer->socketMessageOut = make_shared<zmq::socket_t>(*_context, ZMQ_PUSH);
+        peer->socketMessageOut->setsockopt(ZMQ_SNDTIMEO, &timeout, sizeof(timeout));
+        peer->socketMessageOut->connect((basePath + to_string(port)).c_str());
+
+        // Only one buffer in flight, the others wait in the send queue where they can be replaced by newer ones
+        int hwm = 1;
+        peer->socketBufferOut = make_shared<zmq::socket_t>(*_context, ZMQ_PUSH);
+        peer->socketBufferOut->setsockopt(ZMQ_SNDHWM, &hwm, sizeof(hwm));
+        peer->socketBufferOut->setsockopt(ZMQ_SNDTIMEO, &timeout, sizeof(timeout));
+        peer->socketBufferOut->connect((basePath + to_string(port + 1)).c_str());
+
+        peer->socketMessageIn = make_shared<zmq::socket_t>(*_context, ZMQ_PULL);
+        peer->socketMessageIn->setsockopt(ZMQ_RCVTIMEO, &timeout, sizeof(timeout));
+        peer->socketMessageIn->connect((basePath + to_string(port + 2)).c_str());
+
+        peer->socketBufferIn = make_shared<zmq::socket_t>(*_context, ZMQ_PULL);
+        peer->socketBufferIn->setsockopt(ZMQ_RCVHWM, &hwm, sizeof(hwm));
+        peer->socketBufferIn->setsockopt(ZMQ_RCVTIMEO, &timeout, sizeof(timeout));
+        peer->socketBufferIn->connect((basePath + to_string(port + 3)).c_str());
+    }
+    catch (const zmq::error_t& e)
+    {
+        if (errno != ETERM)
+            Log::get() << Log::WARNING << "Link::" << __FUNCTION__ << " - Exception while connecting to " << name << " at " << host << ":" << port << ": " << e.what()
+                       << Log::endl;
+        return;
+    }
+
+    auto peerPtr = peer.get();
+    peer->sendThread = thread([=]() { handleRemotePeerOutput(peerPtr); });
+    peer->messageInThread = thread([=]() {
+        receiveMessages(peerPtr->socketMessageIn, &peerPtr->stop);
+        peerPtr->socketMessageIn.reset();
+    });
+    peer->bufferInThread = thread([=]() {
+        receiveBuffers(peerPtr->socketBufferIn, &peerPtr->stop);
+        peerPtr->socketBufferIn.reset();
+    });
+
+    _remotePeers[name] = std::move(peer);
+    _connectedToRemote = true;
+}
+
+/*************/
+void Link::stopRemotePeer(RemotePeer* peer)
+{
+    {
+        lock_guard<mutex> lockQueue(peer->queueMutex);
+        peer->stop = true;
+    }
+    peer->queueCondition.notify_all();
+
+    if (peer->sendThread.joinable())
+        peer->sendThread.join();
+    if (peer->messageInThread.joinable())
+        peer->messageInThread.join();
+    if (peer->bufferInThread.joinable())
+        peer->bufferInThread.join();
+
+    try
+    {
+        int lingerValue = SPLASH_LINK_TCP_TIMEOUT;
+        peer->socketMessageOut->setsockopt(ZMQ_LINGER, &lingerValue, sizeof(lingerValue));
+        peer->socketBufferOut->setsockopt(ZMQ_LINGER, &lingerValue, sizeof(lingerValue));
+    }
+    catch (const zmq::error_t& e)
+    {
+        Log::get() << Log::ERROR << "Link::" << __FUNCTION__ << " - Error while closing socket: " << e.what() << Log::endl;
+    }
+
+    peer->socketMessageOut.reset();
+    peer->socketBufferOut.reset();
+
+    if (peer->droppedBuffers != 0)
+        Log::get() << Log::MESSAGE << "Link::" << __FUNCTION__ << " - " << peer->droppedBuffers << " buffers were dropped for peer " << peer->name << " as it was too slow" << Log::endl;
+}
+
 /*************/
 void Link::disconnectFrom(const std::string& name)
 {
+    {
+        lock_guard<mutex> lockPeers(_remotePeersMutex);
+        auto peerIt = _remotePeers.find(name);
+        if (peerIt != _remotePeers.end())
+        {
+            stopRemotePeer(peerIt->second.get());
+            _remotePeers.erase(peerIt);
+            _connectedToRemote = !_remotePeers.empty();
+            return;
+        }
+    }
+
     auto targetPointerIt = _connectedTargetPointers.find(name);
     if (targetPointerIt != _connectedTargetPointers.end())
     {
@@ -126,6 +277,8 @@ void Link::disconnectFrom(const std::string& name)
         try
         {
             _connectedTargets.erase(targetIt);
+            if (_listenPort != 0)
+                return;
             _socketMessageOut->disconnect((_basePath + "msg_" + name).c_str());
             _socketBufferOut->disconnect((_basePath + "buf_" + name).c_str());
         }
@@ -163,7 +316,7 @@ bool Link::waitForBufferSending(chrono::milliseconds maximumWait)
 }
 
 /*************/
-bool Link::sendBuffer(const string& name, shared_ptr<SerializedObject> buffer)
+bool Link::sendBuffer(const string& name, shared_ptr<SerializedObject> buffer, const string& type)
 {
     if (_connectedToInner)
     {
@@ -172,7 +325,7 @@ bool Link::sendBuffer(const string& name, shared_ptr<SerializedObject> buffer)
             auto rootObject = rootObjectIt.second;
             // If there is also a connection to another process,
             // we make a copy of the buffer right now
-            if (rootObject && _connectedToOuter)
+            if (rootObject && (_connectedToOuter || _connectedToRemote))
             {
                 auto copiedBuffer = make_shared<SerializedObject>();
                 *copiedBuffer = *buffer;
@@ -192,18 +345,51 @@ bool Link::sendBuffer(const string& name, shared_ptr<SerializedObject> buffer)
             lock_guard<Spinlock> lock(_bufferSendMutex);
             auto bufferPtr = buffer.get();
 
-            _otgMutex.lock();
-            _otgBuffers.push_back(buffer);
-            _otgMutex.unlock();
-
-            _otgNumber.fetch_add(1, std::memory_order_acq_rel);
+            // If possible, the buffer goes through shared memory and only its descriptor is sent
+            SharedMemoryRing::Descriptor descriptor;
+            auto transport = BufferTransport::Socket;
+            if (_useSharedMemory && _shmRing->write(*bufferPtr, _connectedTargets.size(), descriptor))
+                transport = BufferTransport::SharedMemory;
 
+            // When listening for a TCP peer, the send times out if the peer is too slow and the buffer is dropped.
+            // Once the first part is queued, the following ones are accepted too
             zmq::message_t msg(name.size() + 1);
             memcpy(msg.data(), (void*)name.c_str(), name.size() + 1);
-            _socketBufferOut->send(msg, ZMQ_SNDMORE);
+            if (_socketBufferOut->send(msg, ZMQ_SNDMORE))
+            {
+                msg.rebuild(sizeof(transport));
+                memcpy(msg.data(), (void*)&transport, sizeof(transport));
+                _socketBufferOut->send(msg, ZMQ_SNDMORE);
+
+                if (transport == BufferTransport::SharedMemory)
+                {
+                    msg.rebuild(sizeof(descriptor));
+                    memcpy(msg.data(), (void*)&descriptor, sizeof(descriptor));
+                    _socketBufferOut->send(msg);
+                }
+                else
+                {
+                    _otgMutex.lock();
+                    _otgBuffers.push_back(buffer);
+                    _otgMutex.unlock();
 
-            msg.rebuild(bufferPtr->data(), bufferPtr->size(), Link::freeOlderBuffer, this);
-            _socketBufferOut->send(msg);
+                    _otgNumber.fetch_add(1, std::memory_order_acq_rel);
+
+                    // The payload is sent in its own frame, only the small data ahead of it is copied
+                    if (bufferPtr->hasPayload())
+                    {
+                        msg.rebuild(bufferPtr->size());
+                        memcpy(msg.data(), bufferPtr->data(), bufferPtr->size());
+                        _socketBufferOut->send(msg, ZMQ_SNDMORE);
+                        msg.rebuild(const_cast<char*>(bufferPtr->getPayloadData()), bufferPtr->getPayloadSize(), Link::freeOlderBuffer, this);
+                    }
+                    else
+                    {
+                        msg.rebuild(bufferPtr->data(), bufferPtr->size(), Link::freeOlderBuffer, this);
+                    }
+                    _socketBufferOut->send(msg);
+                }
+            }
         }
         catch (const zmq::error_t& e)
         {
@@ -212,6 +398,46 @@ bool Link::sendBuffer(const string& name, shared_ptr<SerializedObject> buffer)
         }
     }
 
+    if (_connectedToRemote)
+    {
+        // Compression is done by the first peer thread to send the buffer, and shared with the others
+        auto outgoing = make_shared<OutgoingBuffer>();
+        outgoing->name = name;
+        outgoing->buffer = buffer;
+        if (buffer->size() >= SPLASH_LINK_COMPRESSION_THRESHOLD && !type.empty())
+        {
+            lock_guard<mutex> lockTypes(_compressedBufferTypesMutex);
+            outgoing->compress = find(_compressedBufferTypes.begin(), _compressedBufferTypes.end(), type) != _compressedBufferTypes.end();
+        }
+
+        lock_guard<mutex> lockPeers(_remotePeersMutex);
+        for (auto& peerIt : _remotePeers)
+        {
+            auto& peer = peerIt.second;
+            lock_guard<mutex> lockQueue(peer->queueMutex);
+            if (peer->desynced)
+                continue;
+
+            // A newer version of a buffer replaces the one still waiting to be sent
+            auto queuedIt = find_if(peer->bufferQueue.begin(), peer->bufferQueue.end(), [&](const shared_ptr<OutgoingBuffer>& queued) { return queued->name == name; });
+            if (queuedIt != peer->bufferQueue.end())
+            {
+                *queuedIt = outgoing;
+                ++peer->droppedBuffers;
+            }
+            else
+            {
+                peer->bufferQueue.push_back(outgoing);
+                if (peer->bufferQueue.size() > SPLASH_LINK_TCP_MAX_QUEUED_BUFFERS)
+                {
+                    peer->bufferQueue.pop_front();
+                    ++peer->droppedBuffers;
+                }
+            }
+            peer->queueCondition.notify_one();
+        }
+    }
+
     return true;
 }
 
@@ -219,11 +445,25 @@ bool Link::sendBuffer(const string& name, shared_ptr<SerializedObject> buffer)
 bool Link::sendBuffer(const string& name, const shared_ptr<BufferObject>& object)
 {
     auto buffer = object->serialize();
-    return sendBuffer(name, std::move(buffer));
+    return sendBuffer(name, std::move(buffer), object->getType());
 }
 
 /*************/
-bool Link::sendMessage(const string& name, const string& attribute, const Values& message)
+void Link::setCompressedBufferTypes(const vector<string>& types)
+{
+    lock_guard<mutex> lockTypes(_compressedBufferTypesMutex);
+    _compressedBufferTypes = types;
+}
+
+/*************/
+vector<string> Link::getCompressedBufferTypes()
+{
+    lock_guard<mutex> lockTypes(_compressedBufferTypesMutex);
+    return _compressedBufferTypes;
+}
+
+/*************/
+bool Link::sendMessage(const string& name, const string& attribute, const Values& message, bool coalesce)
 {
     if (_connectedToInner)
     {
@@ -235,68 +475,87 @@ bool Link::sendMessage(const string& name, const string& attribute, const Values
         }
     }
 
-    if (_connectedToOuter)
+    auto hasOuterPeers = _connectedToOuter || _connectedToRemote;
+    if (hasOuterPeers && _batchThread.load(memory_order_acquire) == this_thread::get_id())
     {
-        try
+        if (coalesce)
         {
-            lock_guard<Spinlock> lock(_msgSendMutex);
+            // Hashed separately so that no key string has to be built for each message
+            auto key = hash<string>()(name) * 31 + hash<string>()(attribute);
+            auto indices = _batchMessageIndices.equal_range(key);
+            for (auto indexIt = indices.first; indexIt != indices.second; ++indexIt)
+            {
+                auto& queuedMessage = _batchMessages[indexIt->second];
+                if (queuedMessage.target == name && queuedMessage.attribute == attribute)
+                {
+                    queuedMessage.values = message;
+                    return true;
+                }
+            }
+            _batchMessageIndices.emplace(key, _batchMessages.size());
+        }
 
-            // First we send the name of the target
-            zmq::message_t msg(name.size() + 1);
-            memcpy(msg.data(), (void*)name.c_str(), name.size() + 1);
-            _socketMessageOut->send(msg, ZMQ_SNDMORE);
-
-            // And the target's attribute
-            msg.rebuild(attribute.size() + 1);
-            memcpy(msg.data(), (void*)attribute.c_str(), attribute.size() + 1);
-            _socketMessageOut->send(msg, ZMQ_SNDMORE);
-
-            // Helper function to send messages
-            std::function<void(const Values& message)> sendMessage;
-            sendMessage = [&](const Values& message) {
-                // Size of the message
-                int size = message.size();
-                msg.rebuild(sizeof(size));
-                memcpy(msg.data(), (void*)&size, sizeof(size));
-
-                if (message.size() == 0)
-                    _socketMessageOut->send(msg);
-                else
-                    _socketMessageOut->send(msg, ZMQ_SNDMORE);
+        _batchMessages.push_back({name, attribute, message});
+    }
+    else if (hasOuterPeers)
+    {
+        lock_guard<Spinlock> lock(_msgSendMutex);
 
-                for (uint32_t i = 0; i < message.size(); ++i)
-                {
-                    auto v = message[i];
-                    Value::Type valueType = v.getType();
+        // The whole message is packed in a single frame
+        MessageCodec::startFrame(_messageFrame);
+        MessageCodec::encode(_messageFrame, name, attribute, message);
+        sendMessageFrame();
+    }
 
-                    msg.rebuild(sizeof(valueType));
-                    memcpy(msg.data(), (void*)&valueType, sizeof(valueType));
-                    _socketMessageOut->send(msg, ZMQ_SNDMORE);
+// We don't display broadcast messages, for visibility
+#ifdef DEBUG
+    if (name != SPLASH_ALL_PEERS)
+        Log::get() << Log::DEBUGGING << "Link::" << __FUNCTION__ << " - Sending message to " << name << "::" << attribute << Log::endl;
+#endif
 
-                    std::string valueName = v.getName();
-                    msg.rebuild(sizeof(valueName) + 1);
-                    memcpy(msg.data(), valueName.c_str(), sizeof(valueName) + 1);
-                    _socketMessageOut->send(msg, ZMQ_SNDMORE);
+    return true;
+}
 
-                    if (valueType == Value::Type::values)
-                        sendMessage(v.as<Values>());
-                    else
-                    {
-                        int valueSize = (valueType == Value::Type::string) ? v.size() + 1 : v.size();
-                        void* value = v.data();
-                        msg.rebuild(valueSize);
-                        memcpy(msg.data(), value, valueSize);
-
-                        if (i != message.size() - 1)
-                            _socketMessageOut->send(msg, ZMQ_SNDMORE);
-                        else
-                            _socketMessageOut->send(msg);
-                    }
-                }
-            };
+/*************/
+void Link::startBatch()
+{
+    _batchThread.store(this_thread::get_id(), memory_order_release);
+}
+
+/*************/
+void Link::flushBatch()
+{
+    if (_batchThread.load(memory_order_acquire) != this_thread::get_id())
+        return;
+    _batchThread.store(thread::id(), memory_order_release);
+
+    if (_batchMessages.empty())
+        return;
+
+    {
+        lock_guard<Spinlock> lock(_msgSendMutex);
+
+        MessageCodec::startFrame(_messageFrame);
+        for (const auto& message : _batchMessages)
+            MessageCodec::encode(_messageFrame, message.target, message.attribute, message.values);
+        sendMessageFrame();
+    }
+
+    _batchMessages.clear();
+    _batchMessageIndices.clear();
+}
 
-            // Send the message
-            sendMessage(message);
+/*************/
+void Link::sendMessageFrame()
+{
+    if (_connectedToOuter)
+    {
+        try
+        {
+            zmq::message_t msg(_messageFrame.size());
+            memcpy(msg.data(), _messageFrame.data(), _messageFrame.size());
+            if (!_socketMessageOut->send(msg))
+                Log::get() << Log::WARNING << "Link::" << __FUNCTION__ << " - Timeout while sending a message to the peer, it has been dropped" << Log::endl;
         }
         catch (const zmq::error_t& e)
         {
@@ -305,13 +564,126 @@ bool Link::sendMessage(const string& name, const string& attribute, const Values
         }
     }
 
-// We don't display broadcast messages, for visibility
-#ifdef DEBUG
-    if (name != SPLASH_ALL_PEERS)
-        Log::get() << Log::DEBUGGING << "Link::" << __FUNCTION__ << " - Sending message to " << name << "::" << attribute << Log::endl;
-#endif
+    if (_connectedToRemote)
+    {
+        vector<string> desyncedPeers;
+        {
+            lock_guard<mutex> lockPeers(_remotePeersMutex);
+            for (auto& peerIt : _remotePeers)
+            {
+                auto& peer = peerIt.second;
+                lock_guard<mutex> lockQueue(peer->queueMutex);
+                if (peer->desynced)
+                    continue;
+
+                // Messages also create objects, link them and answer requests, so none of them can be dropped.
+                // A peer stalled for that long would miss some of them, it is given up on instead
+                peer->messageQueue.push_back(_messageFrame);
+                if (peer->messageQueue.size() > SPLASH_LINK_TCP_MAX_QUEUED_MESSAGES)
+                {
+                    Log::get() << Log::ERROR << "Link::" << __FUNCTION__ << " - Peer " << peer->name << " stalled and is now out of sync, it will be disconnected" << Log::endl;
+                    peer->desynced = true;
+                    peer->messageQueue.clear();
+                    peer->bufferQueue.clear();
+                    desyncedPeers.push_back(peer->name);
+                }
+                peer->queueCondition.notify_one();
+            }
+        }
 
-    return true;
+        // The root object decides what to do with the peer, it is not disconnected from here as this can be called from any thread
+        for (const auto& peerName : desyncedPeers)
+            _rootObject->set(_rootObject->getName(), "peerDesynced", {peerName});
+    }
+}
+
+/*************/
+void Link::handleRemotePeerOutput(RemotePeer* peer)
+{
+    // Send with a timeout, to be able to stop even if the peer does not receive anymore
+    auto send = [&](const shared_ptr<zmq::socket_t>& socket, zmq::message_t& msg, int flags) {
+        while (!socket->send(msg, flags))
+            if (peer->stop)
+                return false;
+        return true;
+    };
+
+    try
+    {
+        deque<vector<uint8_t>> messages;
+        while (true)
+        {
+            shared_ptr<OutgoingBuffer> outgoing;
+            {
+                unique_lock<mutex> lockQueue(peer->queueMutex);
+                peer->queueCondition.wait(lockQueue, [&]() { return peer->stop || !peer->messageQueue.empty() || !peer->bufferQueue.empty(); });
+                // Remaining messages are still sent when stopping, as they may include the last instructions for the peer
+                if (peer->stop && peer->messageQueue.empty())
+                    break;
+
+                // Messages are sent first, as they may be needed to handle the buffers
+                swap(messages, peer->messageQueue);
+                if (messages.empty())
+                {
+                    outgoing = std::move(peer->bufferQueue.front());
+                    peer->bufferQueue.pop_front();
+                }
+            }
+
+            for (auto& frame : messages)
+            {
+                zmq::message_t msg(frame.size());
+                memcpy(msg.data(), frame.data(), frame.size());
+                if (!send(peer->socketMessageOut, msg, 0))
+                    return;
+            }
+            messages.clear();
+
+            if (!outgoing)
+                continue;
+
+            if (outgoing->compress)
+                call_once(outgoing->compressOnce, [&]() { outgoing->compressed = outgoing->buffer->compress(); });
+            auto buffer = outgoing->compressed ? outgoing->compressed : outgoing->buffer;
+
+            zmq::message_t msg(outgoing->name.size() + 1);
+            memcpy(msg.data(), (void*)outgoing->name.c_str(), outgoing->name.size() + 1);
+            if (!send(peer->socketBufferOut, msg, ZMQ_SNDMORE))
+                return;
+
+            auto transport = buffer->isCompressed() ? BufferTransport::CompressedSocket : BufferTransport::Socket;
+            msg.rebuild(sizeof(transport));
+            memcpy(msg.data(), (void*)&transport, sizeof(transport));
+            if (!send(peer->socketBufferOut, msg, ZMQ_SNDMORE))
+                return;
+
+            if (buffer->hasPayload())
+            {
+                msg.rebuild(buffer->size());
+                memcpy(msg.data(), buffer->data(), buffer->size());
+                if (!send(peer->socketBufferOut, msg, ZMQ_SNDMORE))
+                    return;
+                msg.rebuild(const_cast<char*>(buffer->getPayloadData()), buffer->getPayloadSize(), Link::freeRemoteBuffer, new shared_ptr<SerializedObject>(buffer));
+            }
+            else
+            {
+                msg.rebuild(buffer->data(), buffer->size(), Link::freeRemoteBuffer, new shared_ptr<SerializedObject>(buffer));
+            }
+            if (!send(peer->socketBufferOut, msg, 0))
+                return;
+        }
+    }
+    catch (const zmq::error_t& e)
+    {
+        if (errno != ETERM)
+            Log::get() << Log::WARNING << "Link::" << __FUNCTION__ << " - Exception while sending to " << peer->name << ": " << e.what() << Log::endl;
+    }
+}
+
+/*************/
+void Link::freeRemoteBuffer(void* /*data*/, void* hint)
+{
+    delete static_cast<shared_ptr<SerializedObject>*>(hint);
 }
 
 /*************/
@@ -321,8 +693,11 @@ void Link::freeOlderBuffer(void* data, void* hint)
     lock_guard<Spinlock> lock(ctx->_otgMutex);
     uint32_t index = 0;
     for (; index < ctx->_otgBuffers.size(); ++index)
-        if (ctx->_otgBuffers[index]->data() == data)
+    {
+        auto& buffer = ctx->_otgBuffers[index];
+        if ((buffer->hasPayload() ? buffer->getPayloadData() : buffer->data()) == data)
             break;
+    }
 
     if (index >= ctx->_otgBuffers.size())
     {
@@ -342,63 +717,57 @@ void Link::handleInputMessages()
         int hwm = 1000;
         _socketMessageIn->setsockopt(ZMQ_RCVHWM, &hwm, sizeof(hwm));
 
-        _socketMessageIn->bind((_basePath + "msg_" + _name).c_str());
-        _socketMessageIn->setsockopt(ZMQ_SUBSCRIBE, NULL, 0); // We subscribe to all incoming messages
+        if (_listenPort == 0)
+        {
+            _socketMessageIn->bind((_basePath + "msg_" + _name).c_str());
+            _socketMessageIn->setsockopt(ZMQ_SUBSCRIBE, NULL, 0); // We subscribe to all incoming messages
+        }
+        else
+        {
+            _socketMessageIn->bind(("tcp://*:" + to_string(_listenPort)).c_str());
+        }
+    }
+    catch (const zmq::error_t& e)
+    {
+        if (errno != ETERM)
+            Log::get() << Log::WARNING << "Link::" << __FUNCTION__ << " - Exception: " << e.what() << Log::endl;
+    }
+
+    receiveMessages(_socketMessageIn);
+    _socketMessageIn.reset();
+}
 
-        // Helper function to receive messages
+/*************/
+void Link::receiveMessages(const shared_ptr<zmq::socket_t>& socket, const atomic_bool* stop)
+{
+    try
+    {
         zmq::message_t msg;
-        std::function<Values(void)> recvMessage;
-        recvMessage = [&]() -> Values {
-            _socketMessageIn->recv(&msg); // size of the message
-            int size = *(int*)msg.data();
+        vector<MessageCodec::Message> messages;
+        while (!stop || !*stop)
+        {
+            // Receiving from a remote peer times out regularly, to check whether to stop
+            if (!socket->recv(&msg))
+                continue;
 
-            Values values;
-            for (int i = 0; i < size; ++i)
+            messages.clear();
+            if (!MessageCodec::decode(static_cast<uint8_t*>(msg.data()), msg.size(), messages))
             {
-                _socketMessageIn->recv(&msg);
-                Value::Type valueType = *(Value::Type*)msg.data();
-
-                _socketMessageIn->recv(&msg);
-                string valueName(static_cast<char*>(msg.data()));
-
-                if (valueType == Value::Type::values)
-                {
-                    values.push_back(recvMessage());
-                }
-                else
-                {
-                    _socketMessageIn->recv(&msg);
-                    if (valueType == Value::Type::integer)
-                        values.push_back(*(int64_t*)msg.data());
-                    else if (valueType == Value::Type::real)
-                        values.push_back(*(double*)msg.data());
-                    else if (valueType == Value::Type::string)
-                        values.push_back(string((char*)msg.data()));
-                }
-
-                if (!valueName.empty())
-                    values.back().setName(valueName);
+                Log::get() << Log::WARNING << "Link::" << __FUNCTION__ << " - Received a malformed message, or one with an unsupported format version" << Log::endl;
+                continue;
             }
-            return values;
-        };
 
-        while (true)
-        {
-            _socketMessageIn->recv(&msg); // name of the target
-            string name((char*)msg.data());
-            _socketMessageIn->recv(&msg); // target's attribute
-            string attribute((char*)msg.data());
-
-            Values values = recvMessage();
-
-            if (_rootObject)
-                _rootObject->set(name, attribute, values);
+            for (auto& message : messages)
+            {
+                if (_rootObject)
+                    _rootObject->set(message.target, message.attribute, message.values);
 // We don't display broadcast messages, for visibility
 #ifdef DEBUG
-            if (name != SPLASH_ALL_PEERS)
-                Log::get() << Log::DEBUGGING << "Link::" << __FUNCTION__ << " (" << root->getName() << ")"
-                           << " - Receiving message for " << name << "::" << attribute << Log::endl;
+                if (message.target != SPLASH_ALL_PEERS)
+                    Log::get() << Log::DEBUGGING << "Link::" << __FUNCTION__ << " (" << _rootObject->getName() << ")"
+                               << " - Receiving message for " << message.target << "::" << message.attribute << Log::endl;
 #endif
+            }
         }
     }
     catch (const zmq::error_t& e)
@@ -406,8 +775,6 @@ void Link::handleInputMessages()
         if (errno != ETERM)
             Log::get() << Log::WARNING << "Link::" << __FUNCTION__ << " - Exception: " << e.what() << Log::endl;
     }
-
-    _socketMessageIn.reset();
 }
 
 /*************/
@@ -419,18 +786,108 @@ void Link::handleInputBuffers()
         int hwm = 1;
         _socketBufferIn->setsockopt(ZMQ_RCVHWM, &hwm, sizeof(hwm));
 
-        _socketBufferIn->bind((_basePath + "buf_" + _name).c_str());
-        _socketBufferIn->setsockopt(ZMQ_SUBSCRIBE, NULL, 0); // We subscribe to all incoming messages
+        if (_listenPort == 0)
+        {
+            _socketBufferIn->bind((_basePath + "buf_" + _name).c_str());
+            _socketBufferIn->setsockopt(ZMQ_SUBSCRIBE, NULL, 0); // We subscribe to all incoming messages
+        }
+        else
+        {
+            _socketBufferIn->bind(("tcp://*:" + to_string(_listenPort + 1)).c_str());
+        }
+    }
+    catch (const zmq::error_t& e)
+    {
+        if (errno != ETERM)
+            Log::get() << Log::WARNING << "Link::" << __FUNCTION__ << " - Exception: " << e.what() << Log::endl;
+    }
+
+    receiveBuffers(_socketBufferIn);
+    _socketBufferIn.reset();
+}
 
-        while (true)
+/*************/
+void Link::receiveBuffers(const shared_ptr<zmq::socket_t>& socket, const atomic_bool* stop)
+{
+    try
+    {
+        while (!stop || !*stop)
         {
             zmq::message_t msg;
 
-            _socketBufferIn->recv(&msg);
-            string name((char*)msg.data());
+            // Receiving from a remote peer times out regularly, to check whether to stop
+            if (!socket->recv(&msg))
+                continue;
+
+            // Buffers may come from another host: a malformed message is dropped, along with its remaining parts
+            auto dropMessage = [&](zmq::message_t& part) {
+                Log::get() << Log::WARNING << "Link::" << __FUNCTION__ << " - Received a malformed buffer, it has been dropped" << Log::endl;
+                while (part.more() && socket->recv(&part))
+                    continue;
+            };
 
-            _socketBufferIn->recv(&msg);
-            shared_ptr<SerializedObject> buffer = make_shared<SerializedObject>((char*)msg.data(), (char*)msg.data() + msg.size());
+            // Name, as a null terminated string
+            if (!msg.more() || msg.size() == 0 || static_cast<const char*>(msg.data())[msg.size() - 1] != '\0')
+            {
+                dropMessage(msg);
+                continue;
+            }
+            string name(static_cast<const char*>(msg.data()), msg.size() - 1);
+
+            // Transport
+            if (!socket->recv(&msg) || !msg.more() || msg.size() != sizeof(BufferTransport))
+            {
+                dropMessage(msg);
+                continue;
+            }
+            BufferTransport transport;
+            memcpy((void*)&transport, msg.data(), sizeof(transport));
+            if (transport != BufferTransport::Socket && transport != BufferTransport::CompressedSocket && transport != BufferTransport::SharedMemory)
+            {
+                dropMessage(msg);
+                continue;
+            }
+
+            // Data, possibly followed by the payload
+            if (!socket->recv(&msg))
+                continue;
+
+            shared_ptr<SerializedObject> buffer;
+            if (transport == BufferTransport::SharedMemory)
+            {
+                if (msg.more() || msg.size() != sizeof(SharedMemoryRing::Descriptor))
+                {
+                    dropMessage(msg);
+                    continue;
+                }
+                SharedMemoryRing::Descriptor descriptor;
+                memcpy((void*)&descriptor, msg.data(), sizeof(descriptor));
+                // If the slot has already been reused, a newer buffer is on its way
+                buffer = _shmRing->read(descriptor);
+                if (!buffer)
+                    continue;
+            }
+            else if (msg.more())
+            {
+                // The data is followed by a payload, both are gathered in a single buffer
+                zmq::message_t payloadMsg;
+                if (!socket->recv(&payloadMsg))
+                    continue;
+                if (payloadMsg.more())
+                {
+                    dropMessage(payloadMsg);
+                    continue;
+                }
+                buffer = make_shared<SerializedObject>(msg.size() + payloadMsg.size());
+                memcpy(buffer->data(), msg.data(), msg.size());
+                memcpy(buffer->data() + msg.size(), payloadMsg.data(), payloadMsg.size());
+            }
+            else
+            {
+                // Compressed buffers are decompressed by the object, in its deserialization thread
+                buffer = make_shared<SerializedObject>((char*)msg.data(), (char*)msg.data() + msg.size());
+                buffer->setCompressed(transport == BufferTransport::CompressedSocket);
+            }
 
             if (_rootObject)
                 _rootObject->setFromSerializedObject(name, std::move(buffer));
@@ -441,8 +898,6 @@ void Link::handleInputBuffers()
         if (errno != ETERM)
             Log::get() << Log::WARNING << "Link::" << __FUNCTION__ << " - Exception: " << e.what() << Log::endl;
     }
-
-    _socketBufferIn.reset();
 }
 
 } // end of namespace
@@ -27,16 +27,27 @@
 
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <deque>
 #include <map>
 #include <mutex>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 #include <zmq.hpp>
 
 #include "./config.h"
 #include "./core/coretypes.h"
+#include "./core/message_codec.h"
+#include "./core/shared_memory_ring.h"
+
+#define SPLASH_LINK_TCP_DEFAULT_PORT 9100
+#define SPLASH_LINK_TCP_MAX_QUEUED_BUFFERS 2
+#define SPLASH_LINK_TCP_MAX_QUEUED_MESSAGES 4096
+#define SPLASH_LINK_TCP_TIMEOUT 100
+#define SPLASH_LINK_TCP_MESSAGE_TIMEOUT 5000
+#define SPLASH_LINK_COMPRESSION_THRESHOLD 65536
 
 namespace Splash
 {
@@ -52,8 +63,9 @@ class Link
      * \brief Constructor
      * \param root Root object
      * \param name Name of the link
+     * \param listenPort If not zero, wait for a peer on another host to connect through TCP, on this port and the three following ones
      */
-    Link(RootObject* root, const std::string& name);
+    Link(RootObject* root, const std::string& name, int listenPort = 0);
 
     /**
      * \brief Destructor
@@ -61,7 +73,7 @@ class Link
     ~Link();
 
     /**
-     * \brief Connect to a pair given its name
+     * \brief Connect to a peer on the same host through IPC, given its name
      * \param name Peer name
      */
     void connectTo(const std::string& name);
@@ -73,6 +85,15 @@ class Link
      */
     void connectTo(const std::string& name, RootObject* peer);
 
+    /**
+     * \brief Connect to a peer on another host, through TCP. The peer must have been created with the same listen port
+     * Each remote peer has its own send queue, so that a slow peer does not slow down the others
+     * \param name Peer name
+     * \param host Peer host name or IP address
+     * \param port Listen port of the peer
+     */
+    void connectTo(const std::string& name, const std::string& host, int port);
+
     /**
      * \brief Disconnect from a pair given its name
      * \param name Peer name
@@ -83,8 +104,9 @@ class Link
      * \brief Send a buffer to the connected peers
      * \param name Buffer name
      * \param buffer Serialized buffer
+     * \param type Type of the object the buffer comes from, used to decide whether to compress it for remote peers
      */
-    bool sendBuffer(const std::string& name, std::shared_ptr<SerializedObject> buffer);
+    bool sendBuffer(const std::string& name, std::shared_ptr<SerializedObject> buffer, const std::string& type = "");
 
     /**
      * \brief Send a buffer to the connected peers
@@ -98,9 +120,21 @@ class Link
      * \param name Destination object name
      * \param attribute Attribute
      * \param message Message
+     * \param coalesce If true and a batch is running, replaces any message previously queued for the same name and attribute
      * \return Return true if all went well
      */
-    bool sendMessage(const std::string& name, const std::string& attribute, const Values& message);
+    bool sendMessage(const std::string& name, const std::string& attribute, const Values& message, bool coalesce = false);
+
+    /**
+     * \brief Start queueing the messages sent to outer peers by the calling thread, until flushBatch is called
+     * Messages sent by other threads are not affected
+     */
+    void startBatch();
+
+    /**
+     * \brief Send all queued messages as a single frame, and stop batching
+     */
+    void flushBatch();
 
     /**
      * \brief Send a message to connected peers. Converts known base types to vector<Value> before sending.
@@ -119,7 +153,71 @@ class Link
      */
     bool waitForBufferSending(std::chrono::milliseconds maximumWait);
 
+    /**
+     * \brief Set the types of objects whose buffers are compressed before being sent to remote peers
+     * \param types Object types
+     */
+    void setCompressedBufferTypes(const std::vector<std::string>& types);
+
+    /**
+     * \brief Get the types of objects whose buffers are compressed before being sent to remote peers
+     * \return Return the object types
+     */
+    std::vector<std::string> getCompressedBufferTypes();
+
+    /**
+     * \brief Set whether to send buffers through shared memory to other processes. Otherwise, they are sent through the socket
+     * \param use If true, use shared memory
+     */
+    void useSharedMemory(bool use) { _useSharedMemory = use; }
+
   private:
+    /**
+     * Type of the payload sent through the buffer socket
+     */
+    enum class BufferTransport : uint8_t
+    {
+        Socket = 0,
+        SharedMemory,
+        CompressedSocket
+    };
+
+    /**
+     * Buffer waiting to be sent to remote peers, shared between their queues
+     */
+    struct OutgoingBuffer
+    {
+        std::string name{""};
+        std::shared_ptr<SerializedObject> buffer{};
+        bool compress{false};
+        std::once_flag compressOnce{};
+        std::shared_ptr<SerializedObject> compressed{}; //!< Compressed buffer, if compression was worth it
+    };
+
+    /**
+     * Peer on another host, with its own sockets and send queue
+     */
+    struct RemotePeer
+    {
+        std::string name{""};
+        std::shared_ptr<zmq::socket_t> socketMessageOut{};
+        std::shared_ptr<zmq::socket_t> socketBufferOut{};
+        std::shared_ptr<zmq::socket_t> socketMessageIn{};
+        std::shared_ptr<zmq::socket_t> socketBufferIn{};
+
+        std::mutex queueMutex{};
+        std::condition_variable queueCondition{};
+        std::deque<std::vector<uint8_t>> messageQueue{};           //!< Encoded message frames, never dropped
+        std::deque<std::shared_ptr<OutgoingBuffer>> bufferQueue{}; //!< Buffers, the older ones being dropped if the peer is too slow
+        bool desynced{false};                                      //!< True once the peer stalled past the message queue limit, nothing is queued for it anymore
+        uint64_t droppedBuffers{0};                                //!< Number of buffers dropped for this peer
+
+        std::atomic_bool stop{false};
+        std::thread sendThread{};
+        std::thread messageInThread{};
+        std::thread bufferInThread{};
+    };
+
     RootObject* _rootObject;
     std::string _basePath{""};
     std::string _name{""};
@@ -133,10 +231,26 @@ class Link
     bool _connectedToInner{false};
     bool _connectedToOuter{false};
 
+    int _listenPort{0};                                                //!< If not zero, the sockets are bound to TCP ports for a remote peer to connect to
+    std::map<std::string, std::unique_ptr<RemotePeer>> _remotePeers{}; //!< Peers connected through TCP
+    std::mutex _remotePeersMutex{};
+    std::atomic_bool _connectedToRemote{false};
+
+    std::vector<std::string> _compressedBufferTypes{}; //!< Types of objects whose buffers are compressed for remote peers
+    std::mutex _compressedBufferTypesMutex{};
+
     std::shared_ptr<zmq::socket_t> _socketBufferIn;
     std::shared_ptr<zmq::socket_t> _socketBufferOut;
     std::shared_ptr<zmq::socket_t> _socketMessageIn;
     std::shared_ptr<zmq::socket_t> _socketMessageOut;
+    std::vector<uint8_t> _messageFrame{}; //!< Buffer used to encode outgoing messages, protected by _msgSendMutex
+
+    std::atomic<std::thread::id> _batchThread{std::thread::id()};   //!< Thread currently batching its messages, if any
+    std::vector<MessageCodec::Message> _batchMessages{};            //!< Messages queued by the batching thread
+    std::unordered_multimap<size_t, size_t> _batchMessageIndices{}; //!< Index of coalescable messages in _batchMessages, by hash of their name and attribute
+
+    std::unique_ptr<SharedMemoryRing> _shmRing; //!< Shared memory slots, used to send buffers to other processes without copying them through the sockets
+    bool _useSharedMemory{true};                //!< If true, buffers are sent through shared memory when possible
 
     std::deque<std::shared_ptr<SerializedObject>> _otgBuffers;
     Spinlock _otgMutex;
@@ -152,6 +266,44 @@ class Link
      */
     static void freeOlderBuffer(void* data, void* hint);
 
+    /**
+     * \brief Callback to release a buffer sent to a remote peer
+     * \param data Pointer to sent data
+     * \param hint Pointer to the shared_ptr holding the buffer
+     */
+    static void freeRemoteBuffer(void* data, void* hint);
+
+    /**
+     * \brief Send the frame held in _messageFrame to all outer and remote peers. _msgSendMutex must be locked
+     */
+    void sendMessageFrame();
+
+    /**
+     * \brief Remote peer output thread function
+     * \param peer Remote peer
+     */
+    void handleRemotePeerOutput(RemotePeer* peer);
+
+    /**
+     * \brief Stop the threads of a remote peer, and close its sockets
+     * \param peer Remote peer
+     */
+    void stopRemotePeer(RemotePeer* peer);
+
+    /**
+     * \brief Receive and handle messages from the given socket, until the context is terminated or stop is set
+     * \param socket Input socket
+     * \param stop If not null, flag to stop receiving
+     */
+    void receiveMessages(const std::shared_ptr<zmq::socket_t>& socket, const std::atomic_bool* stop = nullptr);
+
+    /**
+     * \brief Receive and handle buffers from the given socket, until the context is terminated or stop is set
+     * \param socket Input socket
+     * \param stop If not null, flag to stop receiving
+     */
+    void receiveBuffers(const std::shared_ptr<zmq::socket_t>& socket, const std::atomic_bool* stop = nullptr);
+
     /**
      * \brief Message input thread function
      */
@@ -0,0 +1,213 @@
+#include "./core/message_codec.h"
+
+#include <cstring>
+
+#define SPLASH_MESSAGE_CODEC_MAX_DEPTH 64
+
+using namespace std;
+
+namespace Splash
+{
+
+/*************/
+void MessageCodec::startFrame(vector<uint8_t>& buffer)
+{
+    buffer.clear();
+    buffer.push_back(SPLASH_MESSAGE_CODEC_VERSION);
+}
+
+/*************/
+void MessageCodec::encode(vector<uint8_t>& buffer, const string& target, const string& attribute, const Values& values)
+{
+    writeString(buffer, target);
+    writeString(buffer, attribute);
+    writeValues(buffer, values);
+}
+
+/*************/
+bool MessageCodec::decode(const uint8_t* data, size_t size, vector<Message>& messages)
+{
+    if (size == 0 || data[0] != SPLASH_MESSAGE_CODEC_VERSION)
+        return false;
+
+    auto end = data + size;
+    ++data;
+    while (data < end)
+    {
+        Message message;
+        if (!readString(data, end, message.target) || !readString(data, end, message.attribute) || !readValues(data, end, message.values, 0))
+            return false;
+        messages.push_back(std::move(message));
+    }
+
+    return true;
+}
+
+/*************/
+void MessageCodec::writeVarint(vector<uint8_t>& buffer, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        buffer.push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    buffer.push_back(static_cast<uint8_t>(value));
+}
+
+/*************/
+void MessageCodec::writeString(vector<uint8_t>& buffer, const string& str)
+{
+    writeVarint(buffer, str.size());
+    buffer.insert(buffer.end(), str.begin(), str.end());
+}
+
+/*************/
+void MessageCodec::writeValue(vector<uint8_t>& buffer, const Value& value)
+{
+    auto type = value.getType();
+    uint8_t header = static_cast<uint8_t>(type);
+    if (value.isNamed())
+        header |= Flag::Named;
+    buffer.push_back(header);
+
+    if (value.isNamed())
+        writeString(buffer, value.getName());
+
+    switch (type)
+    {
+    default:
+        break;
+    case Value::Type::integer:
+    {
+        // Zigzag encoding, so that small negative numbers stay small
+        auto integer = value.as<int64_t>();
+        writeVarint(buffer, (static_cast<uint64_t>(integer) << 1) ^ static_cast<uint64_t>(integer >> 63));
+        break;
+    }
+    case Value::Type::real:
+    {
+        auto real = value.as<double>();
+        auto position = buffer.size();
+        buffer.resize(position + sizeof(real));
+        memcpy(buffer.data() + position, &real, sizeof(real));
+        break;
+    }
+    case Value::Type::string:
+        writeString(buffer, value.as<string>());
+        break;
+    case Value::Type::values:
+        writeVarint(buffer, value.size());
+        for (uint32_t i = 0; i < value.size(); ++i)
+            writeValue(buffer, value[i]);
+        break;
+    }
+}
+
+/*************/
+void MessageCodec::writeValues(vector<uint8_t>& buffer, const Values& values)
+{
+    writeVarint(buffer, values.size());
+    for (const auto& value : values)
+        writeValue(buffer, value);
+}
+
+/*************/
+bool MessageCodec::readVarint(const uint8_t*& data, const uint8_t* end, uint64_t& value)
+{
+    value = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7)
+    {
+        if (data >= end)
+            return false;
+        auto byte = *data++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+/*************/
+bool MessageCodec::readString(const uint8_t*& data, const uint8_t* end, string& str)
+{
+    uint64_t size;
+    if (!readVarint(data, end, size) || size > static_cast<uint64_t>(end - data))
+        return false;
+    str.assign(reinterpret_cast<const char*>(data), size);
+    data += size;
+    return true;
+}
+
+/*************/
+bool MessageCodec::readValue(const uint8_t*& data, const uint8_t* end, Values& values, int depth)
+{
+    if (depth > SPLASH_MESSAGE_CODEC_MAX_DEPTH || data >= end)
+        return false;
+    auto header = *data++;
+
+    string name;
+    if ((header & Flag::Named) && !readString(data, end, name))
+        return false;
+
+    switch (header & Flag::TypeMask)
+    {
+    default:
+        return false;
+    case Value::Type::integer:
+    {
+        uint64_t zigzag;
+        if (!readVarint(data, end, zigzag))
+            return false;
+        values.push_back(static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1));
+        break;
+    }
+    case Value::Type::real:
+    {
+        double real;
+        if (static_cast<size_t>(end - data) < sizeof(real))
+            return false;
+        memcpy(&real, data, sizeof(real));
+        data += sizeof(real);
+        values.push_back(real);
+        break;
+    }
+    case Value::Type::string:
+    {
+        string str;
+        if (!readString(data, end, str))
+            return false;
+        values.push_back(str);
+        break;
+    }
+    case Value::Type::values:
+    {
+        Values subValues;
+        if (!readValues(data, end, subValues, depth + 1))
+            return false;
+        values.push_back(subValues);
+        break;
+    }
+    }
+
+    if (!name.empty())
+        values.back().setName(name);
+
+    return true;
+}
+
+/*************/
+bool MessageCodec::readValues(const uint8_t*& data, const uint8_t* end, Values& values, int depth)
+{
+    uint64_t count;
+    // Each value takes at least one byte, which bounds the count for malformed frames
+    if (!readVarint(data, end, count) || count > static_cast<uint64_t>(end - data))
+        return false;
+
+    for (uint64_t i = 0; i < count; ++i)
+        if (!readValue(data, end, values, depth))
+            return false;
+
+    return true;
+}
+
+} // namespace Splash
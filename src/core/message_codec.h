@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2018 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @message_codec.h
+ * Binary wire format for the messages sent through a Link
+ */
+
+#ifndef SPLASH_MESSAGE_CODEC_H
+#define SPLASH_MESSAGE_CODEC_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "./core/value.h"
+
+#define SPLASH_MESSAGE_CODEC_VERSION 1
+
+namespace Splash
+{
+
+/*************/
+/**
+ * A frame starts with the format version, followed by one or more messages.
+ * Each message holds the target name, the attribute name and the values tree.
+ * Lengths and integers are stored as varints, names are stored inline.
+ */
+class MessageCodec
+{
+  public:
+    struct Message
+    {
+        std::string target{""};
+        std::string attribute{""};
+        Values values{};
+    };
+
+    /**
+     * \brief Start a new frame in the given buffer, clearing it
+     * \param buffer Buffer to initialize
+     */
+    static void startFrame(std::vector<uint8_t>& buffer);
+
+    /**
+     * \brief Append a message to a frame started with startFrame
+     * \param buffer Frame buffer
+     * \param target Target name
+     * \param attribute Attribute name
+     * \param values Message values
+     */
+    static void encode(std::vector<uint8_t>& buffer, const std::string& target, const std::string& attribute, const Values& values);
+
+    /**
+     * \brief Decode all messages in a frame
+     * \param data Pointer to the frame
+     * \param size Frame size
+     * \param messages Decoded messages are appended to this vector
+     * \return Return false if the frame is malformed or its version is not supported
+     */
+    static bool decode(const uint8_t* data, size_t size, std::vector<Message>& messages);
+
+  private:
+    enum Flag : uint8_t
+    {
+        TypeMask = 0x0F,
+        Named = 0x80
+    };
+
+    static void writeVarint(std::vector<uint8_t>& buffer, uint64_t value);
+    static void writeString(std::vector<uint8_t>& buffer, const std::string& str);
+    static void writeValue(std::vector<uint8_t>& buffer, const Value& value);
+    static void writeValues(std::vector<uint8_t>& buffer, const Values& values);
+
+    static bool readVarint(const uint8_t*& data, const uint8_t* end, uint64_t& value);
+    static bool readString(const uint8_t*& data, const uint8_t* end, std::string& str);
+    static bool readValue(const uint8_t*& data, const uint8_t* end, Values& values, int depth);
+    static bool readValues(const uint8_t*& data, const uint8_t* end, Values& values, int depth);
+};
+
+} // namespace Splash
+
+#endif // SPLASH_MESSAGE_CODEC_H
@@ -10,6 +10,32 @@ namespace Splash
 
 std::atomic_uint NameRegistry::_counter{1};
 
+/*************/
+NameId NameRegistry::intern(const string& name)
+{
+    auto& interned = getInternedNames();
+    lock_guard<mutex> lock(interned.mutex);
+    auto idIt = interned.ids.find(name);
+    if (idIt != interned.ids.end())
+        return idIt->second;
+
+    auto id = static_cast<NameId>(interned.names.size());
+    interned.names.push_back(name);
+    interned.ids.emplace(name, id);
+    return id;
+}
+
+/*************/
+const string& NameRegistry::getInternedName(NameId id)
+{
+    static const string emptyName{};
+    auto& interned = getInternedNames();
+    lock_guard<mutex> lock(interned.mutex);
+    if (id >= interned.names.size())
+        return emptyName;
+    return interned.names[id];
+}
+
 /*************/
 std::string NameRegistry::generateName(const string& prefix)
 {
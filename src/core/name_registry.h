@@ -26,17 +26,37 @@
 #define SPLASH_NAME_REGISTRY_H
 
 #include <atomic>
+#include <cstdint>
+#include <deque>
 #include <list>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 
 namespace Splash
 {
 
+using NameId = uint32_t; //!< Identifier of an interned name
+
 /*************/
 class NameRegistry
 {
   public:
+    /**
+     * Intern a name, shared by the whole process. Interned names are never released,
+     * which allows for comparing and hashing them as integers
+     * \param name Name to intern
+     * \return Return the identifier of the name, the same for all calls with the same name. The empty name is always 0
+     */
+    static NameId intern(const std::string& name);
+
+    /**
+     * Get an interned name from its identifier
+     * \param id Name identifier
+     * \return Return the name, or an empty string if the identifier is unknown
+     */
+    static const std::string& getInternedName(NameId id);
+
     /**
      * Generate a name given a prefix
      * \param prefix Prefix
@@ -58,9 +78,32 @@ class NameRegistry
     void unregisterName(const std::string& name);
 
   private:
+    struct InternedNames
+    {
+        InternedNames()
+            : ids({{"", 0}})
+            , names({""})
+        {
+        }
+
+        std::mutex mutex{};
+        std::unordered_map<std::string, NameId> ids{};
+        std::deque<std::string> names{}; //!< Indexed by identifier, a deque keeps references to the names valid
+    };
+
     static std::atomic_uint _counter;
     std::list<std::string> _registry{};
     std::mutex _registryMutex{};
+
+    /**
+     * Get the process wide interned names, never destroyed as names may be used by static objects at exit
+     * \return Return the interned names
+     */
+    static InternedNames& getInternedNames()
+    {
+        static auto internedNames = new InternedNames;
+        return *internedNames;
+    }
 };
 
 } // namespace Splash
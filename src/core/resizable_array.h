@@ -26,7 +26,11 @@
 #define SPLASH_RESIZABLE_ARRAY_H
 
 #include <cstring>
+#include <functional>
 #include <memory>
+#include <type_traits>
+
+#include "./core/buffer_pool.h"
 
 namespace Splash
 {
@@ -36,6 +40,8 @@ template <typename T>
 class ResizableArray
 {
   public:
+    using Deleter = std::function<void(T*)>;
+
     /**
      * \brief Constructor with an initial size
      * \param size Initial array size
@@ -60,10 +66,32 @@ class ResizableArray
 
         _size = static_cast<size_t>(end - start);
         _shift = 0;
-        _buffer = std::unique_ptr<T[]>(new T[_size]);
+        _buffer = allocate(_size, _capacity);
         memcpy(_buffer.get(), start, _size * sizeof(T));
     }
 
+    /**
+     * \brief Constructor wrapping memory owned by someone else, without copying it
+     * The deleter is called with start as parameter when the array does not need the memory anymore
+     * \param start Begin iterator
+     * \param end End iterator
+     * \param deleter Function releasing the memory
+     */
+    ResizableArray(T* start, T* end, const Deleter& deleter)
+    {
+        if (end <= start)
+        {
+            if (deleter)
+                deleter(start);
+            return;
+        }
+
+        _size = static_cast<size_t>(end - start);
+        _shift = 0;
+        _capacity = _size;
+        _buffer = std::unique_ptr<T[], Deleter>(start, deleter);
+    }
+
     /**
      * \brief Copy constructor
      * \param a ResizableArray to copy
@@ -72,7 +100,7 @@ class ResizableArray
     {
         _size = a.size();
         _shift = 0;
-        _buffer = std::unique_ptr<T[]>(new T[_size]);
+        _buffer = allocate(_size, _capacity);
         memcpy(data(), a.data(), _size);
     }
 
@@ -83,8 +111,12 @@ class ResizableArray
     ResizableArray(ResizableArray&& a)
         : _size(a._size)
         , _shift(a._shift)
+        , _capacity(a._capacity)
         , _buffer(std::move(a._buffer))
     {
+        a._size = 0;
+        a._shift = 0;
+        a._capacity = 0;
     }
 
     /**
@@ -98,7 +130,7 @@ class ResizableArray
 
         _size = a.size();
         _shift = 0;
-        _buffer = std::unique_ptr<T[]>(new T[_size]);
+        _buffer = allocate(_size, _capacity);
         memcpy(data(), a.data(), _size);
 
         return *this;
@@ -115,7 +147,11 @@ class ResizableArray
 
         _size = a._size;
         _shift = a._shift;
+        _capacity = a._capacity;
         _buffer = std::move(a._buffer);
+        a._size = 0;
+        a._shift = 0;
+        a._capacity = 0;
 
         return *this;
     }
@@ -153,7 +189,7 @@ class ResizableArray
     inline size_t size() const { return _size; }
 
     /**
-     * \brief Resize the buffer
+     * \brief Resize the buffer, reusing the current memory if the new size is close enough to its capacity
      * \param size New size
      */
     inline void resize(size_t size)
@@ -162,24 +198,61 @@ class ResizableArray
         {
             _size = 0;
             _shift = 0;
+            _capacity = 0;
             _buffer.reset(nullptr);
+            return;
+        }
+
+        if (_buffer && _shift == 0 && size <= _capacity && size > _capacity / 2)
+        {
+            _size = size;
+            return;
         }
 
-        auto newBuffer = std::unique_ptr<T[]>(new T[size]);
+        size_t capacity = 0;
+        auto newBuffer = allocate(size, capacity);
         if (size >= _size)
-            memcpy(newBuffer.get(), _buffer.get(), _size);
+            memcpy(newBuffer.get(), data(), _size);
         else
-            memcpy(newBuffer.get(), _buffer.get(), size);
+            memcpy(newBuffer.get(), data(), size);
 
         std::swap(_buffer, newBuffer);
         _size = size;
         _shift = 0;
+        _capacity = capacity;
     }
 
   private:
-    size_t _size{0};                       //!< Buffer size
-    size_t _shift{0};                      //!< Buffer shift
-    std::unique_ptr<T[]> _buffer{nullptr}; //!< Pointer to the buffer data
+    size_t _size{0};                                               //!< Buffer size
+    size_t _shift{0};                                              //!< Buffer shift
+    size_t _capacity{0};                                           //!< Number of elements allocated
+    std::unique_ptr<T[], Deleter> _buffer{nullptr, defaultDelete}; //!< Pointer to the buffer data
+
+    /**
+     * \brief Default deleter, for memory allocated by the array itself
+     * \param ptr Pointer to the memory
+     */
+    static void defaultDelete(T* ptr) { delete[] ptr; }
+
+    /**
+     * \brief Allocate a new buffer owned by the array, from the BufferPool if it is large enough
+     * \param size Buffer size
+     * \param capacity Set to the number of elements actually allocated
+     * \return Return the buffer
+     */
+    static std::unique_ptr<T[], Deleter> allocate(size_t size, size_t& capacity)
+    {
+        auto poolCapacity = std::is_trivial<T>::value ? BufferPool::getCapacity(size * sizeof(T)) : 0;
+        if (poolCapacity == 0)
+        {
+            capacity = size;
+            return std::unique_ptr<T[], Deleter>(new T[size], defaultDelete);
+        }
+
+        capacity = poolCapacity / sizeof(T);
+        auto buffer = BufferPool::get().acquire(poolCapacity);
+        return std::unique_ptr<T[], Deleter>(reinterpret_cast<T*>(buffer), [poolCapacity](T* ptr) { BufferPool::get().release(reinterpret_cast<char*>(ptr), poolCapacity); });
+    }
 };
 
 } // end of namespace
@@ -44,6 +44,7 @@ weak_ptr<GraphObject> RootObject::createObject(const string& type, const string&
         object->setName(name);
         object->setSavable(false);
         _objects[name] = object;
+        setRenderGraphDirty();
         return object;
     }
 }
@@ -55,7 +56,10 @@ void RootObject::disposeObject(const string& name)
         lock_guard<recursive_mutex> registerLock(_objectsMutex);
         auto objectIt = _objects.find(name);
         if (objectIt != _objects.end() && objectIt->second.use_count() == 1)
+        {
             _objects.erase(objectIt);
+            setRenderGraphDirty();
+        }
     });
 }
 
@@ -83,11 +87,15 @@ bool RootObject::set(const string& name, const string& attrib, const Values& arg
 
     if (async)
     {
-        addTask([=]() {
-            auto object = getObject(name);
-            if (object)
-                object->setAttribute(attrib, args);
-        });
+        // Attributes flagged as coalesced only care about their latest value, older ones are dropped if not yet set
+        auto key = object && object->isAttributeCoalesced(attrib) ? name + "." + attrib : "";
+        addTask(
+            [=]() {
+                auto object = getObject(name);
+                if (object)
+                    object->setAttribute(attrib, args);
+            },
+            key);
     }
     else
     {
@@ -112,7 +120,9 @@ void RootObject::setFromSerializedObject(const string& name, shared_ptr<Serializ
     }
     else
     {
-        handleSerializedObject(name, move(obj));
+        // Buffers are handled uncompressed from here on
+        if (obj->decompress())
+            handleSerializedObject(name, move(obj));
     }
 }
 
@@ -205,12 +215,8 @@ void RootObject::registerAttributes()
 /*************/
 void RootObject::runTasks()
 {
-    unique_lock<recursive_mutex> lockTasks(_taskMutex);
-    decltype(_taskQueue) tasks;
-    std::swap(tasks, _taskQueue);
-    lockTasks.unlock();
-    for (auto& task : tasks)
-        task();
+    // Tasks added while running are left for the next call, so that the loop never waits on producers
+    _taskQueue.run();
 
     unique_lock<mutex> lockRecurrsiveTasks(_recurringTaskMutex);
     for (auto& task : _recurringTasks)
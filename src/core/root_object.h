@@ -137,6 +137,11 @@ class RootObject : public BaseObject
      */
     void signalBufferObjectUpdated();
 
+    /**
+     * \brief Signals that objects were added, removed, relinked, or changed rendering priority
+     */
+    void setRenderGraphDirty() { _renderGraphDirty.store(true, std::memory_order_release); }
+
   protected:
     std::string _configurationPath{""}; //!< Path to the configuration file
     std::string _mediaPath{""};         //!< Default path to the medias
@@ -164,6 +169,7 @@ class RootObject : public BaseObject
     mutable std::recursive_mutex _objectsMutex{};                             //!< Used in registration and unregistration of objects
     std::atomic_bool _objectsCurrentlyUpdated{false};                         //!< Prevents modification of objects from multiple places at the same time
     std::unordered_map<std::string, std::shared_ptr<GraphObject>> _objects{}; //!< Map of all the objects
+    std::atomic_bool _renderGraphDirty{true};                                 //!< True if the render graph has to be rebuilt from _objects
 
     /**
      * \brief Wait for a BufferObject update. This does not prevent spurious wakeups.
@@ -4,16 +4,20 @@
 
 #include "./controller/controller_blender.h"
 #include "./controller/controller_gui.h"
+#include "./core/buffer_object.h"
+#include "./core/buffer_pool.h"
 #include "./core/link.h"
 #include "./graphics/camera.h"
 #include "./graphics/filter.h"
 #include "./graphics/geometry.h"
 #include "./graphics/object.h"
 #include "./graphics/profiler_gl.h"
+#include "./graphics/shader.h"
 #include "./graphics/texture.h"
 #include "./graphics/texture_image.h"
 #include "./graphics/warp.h"
 #include "./graphics/window.h"
+#include "./image/frame_writer.h"
 #include "./image/image.h"
 #include "./image/queue.h"
 #include "./mesh/mesh.h"
@@ -24,6 +28,7 @@
 #include "./utils/log.h"
 #include "./utils/osutils.h"
 #include "./utils/timer.h"
+#include "./utils/tracer.h"
 
 #if HAVE_GPHOTO and HAVE_OPENCV
 #include "./controller/colorcalibrator.h"
@@ -46,6 +51,7 @@ namespace Splash
 {
 
 bool Scene::_hasNVSwapGroup{false};
+bool Scene::_headless{false};
 vector<int> Scene::_glVersion{0, 0};
 vector<string> Scene::_ghostableTypes{"camera", "warp"};
 
@@ -62,7 +68,7 @@ bool Scene::getHasNVSwapGroup()
 }
 
 /*************/
-Scene::Scene(const string& name, const string& socketPrefix)
+Scene::Scene(const string& name, const string& socketPrefix, int listenPort)
     : _objectLibrary(dynamic_cast<RootObject*>(this))
 {
     Log::get() << Log::DEBUGGING << "Scene::Scene - Scene created successfully" << Log::endl;
@@ -70,6 +76,7 @@ Scene::Scene(const string& name, const string& socketPrefix)
     _isRunning = true;
     _name = name;
     _linkSocketPrefix = socketPrefix;
+    _linkListenPort = listenPort;
 
     // We have to reset the factory to create a Scene factory
     _factory.reset(new Factory(this));
@@ -92,7 +99,10 @@ Scene::~Scene()
     _mainWindow->setAsCurrentContext();
     lock_guard<recursive_mutex> lockObjects(_objectsMutex); // We don't want any friend to try accessing the objects
 
-    // Free objects cleanly
+    // Free objects cleanly, starting with the render graph which points to them
+    _renderList.clear();
+    _renderBatches.clear();
+    _windows.clear();
     for (auto& obj : _objects)
         obj.second.reset();
     _objects.clear();
@@ -134,6 +144,7 @@ std::shared_ptr<GraphObject> Scene::addObject(const string& type, const string&
 
         obj->setName(name);
         _objects[name] = obj;
+        setRenderGraphDirty();
 
         // Some objects have to be connected to the gui (if the Scene is master)
         if (_gui != nullptr)
@@ -274,6 +285,8 @@ bool Scene::link(const std::shared_ptr<GraphObject>& first, const std::shared_pt
 
     lock_guard<recursive_mutex> lockObjects(_objectsMutex);
     bool result = second->linkTo(first);
+    if (result)
+        setRenderGraphDirty();
 
     return result;
 }
@@ -291,6 +304,7 @@ void Scene::unlink(const std::shared_ptr<GraphObject>& first, const std::shared_
         return;
 
     second->unlinkFrom(first);
+    setRenderGraphDirty();
 }
 
 /*************/
@@ -301,7 +315,10 @@ void Scene::remove(const string& name)
     lock_guard<recursive_mutex> lockObjects(_objectsMutex);
 
     if (_objects.find(name) != _objects.end())
+    {
         _objects.erase(name);
+        setRenderGraphDirty();
+    }
 }
 
 /*************/
@@ -311,53 +328,37 @@ void Scene::render()
 #ifdef PROFILE
         PROFILEGL("Render loop")
 #endif
-        // Create lists of objects to update and to render
-        map<GraphObject::Priority, vector<shared_ptr<GraphObject>>> objectList{};
         {
             lock_guard<recursive_mutex> lockObjects(_objectsMutex);
+            // We run all pending tasks for every object, which may change the render graph
             for (auto& obj : _objects)
-            {
-                // We also run all pending tasks for every object
                 obj.second->runTasks();
 
-                // Ghosts are not updated in the render loop
-                if (obj.second->isGhost())
-                    continue;
-
-                auto priority = obj.second->getRenderingPriority();
-                if (priority == GraphObject::Priority::NO_RENDER)
-                    continue;
-
-                auto listIt = objectList.find(priority);
-                if (listIt == objectList.end())
-                {
-                    auto entry = objectList.emplace(std::make_pair(priority, vector<shared_ptr<GraphObject>>()));
-                    if (entry.second == true)
-                        listIt = entry.first;
-                    else
-                        continue;
-                }
-
-                listIt->second.push_back(obj.second);
-            }
+            if (_renderGraphDirty.exchange(false, memory_order_acq_rel))
+                updateRenderGraph();
         }
 
+        beginGpuTraceFrame();
+
         // Update and render the objects
         // See GraphObject::getRenderingPriority() for precision about priorities
         bool firstTextureSync = true; // Sync with the texture upload the first time we need textures
         bool firstWindowSync = true;  // Sync with the texture upload the last time we need textures
         auto textureLock = unique_lock<Spinlock>(_textureMutex, defer_lock);
-        for (auto& objPriority : objectList)
+        for (const auto& batch : _renderBatches)
         {
             // If the objects needs some Textures, we need to sync
-            if (firstTextureSync && objPriority.first > GraphObject::Priority::BLENDING && objPriority.first < GraphObject::Priority::POST_CAMERA)
+            if (firstTextureSync && batch.priority > GraphObject::Priority::BLENDING && batch.priority < GraphObject::Priority::POST_CAMERA)
             {
 #ifdef PROFILE
                 PROFILEGL("texture upload lock");
 #endif
                 // We wait for textures to be uploaded, and we prevent any upload while rendering
                 // cameras to prevent tearing
+                static const auto textureLockSlot = Timer::get().getSlot("texture_lock_wait");
+                Timer::get() << textureLockSlot;
                 textureLock.lock();
+                Timer::get() >> textureLockSlot;
                 if (glIsSync(_textureUploadFence) == GL_TRUE)
                 {
                     glWaitSync(_textureUploadFence, 0, GL_TIMEOUT_IGNORED);
@@ -366,11 +367,12 @@ void Scene::render()
                 firstTextureSync = false;
             }
 
-            if (objPriority.second.size() != 0)
-                Timer::get() << objPriority.second[0]->getType();
+            Timer::get() << batch.timerSlot;
+            beginGpuTrace(batch.timerSlot.id);
 
-            for (auto& obj : objPriority.second)
+            for (auto objIt = _renderList.begin() + batch.first; objIt != _renderList.begin() + batch.last; ++objIt)
             {
+                auto& obj = *objIt;
 #ifdef PROFILE
                 PROFILEGL("object " + obj->getName());
 #endif
@@ -391,10 +393,10 @@ void Scene::render()
                 obj->render();
             }
 
-            if (objPriority.second.size() != 0)
-                Timer::get() >> objPriority.second[0]->getType();
+            endGpuTrace();
+            Timer::get() >> batch.timerSlot;
 
-            if (firstWindowSync && objPriority.first >= GraphObject::Priority::POST_CAMERA)
+            if (firstWindowSync && batch.priority >= GraphObject::Priority::POST_CAMERA)
             {
 #ifdef PROFILE
                 PROFILEGL("texture upload unlock");
@@ -413,12 +415,16 @@ void Scene::render()
             PROFILEGL("swap buffers");
 #endif
             // Swap all buffers at once
-            Timer::get() << "swap";
-            for (auto& obj : _objects)
-                if (obj.second->getType() == "window")
-                    dynamic_pointer_cast<Window>(obj.second)->swapBuffers();
-            Timer::get() >> "swap";
+            static const auto swapSlot = Timer::get().getSlot("swap");
+            Timer::get() << swapSlot;
+            for (auto& window : _windows)
+                window->swapBuffers();
+            Timer::get() >> swapSlot;
         }
+
+        ++_gpuTraceFrameIndex;
+
+        Shader::markFrameEnd();
     }
 
 #ifdef PROFILE
@@ -426,24 +432,126 @@ void Scene::render()
 #endif
 }
 
+/*************/
+void Scene::beginGpuTraceFrame()
+{
+    auto& frame = _gpuTraceFrames[_gpuTraceFrameIndex % _gpuTraceFrames.size()];
+    if (!Tracer::get().isEnabled())
+    {
+        frame.used = 0;
+        return;
+    }
+
+    // Results of the queries issued with this frame slot are read back, if available
+    for (size_t i = 0; i < frame.used; ++i)
+    {
+        auto& query = frame.queries[i];
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(query.queries[1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available != GL_TRUE)
+            continue;
+
+        GLuint64 begin, end;
+        glGetQueryObjectui64v(query.queries[0], GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(query.queries[1], GL_QUERY_RESULT, &end);
+        Tracer::get().record(query.name, static_cast<int64_t>(begin / 1000) + frame.clockOffset, (end - begin) / 1000, Tracer::Category::gpu);
+    }
+    frame.used = 0;
+
+    // GPU timestamps are in ns, from a clock of their own
+    GLint64 gpuTime;
+    glGetInteger64v(GL_TIMESTAMP, &gpuTime);
+    frame.clockOffset = Timer::getTime() - gpuTime / 1000;
+}
+
+/*************/
+void Scene::beginGpuTrace(uint32_t name)
+{
+    if (!Tracer::get().isEnabled())
+        return;
+
+    auto& frame = _gpuTraceFrames[_gpuTraceFrameIndex % _gpuTraceFrames.size()];
+    if (frame.used == frame.queries.size())
+    {
+        frame.queries.emplace_back();
+        glGenQueries(2, frame.queries.back().queries);
+    }
+
+    auto& query = frame.queries[frame.used++];
+    query.name = name;
+    glQueryCounter(query.queries[0], GL_TIMESTAMP);
+}
+
+/*************/
+void Scene::endGpuTrace()
+{
+    auto& frame = _gpuTraceFrames[_gpuTraceFrameIndex % _gpuTraceFrames.size()];
+    if (!Tracer::get().isEnabled() || frame.used == 0)
+        return;
+
+    glQueryCounter(frame.queries[frame.used - 1].queries[1], GL_TIMESTAMP);
+}
+
+/*************/
+void Scene::updateRenderGraph()
+{
+    _renderList.clear();
+    _renderBatches.clear();
+    _windows.clear();
+
+    for (auto& obj : _objects)
+    {
+        if (obj.second->getType() == "window")
+            _windows.push_back(dynamic_cast<Window*>(obj.second.get()));
+
+        // Ghosts are not updated in the render loop
+        if (obj.second->isGhost())
+            continue;
+
+        if (obj.second->getRenderingPriority() == GraphObject::Priority::NO_RENDER)
+            continue;
+
+        _renderList.push_back(obj.second.get());
+    }
+
+    stable_sort(_renderList.begin(), _renderList.end(), [](const GraphObject* lhs, const GraphObject* rhs) {
+        return lhs->getRenderingPriority() < rhs->getRenderingPriority();
+    });
+
+    // Objects sharing a priority are rendered as a batch, timed under the type of its first object
+    for (size_t index = 0; index < _renderList.size(); ++index)
+    {
+        auto priority = _renderList[index]->getRenderingPriority();
+        if (_renderBatches.empty() || _renderBatches.back().priority != priority)
+            _renderBatches.push_back({priority, Timer::get().getSlot(_renderList[index]->getType()), index, index});
+        _renderBatches.back().last = index + 1;
+    }
+}
+
 /*************/
 void Scene::run()
 {
     _textureUploadFuture = async(std::launch::async, [&]() { textureUploadRun(); });
 
+    auto& timer = Timer::get();
+    const auto swapSyncSlot = timer.getSlot("swap_sync");
+    const auto loopSceneSlot = timer.getSlot("loop_scene");
+    const auto renderingSlot = timer.getSlot("rendering");
+    const auto inputsUpdateSlot = timer.getSlot("inputsUpdate");
+
     _mainWindow->setAsCurrentContext();
     while (_isRunning)
     {
         // This gets the whole loop duration
-        if (_runInBackground && _swapInterval != 0)
+        if (_runInBackground && _swapInterval != 0 && !_offlineRendering)
         {
             // Artificial synchronization to avoid overloading the GPU in hidden mode
-            Timer::get() >> _targetFrameDuration >> "swap_sync";
-            Timer::get() << "swap_sync";
+            timer >> _targetFrameDuration >> swapSyncSlot;
+            timer << swapSyncSlot;
         }
 
-        Timer::get() >> "loop_scene";
-        Timer::get() << "loop_scene";
+        timer >> loopSceneSlot;
+        timer << loopSceneSlot;
 
         // Execute waiting tasks
         runTasks();
@@ -454,13 +562,21 @@ void Scene::run()
             continue;
         }
 
-        Timer::get() << "rendering";
-        render();
-        Timer::get() >> "rendering";
+        // When rendering offline, frames are rendered only when requested by the World
+        if (_offlineRendering)
+        {
+            renderOfflineFrame();
+        }
+        else
+        {
+            timer << renderingSlot;
+            render();
+            timer >> renderingSlot;
+        }
 
-        Timer::get() << "inputsUpdate";
+        timer << inputsUpdateSlot;
         updateInputs();
-        Timer::get() >> "inputsUpdate";
+        timer >> inputsUpdateSlot;
     }
     _mainWindow->releaseContext();
 
@@ -473,6 +589,61 @@ void Scene::run()
 #endif
 }
 
+/*************/
+bool Scene::renderOfflineFrame()
+{
+    OfflineFrame request;
+    {
+        unique_lock<mutex> lock(_offlineFramesMutex);
+        if (!_offlineFramesCondition.wait_for(lock, chrono::milliseconds(10), [&]() { return !_offlineFrames.empty(); }))
+            return false;
+        request = move(_offlineFrames.front());
+        _offlineFrames.pop_front();
+    }
+
+    // Wait for the buffers sent along with this frame to be processed
+    auto waitStart = Timer::getTime();
+    for (const auto& buffer : request.buffers)
+    {
+        auto name = buffer.as<string>();
+        auto object = dynamic_pointer_cast<BufferObject>(getObject(name));
+        if (!object)
+            continue;
+
+        auto& count = _offlineBufferCounts[name];
+        while (object->getDeserializedCount() <= count && Timer::getTime() - waitStart < SPLASH_SCENE_OFFLINE_BUFFER_TIMEOUT)
+            this_thread::sleep_for(chrono::microseconds(100));
+        if (object->getDeserializedCount() <= count)
+            Log::get() << Log::WARNING << "Scene::" << __FUNCTION__ << " - Buffer " << name << " not received in time for frame " << request.index << Log::endl;
+        count = object->getDeserializedCount();
+    }
+    _offlineBufferWaitDuration += Timer::getTime() - waitStart;
+
+    // Make sure all windows are read back, including those added since the last frame
+    {
+        lock_guard<recursive_mutex> lockObjects(_objectsMutex);
+        if (_renderGraphDirty.exchange(false, memory_order_acq_rel))
+            updateRenderGraph();
+        for (auto& window : _windows)
+            window->setAttribute("readback", {1});
+    }
+
+    auto renderStart = Timer::getTime();
+    render();
+    _offlineRenderDuration += Timer::getTime() - renderStart;
+    ++_offlineFrameCount;
+
+    for (auto& window : _windows)
+    {
+        auto image = window->getReadback();
+        if (image.getSize() != 0 && _frameWriter)
+            _frameWriter->push(window->getName(), request.index, move(image));
+    }
+
+    sendMessageToWorld("offlineFrameRendered", {_name, request.index});
+    return true;
+}
+
 /*************/
 void Scene::updateInputs()
 {
@@ -494,6 +665,10 @@ void Scene::updateInputs()
 /*************/
 void Scene::textureUploadRun()
 {
+    auto& timer = Timer::get();
+    const auto loopTextureSlot = timer.getSlot("loop_texture");
+    const auto textureUploadSlot = timer.getSlot("textureUpload");
+
     _textureUploadWindow->setAsCurrentContext();
 
     while (_isRunning)
@@ -505,8 +680,8 @@ void Scene::textureUploadRun()
         }
 
         waitSignalBufferObjectUpdated();
-        Timer::get() >> "loop_texture";
-        Timer::get() << "loop_texture";
+        timer >> loopTextureSlot;
+        timer << loopTextureSlot;
 
         if (!_isRunning)
             break;
@@ -550,7 +725,7 @@ void Scene::textureUploadRun()
                 glDeleteSync(_cameraDrawnFence);
             }
 
-            Timer::get() << "textureUpload";
+            timer << textureUploadSlot;
 
             for (auto& texture : textures)
             {
@@ -575,7 +750,7 @@ void Scene::textureUploadRun()
                     texImage->flushPbo();
             }
 
-            Timer::get() >> "textureUpload";
+            timer >> textureUploadSlot;
         }
 
 #ifdef PROFILE
@@ -633,6 +808,8 @@ void Scene::setAsMaster(const string& configFilePath)
     _colorCalibrator->setName("colorCalibrator");
     _objects["colorCalibrator"] = _colorCalibrator;
 #endif
+
+    setRenderGraphDirty();
 }
 
 /*************/
@@ -752,6 +929,19 @@ void Scene::init(const string& name)
 {
     glfwSetErrorCallback(Scene::glfwErrorCallback);
 
+    // When headless, GLFW does not connect to any display server and contexts
+    // are created through EGL, which also works with surfaceless Mesa drivers
+    if (_headless)
+    {
+#if HAVE_HEADLESS
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+#else
+        Log::get() << Log::ERROR << "Scene::" << __FUNCTION__ << " - Headless rendering needs Splash to be built against GLFW 3.4 or newer" << Log::endl;
+        _isInitialized = false;
+        return;
+#endif
+    }
+
     // GLFW stuff
     if (!glfwInit())
     {
@@ -760,6 +950,10 @@ void Scene::init(const string& name)
         return;
     }
 
+    // Window hints are kept until GLFW is terminated, so this applies to all windows
+    if (_headless)
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+
     auto glVersion = findGLVersion();
     if (glVersion[0] == 0)
     {
@@ -831,7 +1025,9 @@ void Scene::init(const string& name)
     _textureUploadWindow = getNewSharedWindow();
 
     // Create the link and connect to the World
-    _link = make_shared<Link>(this, name);
+    _link = make_shared<Link>(this, name, _linkListenPort);
+    if (_linkListenPort != 0)
+        Log::get() << Log::MESSAGE << "Scene::" << __FUNCTION__ << " - Waiting for the World to connect on port " << _linkListenPort << Log::endl;
     _link->connectTo("world");
     sendMessageToWorld("sceneLaunched", {});
 }
@@ -973,6 +1169,7 @@ void Scene::registerAttributes()
                 for (auto& localObject : _objects)
                     unlink(object, localObject.second);
                 _objects.erase(objectName);
+                setRenderGraphDirty();
             });
 
             return true;
@@ -1047,6 +1244,15 @@ void Scene::registerAttributes()
         {'n'});
     setAttributeDescription("logToFile", "If set to 1, the process holding the Scene will try to write log to file");
 
+    addAttribute("getTrace", [&](const Values&) {
+        auto events = Tracer::get().getEvents();
+        auto trace = Tracer::toChromeTrace(events, 0, _name, [](uint32_t id) { return Timer::get().getSlotName({id}); });
+        Json::FastWriter writer;
+        sendMessageToWorld("answerMessage", {"getTrace", _name, Timer::getTime(), writer.write(trace)});
+        return true;
+    });
+    setAttributeDescription("getTrace", "Ask the Scene for the events recorded while tracing, in the Chrome trace format");
+
     addAttribute("ping", [&](const Values&) {
         signalBufferObjectUpdated();
         sendMessageToWorld("pong", {_name});
@@ -1054,6 +1260,115 @@ void Scene::registerAttributes()
     });
     setAttributeDescription("ping", "Ping the World");
 
+    addAttribute("renderOfflineFrame", [&](const Values& args) {
+        OfflineFrame request;
+        request.index = args[0].as<int64_t>();
+        request.buffers = args[1].as<Values>();
+
+        {
+            lock_guard<mutex> lock(_offlineFramesMutex);
+            _offlineFrames.push_back(move(request));
+        }
+        _offlineFramesCondition.notify_one();
+        return true;
+    }, {'n', 'v'});
+    setAttributeDescription("renderOfflineFrame", "Render the given frame when rendering offline, once the given buffers are received");
+
+    addAttribute("startOfflineRendering", [&](const Values& args) {
+        auto directory = args[0].as<string>();
+        FrameWriter::Format format;
+        if (!FrameWriter::getFormatFromName(args[1].as<string>(), format))
+        {
+            Log::get() << Log::WARNING << "Scene::" << __FUNCTION__ << " - Unknown offline rendering output format: " << args[1].as<string>() << Log::endl;
+            return false;
+        }
+
+        // Only the buffers received from now on are considered as sent for the frames to render.
+        // This is done right away, as the buffers for the first frame may arrive before the task below runs
+        {
+            lock_guard<recursive_mutex> lockObjects(_objectsMutex);
+            _offlineBufferCounts.clear();
+            for (auto& object : _objects)
+            {
+                auto bufferObject = dynamic_pointer_cast<BufferObject>(object.second);
+                if (bufferObject)
+                    _offlineBufferCounts[object.first] = bufferObject->getDeserializedCount();
+            }
+        }
+
+        addTask([=]() {
+            _frameWriter = make_unique<FrameWriter>(directory, format);
+            _offlineFrameCount = 0;
+            _offlineRenderDuration = 0;
+            _offlineBufferWaitDuration = 0;
+            _offlineRendering = true;
+        });
+        return true;
+    }, {'s', 's'});
+    setAttributeDescription("startOfflineRendering", "Render only the frames requested by the World, and write the windows content to the given directory, as \"png\" or \"raw\" RGBA");
+
+    addAttribute("stopOfflineRendering", [&](const Values&) {
+        addTask([=]() {
+            _offlineRendering = false;
+            {
+                lock_guard<mutex> lock(_offlineFramesMutex);
+                _offlineFrames.clear();
+            }
+
+            lock_guard<recursive_mutex> lockObjects(_objectsMutex);
+            for (auto& window : _windows)
+                window->setAttribute("readback", {0});
+
+            int64_t writtenCount = 0;
+            int64_t writeDuration = 0;
+            if (_frameWriter)
+            {
+                _frameWriter->flush();
+                writtenCount = _frameWriter->getWrittenCount();
+                writeDuration = _frameWriter->getWriteDuration();
+                _frameWriter.reset();
+            }
+
+            sendMessageToWorld("answerMessage",
+                {"stopOfflineRendering",
+                    _name,
+                    static_cast<int64_t>(_offlineFrameCount),
+                    static_cast<int64_t>(_offlineBufferWaitDuration),
+                    static_cast<int64_t>(_offlineRenderDuration),
+                    writtenCount,
+                    writeDuration});
+        });
+        return true;
+    });
+    setAttributeDescription("stopOfflineRendering", "Stop rendering offline, and answer with the rendering statistics once all frames are written");
+
+    addAttribute("bufferPoolSize",
+        [&](const Values& args) {
+            BufferPool::get().setMaxResidentSize(static_cast<size_t>(max(args[0].as<int>(), 0)) << 20);
+            return true;
+        },
+        [&]() -> Values { return {static_cast<int>(BufferPool::get().getMaxResidentSize() >> 20)}; },
+        {'n'});
+    setAttributeDescription("bufferPoolSize", "Set the maximum size of the memory buffers kept for reuse, in MB");
+
+    addAttribute("bufferPoolIdleTime",
+        [&](const Values& args) {
+            BufferPool::get().setIdleTime(chrono::milliseconds(static_cast<int64_t>(max(args[0].as<float>(), 0.f) * 1000.f)));
+            return true;
+        },
+        [&]() -> Values { return {static_cast<float>(BufferPool::get().getIdleTime().count()) / 1000.f}; },
+        {'n'});
+    setAttributeDescription("bufferPoolIdleTime", "Set the time after which unused memory buffers are freed, in seconds");
+
+    addAttribute("tracing",
+        [&](const Values& args) {
+            Tracer::get().setEnabled(args[0].as<bool>());
+            return true;
+        },
+        [&]() -> Values { return {Tracer::get().isEnabled()}; },
+        {'n'});
+    setAttributeDescription("tracing", "If set to 1, record the CPU and GPU timings of the Scene for the trace export");
+
     addAttribute("sync", [&](const Values&) {
         addTask([=]() { sendMessageToWorld("answerMessage", {"sync", _name}); });
         return true;
@@ -25,10 +25,14 @@
 #ifndef SPLASH_SCENE_H
 #define SPLASH_SCENE_H
 
+#include <array>
 #include <atomic>
 #include <cstddef>
+#include <condition_variable>
+#include <deque>
 #include <future>
 #include <list>
+#include <unordered_map>
 #include <vector>
 
 #include "./config.h"
@@ -40,12 +44,16 @@
 #include "./core/spinlock.h"
 #include "./graphics/object_library.h"
 
+#define SPLASH_SCENE_OFFLINE_BUFFER_TIMEOUT 1000000
+
 namespace Splash
 {
 
 class ControllerObject;
+class FrameWriter;
 class Gui;
 class Scene;
+class Window;
 
 /*************/
 //! Scene class, which does the rendering on a given GPU
@@ -59,8 +67,9 @@ class Scene : public RootObject
      * \brief Constructor
      * \param name Scene name
      * \param autoRun If true, the Scene will start without waiting for a start message from the World
+     * \param listenPort If not zero, wait for a World on another host to connect through TCP on this port
      */
-    Scene(const std::string& name = "Splash", const std::string& socketPrefix = "");
+    Scene(const std::string& name = "Splash", const std::string& socketPrefix = "", int listenPort = 0);
 
     /**
      * \brief Destructor
@@ -130,6 +139,18 @@ class Scene : public RootObject
      */
     static bool getHasNVSwapGroup();
 
+    /**
+     * Get whether the Scenes render offscreen, without any display server
+     * \return Return true if headless
+     */
+    static bool isHeadless() { return _headless; }
+
+    /**
+     * Set whether the Scenes render offscreen. This has to be set before any Scene is created
+     * \param headless If true, render offscreen
+     */
+    static void setHeadless(bool headless) { _headless = headless; }
+
     /**
      * Get a reference to the object library
      * \return Return a reference to the object library
@@ -245,10 +266,12 @@ class Scene : public RootObject
     ObjectLibrary _objectLibrary; //!< Library of 3D objects used by multiple GraphObjects
 
     static bool _hasNVSwapGroup; //!< If true, NV swap groups have been detected and are used
+    static bool _headless;       //!< If true, contexts are created through EGL and windows render offscreen
     static std::vector<int> _glVersion;
 
     bool _runInBackground{false}; //!< If true, no window will be created
     bool _started{false};
+    int _linkListenPort{0}; //!< If not zero, the World connects to this Scene through TCP on this port
 
     bool _isMaster{false}; //!< Set to true if this is the master Scene of the current config
     bool _isInitialized{false};
@@ -274,6 +297,65 @@ class Scene : public RootObject
 
     static std::vector<std::string> _ghostableTypes;
 
+    /**
+     * Objects sharing the same rendering priority, as a range in _renderList
+     */
+    struct RenderBatch
+    {
+        GraphObject::Priority priority{GraphObject::Priority::NO_RENDER};
+        Timer::Slot timerSlot{};
+        size_t first{0};
+        size_t last{0};
+    };
+
+    // Render graph, rebuilt only when _renderGraphDirty is set
+    // It does not own the objects, so that disposing of them from _objects still works. Objects are only
+    // removed from _objects by tasks run in the render loop, which marks the graph dirty before rendering
+    std::vector<GraphObject*> _renderList{};   //!< Objects to update and render, sorted by priority
+    std::vector<RenderBatch> _renderBatches{}; //!< Batches of objects in _renderList, by increasing priority
+    std::vector<Window*> _windows{};           //!< Windows to swap at the end of the frame
+
+    /**
+     * GPU timestamp queries around a render batch
+     */
+    struct GpuTraceQuery
+    {
+        uint32_t name{0};
+        GLuint queries[2]{0, 0};
+    };
+
+    /**
+     * Queries issued during a frame, read back when the frame slot is used again
+     */
+    struct GpuTraceFrame
+    {
+        std::vector<GpuTraceQuery> queries{};
+        size_t used{0};
+        int64_t clockOffset{0}; //!< Offset from the GPU clock to Timer::getTime(), in us
+    };
+    std::array<GpuTraceFrame, 2> _gpuTraceFrames{};
+    uint64_t _gpuTraceFrameIndex{0};
+
+    /**
+     * Frame requested by the World when rendering offline, along with the buffers sent for it
+     */
+    struct OfflineFrame
+    {
+        int64_t index{0};
+        Values buffers{};
+    };
+
+    // Offline rendering
+    std::atomic_bool _offlineRendering{false};
+    std::unique_ptr<FrameWriter> _frameWriter{nullptr};              //!< Writes the windows content, created on the render thread
+    std::mutex _offlineFramesMutex{};
+    std::condition_variable _offlineFramesCondition{};
+    std::deque<OfflineFrame> _offlineFrames{};                       //!< Frames requested by the World, not rendered yet
+    std::unordered_map<std::string, uint64_t> _offlineBufferCounts{}; //!< Buffers processed count, per buffer object, at the last frame
+    uint64_t _offlineFrameCount{0};                                  //!< Frames rendered since offline rendering started
+    uint64_t _offlineRenderDuration{0};                              //!< Time spent rendering, in us
+    uint64_t _offlineBufferWaitDuration{0};                          //!< Time spent waiting for the buffers, in us
+
     /**
      * \brief Find which OpenGL version is available (from a predefined list)
      * \return Return MAJOR and MINOR
@@ -318,10 +400,37 @@ class Scene : public RootObject
      */
     void registerAttributes();
 
+    /**
+     * \brief Rebuild the render list and the window list from the objects
+     */
+    void updateRenderGraph();
+
+    /**
+     * \brief Read back the GPU timestamps of an earlier frame, if tracing is enabled
+     */
+    void beginGpuTraceFrame();
+
+    /**
+     * \brief Start measuring the GPU time of a scope, if tracing is enabled
+     * \param name Event name id
+     */
+    void beginGpuTrace(uint32_t name);
+
+    /**
+     * \brief Stop measuring the GPU time of the current scope
+     */
+    void endGpuTrace();
+
     /**
      * \brief Update the various inputs (mouse, keyboard...)
      */
     void updateInputs();
+
+    /**
+     * \brief Render the next frame requested by the World when rendering offline, and hand the windows content to the frame writer
+     * \return Return false if no frame has been requested in time
+     */
+    bool renderOfflineFrame();
 };
 
 } // namespace Splash
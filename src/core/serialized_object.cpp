@@ -0,0 +1,74 @@
+#include "./core/serialized_object.h"
+
+#include <cstring>
+
+#include <snappy.h>
+
+using namespace std;
+
+namespace Splash
+{
+
+/*************/
+shared_ptr<SerializedObject> SerializedObject::compress()
+{
+    if (_compressed)
+        return nullptr;
+
+    // Snappy needs contiguous input
+    if (hasPayload())
+    {
+        auto flattened = *this;
+        flattened.flatten();
+        return flattened.compress();
+    }
+
+    auto compressed = make_shared<SerializedObject>(snappy::MaxCompressedLength(size()));
+    size_t compressedSize = 0;
+    snappy::RawCompress(data(), size(), compressed->data(), &compressedSize);
+
+    // Already compressed data, as Hap frames, barely shrinks and is sent as is
+    if (static_cast<double>(compressedSize) > static_cast<double>(size()) * SPLASH_SERIALIZED_OBJECT_MAX_COMPRESSION_RATIO)
+        return nullptr;
+
+    compressed->resize(compressedSize);
+    compressed->setCompressed(true);
+    return compressed;
+}
+
+/*************/
+void SerializedObject::flatten()
+{
+    if (!hasPayload())
+        return;
+
+    auto dataSize = size();
+    _data.resize(dataSize + _payloadSize);
+    memcpy(_data.data() + dataSize, _payload, _payloadSize);
+
+    _payloadOwner.reset();
+    _payload = nullptr;
+    _payloadSize = 0;
+}
+
+/*************/
+bool SerializedObject::decompress()
+{
+    if (!_compressed)
+        return true;
+
+    // Data comes from the network, it is validated before allocating anything
+    size_t uncompressedSize = 0;
+    if (!snappy::IsValidCompressedBuffer(data(), size()) || !snappy::GetUncompressedLength(data(), size(), &uncompressedSize))
+        return false;
+
+    auto uncompressed = ResizableArray<char>(uncompressedSize);
+    if (!snappy::RawUncompress(data(), size(), uncompressed.data()))
+        return false;
+
+    _data = std::move(uncompressed);
+    _compressed = false;
+    return true;
+}
+
+} // namespace Splash
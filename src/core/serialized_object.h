@@ -25,8 +25,12 @@
 #ifndef SPLASH_SERIALIZED_OBJECT_H
 #define SPLASH_SERIALIZED_OBJECT_H
 
+#include <memory>
+
 #include "./core/resizable_array.h"
 
+#define SPLASH_SERIALIZED_OBJECT_MAX_COMPRESSION_RATIO 0.875
+
 namespace Splash
 {
 
@@ -54,6 +58,15 @@ struct SerializedObject
     {
     }
 
+    /**
+     * \brief Constructor taking ownership of an existing array, which can wrap external memory
+     * \param data Array to take ownership of
+     */
+    SerializedObject(ResizableArray<char>&& data)
+        : _data(std::move(data))
+    {
+    }
+
     /**
      * \brief Get the pointer to the data
      * \return Return a pointer to the data
@@ -78,8 +91,75 @@ struct SerializedObject
      */
     void resize(size_t s) { _data.resize(s); }
 
+    /**
+     * \brief Set a payload following the data, which is shared with its owner instead of being copied
+     * The payload must not be modified as long as the SerializedObject holds it
+     * \param owner Object owning the payload memory, kept alive by the SerializedObject
+     * \param data Pointer to the payload
+     * \param size Payload size
+     */
+    void setPayload(const std::shared_ptr<const void>& owner, const char* data, size_t size)
+    {
+        _payloadOwner = owner;
+        _payload = data;
+        _payloadSize = size;
+    }
+
+    /**
+     * \brief Get whether a payload follows the data
+     * \return Return true if there is a payload
+     */
+    bool hasPayload() const { return _payloadOwner != nullptr; }
+
+    /**
+     * \brief Get the pointer to the payload
+     * \return Return a pointer to the payload, or nullptr
+     */
+    const char* getPayloadData() const { return _payload; }
+
+    /**
+     * \brief Get the size of the payload
+     * \return Return the payload size
+     */
+    size_t getPayloadSize() const { return _payloadSize; }
+
+    /**
+     * \brief Append the payload to the data, releasing the payload owner
+     */
+    void flatten();
+
+    /**
+     * \brief Get whether the data is compressed
+     * \return Return true if the data has to be decompressed before use
+     */
+    bool isCompressed() const { return _compressed; }
+
+    /**
+     * \brief Set whether the data is compressed, for example after receiving it
+     * \param compressed Compression flag
+     */
+    void setCompressed(bool compressed) { _compressed = compressed; }
+
+    /**
+     * \brief Compress the data and the payload with Snappy
+     * \return Return a compressed copy, or nullptr if the data did not compress well enough to be worth it
+     */
+    std::shared_ptr<SerializedObject> compress();
+
+    /**
+     * \brief Decompress the data in place, if it is compressed
+     * \return Return false if the data could not be decompressed
+     */
+    bool decompress();
+
     //! Inner buffer
     ResizableArray<char> _data{};
+    //! True if the inner buffer is compressed
+    bool _compressed{false};
+    //! Optional payload, following the inner buffer
+    std::shared_ptr<const void> _payloadOwner{nullptr};
+    const char* _payload{nullptr};
+    size_t _payloadSize{0};
 };
 
 } // end of namespace
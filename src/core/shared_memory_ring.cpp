@@ -0,0 +1,225 @@
+#include "./core/shared_memory_ring.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "./utils/log.h"
+#include "./utils/timer.h"
+
+using namespace std;
+
+namespace Splash
+{
+
+/*************/
+SharedMemoryRing::Mapping::~Mapping()
+{
+    if (ptr)
+        munmap(ptr, size);
+    if (fd >= 0)
+        close(fd);
+    if (owner)
+        shm_unlink(name.c_str());
+}
+
+/*************/
+SharedMemoryRing::SharedMemoryRing(const string& prefix, uint32_t slotCount)
+    : _prefix(prefix)
+{
+    _slots.resize(slotCount);
+}
+
+/*************/
+SharedMemoryRing::~SharedMemoryRing()
+{
+    // Mappings unlink their segment when destroyed. Readers still mapping them keep them alive
+    _slots.clear();
+}
+
+/*************/
+bool SharedMemoryRing::reserveSlot(uint32_t index, size_t size)
+{
+    auto neededSize = _headerSize + size;
+    auto& slot = _slots[index];
+    if (slot && slot->size >= neededSize)
+        return true;
+
+    // Round up to the next MB, to prevent resizing for every small variation of the buffer size
+    neededSize = ((neededSize >> 20) + 1) << 20;
+
+    if (!slot)
+    {
+        slot = make_shared<Mapping>();
+        slot->name = _prefix + "_" + to_string(index);
+        slot->owner = true;
+        slot->fd = shm_open(slot->name.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+        if (slot->fd < 0)
+        {
+            Log::get() << Log::WARNING << "SharedMemoryRing::" << __FUNCTION__ << " - Unable to create shared memory segment " << slot->name << Log::endl;
+            slot.reset();
+            return false;
+        }
+    }
+
+    // The slot is marked as written to, so readers will not access it while it is remapped
+    if (ftruncate(slot->fd, neededSize) != 0)
+        return false;
+#if HAVE_LINUX
+    // Make sure the memory is really available, otherwise writing to it would raise a SIGBUS
+    if (posix_fallocate(slot->fd, 0, neededSize) != 0)
+    {
+        Log::get() << Log::WARNING << "SharedMemoryRing::" << __FUNCTION__ << " - Not enough shared memory available for a buffer of size " << size << Log::endl;
+        return false;
+    }
+#endif
+
+    auto ptr = mmap(nullptr, neededSize, PROT_READ | PROT_WRITE, MAP_SHARED, slot->fd, 0);
+    if (ptr == MAP_FAILED)
+        return false;
+
+    if (slot->ptr)
+        munmap(slot->ptr, slot->size);
+    slot->ptr = static_cast<char*>(ptr);
+    slot->size = neededSize;
+
+    return true;
+}
+
+/*************/
+bool SharedMemoryRing::write(SerializedObject& buffer, uint32_t readers, Descriptor& descriptor)
+{
+    auto size = buffer.size() + buffer.getPayloadSize();
+    if (size > SPLASH_SHM_RING_MAX_SLOT_SIZE || _prefix.size() >= sizeof(descriptor.segment) - 8)
+        return false;
+
+    lock_guard<mutex> lock(_writeMutex);
+
+    auto now = Timer::getTime();
+    for (uint32_t i = 0; i < _slots.size(); ++i)
+    {
+        auto index = (_nextSlot + i) % _slots.size();
+        auto& slot = _slots[index];
+
+        SlotHeader* header = nullptr;
+        if (slot)
+        {
+            header = slot->header();
+
+            // Readers which were sent the previous descriptor may not have acquired it yet
+            // If they take too long, the message may have been lost (or dropped by the high water mark)
+            if (header->pending.load(memory_order_acquire) != 0 && now - header->timestamp < SPLASH_SHM_RING_PENDING_TIMEOUT)
+                continue;
+
+            uint32_t expected = 0;
+            if (!header->readers.compare_exchange_strong(expected, _writingFlag, memory_order_acq_rel))
+                continue;
+        }
+
+        if (!reserveSlot(index, size))
+        {
+            if (header)
+                header->readers.store(0, memory_order_release);
+            return false;
+        }
+
+        // The slot may have been created or remapped
+        if (!header)
+        {
+            header = slot->header();
+            header->readers.store(_writingFlag, memory_order_release);
+        }
+        else
+        {
+            header = slot->header();
+        }
+
+        memcpy(slot->ptr + _headerSize, buffer.data(), buffer.size());
+        if (buffer.hasPayload())
+            memcpy(slot->ptr + _headerSize + buffer.size(), buffer.getPayloadData(), buffer.getPayloadSize());
+        header->size = size;
+        header->timestamp = now;
+        header->pending.store(readers, memory_order_release);
+        header->sequence.store(++_sequence, memory_order_release);
+        header->readers.store(0, memory_order_release);
+
+        memset(descriptor.segment, 0, sizeof(descriptor.segment));
+        memcpy(descriptor.segment, slot->name.c_str(), slot->name.size());
+        descriptor.slot = index;
+        descriptor.sequence = _sequence;
+        descriptor.size = size;
+
+        _nextSlot = (index + 1) % _slots.size();
+        return true;
+    }
+
+    return false;
+}
+
+/*************/
+shared_ptr<SharedMemoryRing::Mapping> SharedMemoryRing::getReadMapping(const string& name, size_t size)
+{
+    lock_guard<mutex> lock(_readMutex);
+
+    auto mappingIt = _readMappings.find(name);
+    if (mappingIt != _readMappings.end() && mappingIt->second->size >= size)
+        return mappingIt->second;
+
+    // The segment does not exist yet or grew since it was last mapped. Buffers still using
+    // the previous mapping keep it alive until they are released
+    auto mapping = make_shared<Mapping>();
+    mapping->name = name;
+    mapping->fd = shm_open(name.c_str(), O_RDWR, S_IRUSR | S_IWUSR);
+    if (mapping->fd < 0)
+        return {};
+
+    struct stat segmentStat;
+    if (fstat(mapping->fd, &segmentStat) != 0 || static_cast<size_t>(segmentStat.st_size) < size)
+        return {};
+
+    auto ptr = mmap(nullptr, segmentStat.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, mapping->fd, 0);
+    if (ptr == MAP_FAILED)
+        return {};
+
+    mapping->ptr = static_cast<char*>(ptr);
+    mapping->size = segmentStat.st_size;
+    _readMappings[name] = mapping;
+
+    return mapping;
+}
+
+/*************/
+shared_ptr<SerializedObject> SharedMemoryRing::read(const Descriptor& descriptor)
+{
+    auto name = string(descriptor.segment, strnlen(descriptor.segment, sizeof(descriptor.segment)));
+    auto mapping = getReadMapping(name, _headerSize + descriptor.size);
+    if (!mapping)
+        return {};
+
+    auto header = mapping->header();
+    auto readers = header->readers.load(memory_order_acquire);
+    do
+    {
+        if (readers & _writingFlag)
+            return {};
+    } while (!header->readers.compare_exchange_weak(readers, readers + 1, memory_order_acq_rel));
+
+    // The slot has been reused since the descriptor was sent, a newer buffer is on its way
+    if (header->sequence.load(memory_order_acquire) != descriptor.sequence || header->size != descriptor.size)
+    {
+        header->readers.fetch_sub(1, memory_order_acq_rel);
+        return {};
+    }
+
+    auto pending = header->pending.load(memory_order_acquire);
+    while (pending > 0 && !header->pending.compare_exchange_weak(pending, pending - 1, memory_order_acq_rel))
+        ;
+
+    // The buffer points directly to the shared memory, and releases the slot when it is not needed anymore
+    auto data = mapping->ptr + _headerSize;
+    auto array = ResizableArray<char>(data, data + descriptor.size, [mapping](char*) { mapping->header()->readers.fetch_sub(1, memory_order_acq_rel); });
+    return make_shared<SerializedObject>(std::move(array));
+}
+
+} // namespace Splash
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2018 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @shared_memory_ring.h
+ * Ring of shared memory slots, used by the Link to send buffers to other processes without copying them through sockets
+ */
+
+#ifndef SPLASH_SHARED_MEMORY_RING_H
+#define SPLASH_SHARED_MEMORY_RING_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "./config.h"
+#include "./core/serialized_object.h"
+
+#define SPLASH_SHM_RING_SLOTS 32
+#define SPLASH_SHM_RING_MAX_SLOT_SIZE (1ull << 30)
+#define SPLASH_SHM_RING_PENDING_TIMEOUT 1000000
+
+namespace Splash
+{
+
+/*************/
+class SharedMemoryRing
+{
+  public:
+    /**
+     * Descriptor of a buffer written in the ring, sent to the readers instead of the buffer itself
+     */
+    struct Descriptor
+    {
+        char segment[64]{};   //!< Name of the shared memory segment holding the slot
+        uint32_t slot{0};     //!< Slot index, for information purpose
+        uint64_t sequence{0}; //!< Sequence number of the buffer, to check that the slot was not reused
+        uint64_t size{0};     //!< Size of the buffer
+    };
+
+    /**
+     * Header placed at the beginning of each slot, in shared memory
+     */
+    struct SlotHeader
+    {
+        std::atomic_uint readers{0};    //!< Number of readers currently using the slot, or _writingFlag while written to
+        std::atomic_uint pending{0};    //!< Number of readers which did not acquire the slot yet
+        std::atomic_ullong sequence{0}; //!< Sequence number of the buffer currently in the slot
+        uint64_t size{0};               //!< Size of the buffer currently in the slot
+        int64_t timestamp{0};           //!< Time at which the buffer was written, in us
+    };
+
+    static const uint32_t _writingFlag{0x80000000};
+    static const size_t _headerSize{64};
+
+    /**
+     * \brief Constructor
+     * \param prefix Prefix for the shared memory segments names
+     * \param slotCount Number of slots in the ring
+     */
+    SharedMemoryRing(const std::string& prefix, uint32_t slotCount = SPLASH_SHM_RING_SLOTS);
+
+    /**
+     * \brief Destructor, unlinks all shared memory segments
+     */
+    ~SharedMemoryRing();
+
+    SharedMemoryRing(const SharedMemoryRing&) = delete;
+    SharedMemoryRing& operator=(const SharedMemoryRing&) = delete;
+
+    /**
+     * \brief Copy the given buffer, followed by its payload, in the next free slot
+     * \param buffer Buffer to write
+     * \param readers Number of readers which will receive the descriptor
+     * \param descriptor Descriptor to send to the readers
+     * \return Return false if no slot was available, in which case the buffer has to be sent by other means
+     */
+    bool write(SerializedObject& buffer, uint32_t readers, Descriptor& descriptor);
+
+    /**
+     * \brief Get a buffer from its descriptor. The returned object maps the slot directly, and releases it when destroyed
+     * \param descriptor Descriptor received from the writer
+     * \return Return the buffer, or nullptr if the slot has been reused in the meantime
+     */
+    std::shared_ptr<SerializedObject> read(const Descriptor& descriptor);
+
+  private:
+    struct Mapping
+    {
+        ~Mapping();
+        std::string name{""};
+        int fd{-1};
+        size_t size{0};
+        char* ptr{nullptr};
+        bool owner{false};
+        SlotHeader* header() const { return reinterpret_cast<SlotHeader*>(ptr); }
+    };
+
+    std::string _prefix{""};
+    std::vector<std::shared_ptr<Mapping>> _slots{};
+    uint32_t _nextSlot{0};
+    uint64_t _sequence{0};
+    std::mutex _writeMutex{};
+
+    std::map<std::string, std::shared_ptr<Mapping>> _readMappings{};
+    std::mutex _readMutex{};
+
+    /**
+     * \brief Create or resize the shared memory segment for the given slot
+     * \param index Slot index
+     * \param size Minimum data size for the slot
+     * \return Return true if the slot is usable
+     */
+    bool reserveSlot(uint32_t index, size_t size);
+
+    /**
+     * \brief Get the mapping for the given segment, remapping it if it is smaller than needed
+     * \param name Segment name
+     * \param size Minimum mapped size
+     * \return Return the mapping, or nullptr if it could not be opened
+     */
+    std::shared_ptr<Mapping> getReadMapping(const std::string& name, size_t size);
+};
+
+} // namespace Splash
+
+#endif // SPLASH_SHARED_MEMORY_RING_H
@@ -0,0 +1,416 @@
+/*
+ * Copyright (C) 2018 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @small_vector.h
+ * Contiguous container storing its first elements inline, to avoid heap allocations for small sizes
+ */
+
+#ifndef SPLASH_SMALL_VECTOR_H
+#define SPLASH_SMALL_VECTOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace Splash
+{
+
+/*************/
+/**
+ * Vector holding up to N elements without allocating. It grows on the heap past
+ * that, and never goes back to the inline storage once it has.
+ * Besides the vector interface, it offers push_front / pop_front so that it can
+ * stand in for a deque. Unlike a deque, they shift all the elements, and any
+ * insertion, including at the end, may invalidate references. Values are short
+ * and built locally before being sent, which is where these are used.
+ */
+template <typename T, size_t N>
+class SmallVector
+{
+    static_assert(N > 0, "SmallVector needs an inline capacity of at least one element");
+
+  public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    /**
+     * \brief Constructors
+     */
+    SmallVector() = default;
+
+    explicit SmallVector(size_type count) { resize(count); }
+
+    SmallVector(size_type count, const T& value) { resize(count, value); }
+
+    template <class InputIt, typename std::enable_if<!std::is_integral<InputIt>::value>::type* = nullptr>
+    SmallVector(InputIt first, InputIt last)
+    {
+        insert(end(), first, last);
+    }
+
+    SmallVector(std::initializer_list<T> init) { insert(end(), init.begin(), init.end()); }
+
+    SmallVector(const SmallVector& other)
+    {
+        reserve(other._size);
+        for (const auto& value : other)
+            new (data() + _size++) T(value);
+    }
+
+    SmallVector(SmallVector&& other) noexcept { moveFrom(std::move(other)); }
+
+    /**
+     * \brief Destructor
+     */
+    ~SmallVector()
+    {
+        clear();
+        if (_heap)
+            ::operator delete(_heap);
+    }
+
+    /**
+     * \brief Assignment operators
+     */
+    SmallVector& operator=(const SmallVector& other)
+    {
+        if (this != &other)
+            assign(other.begin(), other.end());
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept
+    {
+        if (this != &other)
+        {
+            clear();
+            if (_heap)
+            {
+                ::operator delete(_heap);
+                _heap = nullptr;
+                _capacity = N;
+            }
+            moveFrom(std::move(other));
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(std::initializer_list<T> init)
+    {
+        assign(init.begin(), init.end());
+        return *this;
+    }
+
+    template <class InputIt, typename std::enable_if<!std::is_integral<InputIt>::value>::type* = nullptr>
+    void assign(InputIt first, InputIt last)
+    {
+        clear();
+        insert(end(), first, last);
+    }
+
+    void assign(size_type count, const T& value)
+    {
+        clear();
+        resize(count, value);
+    }
+
+    /**
+     * \brief Element access
+     */
+    reference at(size_type index)
+    {
+        if (index >= _size)
+            throw std::out_of_range("SmallVector::at - Index out of range");
+        return data()[index];
+    }
+
+    const_reference at(size_type index) const
+    {
+        if (index >= _size)
+            throw std::out_of_range("SmallVector::at - Index out of range");
+        return data()[index];
+    }
+
+    reference operator[](size_type index) { return data()[index]; }
+    const_reference operator[](size_type index) const { return data()[index]; }
+
+    reference front() { return data()[0]; }
+    const_reference front() const { return data()[0]; }
+    reference back() { return data()[_size - 1]; }
+    const_reference back() const { return data()[_size - 1]; }
+
+    T* data() { return _heap ? _heap : reinterpret_cast<T*>(&_inline); }
+    const T* data() const { return _heap ? _heap : reinterpret_cast<const T*>(&_inline); }
+
+    /**
+     * \brief Iterators
+     */
+    iterator begin() { return data(); }
+    const_iterator begin() const { return data(); }
+    const_iterator cbegin() const { return data(); }
+    iterator end() { return data() + _size; }
+    const_iterator end() const { return data() + _size; }
+    const_iterator cend() const { return data() + _size; }
+
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator crbegin() const { return const_reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+    const_reverse_iterator crend() const { return const_reverse_iterator(begin()); }
+
+    /**
+     * \brief Capacity
+     */
+    bool empty() const { return _size == 0; }
+    size_type size() const { return _size; }
+    size_type max_size() const { return static_cast<size_type>(-1) / sizeof(T); }
+    size_type capacity() const { return _capacity; }
+
+    /**
+     * \brief Check whether the elements are stored inline
+     * \return Return true if no heap storage is used
+     */
+    bool isInline() const { return _heap == nullptr; }
+
+    void reserve(size_type capacity)
+    {
+        if (capacity > _capacity)
+            grow(capacity);
+    }
+
+    /**
+     * \brief Modifiers
+     */
+    void clear()
+    {
+        auto values = data();
+        for (size_type i = 0; i < _size; ++i)
+            values[i].~T();
+        _size = 0;
+    }
+
+    template <class... Args>
+    reference emplace_back(Args&&... args)
+    {
+        if (_size == _capacity)
+        {
+            // Built before growing, as the arguments may refer to an element of this container
+            T value(std::forward<Args>(args)...);
+            grow(_capacity * 2);
+            new (data() + _size) T(std::move(value));
+        }
+        else
+        {
+            new (data() + _size) T(std::forward<Args>(args)...);
+        }
+        ++_size;
+        return back();
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    void pop_back()
+    {
+        --_size;
+        data()[_size].~T();
+    }
+
+    template <class... Args>
+    iterator emplace(const_iterator pos, Args&&... args)
+    {
+        auto index = pos - cbegin();
+        emplace_back(std::forward<Args>(args)...);
+        std::rotate(begin() + index, end() - 1, end());
+        return begin() + index;
+    }
+
+    iterator insert(const_iterator pos, const T& value) { return emplace(pos, value); }
+    iterator insert(const_iterator pos, T&& value) { return emplace(pos, std::move(value)); }
+
+    iterator insert(const_iterator pos, size_type count, const T& value)
+    {
+        auto index = pos - cbegin();
+        auto previousSize = _size;
+        resize(_size + count, value);
+        std::rotate(begin() + index, begin() + previousSize, end());
+        return begin() + index;
+    }
+
+    template <class InputIt, typename std::enable_if<!std::is_integral<InputIt>::value>::type* = nullptr>
+    iterator insert(const_iterator pos, InputIt first, InputIt last)
+    {
+        // New elements are appended, then rotated in place
+        auto index = pos - cbegin();
+        auto previousSize = _size;
+        for (auto it = first; it != last; ++it)
+            emplace_back(*it);
+        std::rotate(begin() + index, begin() + previousSize, end());
+        return begin() + index;
+    }
+
+    iterator insert(const_iterator pos, std::initializer_list<T> init) { return insert(pos, init.begin(), init.end()); }
+
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        auto firstIt = begin() + (first - cbegin());
+        auto lastIt = begin() + (last - cbegin());
+        if (firstIt == lastIt)
+            return firstIt;
+
+        auto newEnd = std::move(lastIt, end(), firstIt);
+        for (auto it = newEnd; it != end(); ++it)
+            it->~T();
+        _size = newEnd - begin();
+        return firstIt;
+    }
+
+    template <class... Args>
+    reference emplace_front(Args&&... args)
+    {
+        return *emplace(cbegin(), std::forward<Args>(args)...);
+    }
+
+    // Linear in the size, prefer a single insert at the front over repeated calls
+    void push_front(const T& value) { emplace(cbegin(), value); }
+    void push_front(T&& value) { emplace(cbegin(), std::move(value)); }
+    void pop_front() { erase(cbegin()); }
+
+    void resize(size_type count)
+    {
+        if (count < _size)
+        {
+            erase(cbegin() + count, cend());
+            return;
+        }
+        reserve(count);
+        while (_size < count)
+            new (data() + _size++) T();
+    }
+
+    void resize(size_type count, const T& value)
+    {
+        if (count < _size)
+        {
+            erase(cbegin() + count, cend());
+            return;
+        }
+        if (count > _capacity)
+        {
+            // Copied first, as value may be an element of this container
+            T copy(value);
+            grow(count);
+            while (_size < count)
+                new (data() + _size++) T(copy);
+            return;
+        }
+        while (_size < count)
+            new (data() + _size++) T(value);
+    }
+
+    void swap(SmallVector& other)
+    {
+        SmallVector tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    /**
+     * \brief Comparison operators
+     */
+    bool operator==(const SmallVector& other) const { return _size == other._size && std::equal(begin(), end(), other.begin()); }
+    bool operator!=(const SmallVector& other) const { return !operator==(other); }
+    bool operator<(const SmallVector& other) const { return std::lexicographical_compare(begin(), end(), other.begin(), other.end()); }
+    bool operator>(const SmallVector& other) const { return other < *this; }
+    bool operator<=(const SmallVector& other) const { return !(other < *this); }
+    bool operator>=(const SmallVector& other) const { return !(*this < other); }
+
+  private:
+    T* _heap{nullptr};                                                     //!< Heap storage, if the inline one is exceeded
+    size_type _size{0};                                                    //!< Number of elements
+    size_type _capacity{N};                                                //!< Number of elements which can be stored without growing
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type _inline[N]; //!< Inline storage
+
+    /**
+     * \brief Move the storage to the heap, with at least the given capacity
+     * \param capacity Minimum capacity
+     */
+    void grow(size_type capacity)
+    {
+        capacity = std::max(capacity, _capacity * 2);
+        auto storage = static_cast<T*>(::operator new(capacity * sizeof(T)));
+        auto values = data();
+        for (size_type i = 0; i < _size; ++i)
+        {
+            new (storage + i) T(std::move(values[i]));
+            values[i].~T();
+        }
+
+        if (_heap)
+            ::operator delete(_heap);
+        _heap = storage;
+        _capacity = capacity;
+    }
+
+    /**
+     * \brief Take the elements of another container, this one being empty and inline
+     * \param other Container to move from
+     */
+    void moveFrom(SmallVector&& other)
+    {
+        if (other._heap)
+        {
+            _heap = other._heap;
+            _size = other._size;
+            _capacity = other._capacity;
+            other._heap = nullptr;
+            other._size = 0;
+            other._capacity = N;
+            return;
+        }
+
+        auto values = other.data();
+        for (size_type i = 0; i < other._size; ++i)
+            new (data() + i) T(std::move(values[i]));
+        _size = other._size;
+        other.clear();
+    }
+};
+
+} // namespace Splash
+
+#endif // SPLASH_SMALL_VECTOR_H
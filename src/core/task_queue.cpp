@@ -0,0 +1,96 @@
+#include "./core/task_queue.h"
+
+#include <memory>
+
+using namespace std;
+
+namespace Splash
+{
+
+/*************/
+TaskQueue::~TaskQueue()
+{
+    auto node = _head.exchange(nullptr, memory_order_acquire);
+    while (node)
+    {
+        auto next = node->next;
+        delete node;
+        node = next;
+    }
+}
+
+/*************/
+void TaskQueue::push(Task&& task, const string& key)
+{
+    auto node = new Node();
+    node->task = std::move(task);
+    node->key = key;
+
+    node->next = _head.load(memory_order_relaxed);
+    while (!_head.compare_exchange_weak(node->next, node, memory_order_release, memory_order_relaxed))
+        continue;
+}
+
+/*************/
+uint32_t TaskQueue::run()
+{
+    // Other threads wait for the current run to finish, so that returning from run()
+    // always means the tasks queued before the call have been run
+    lock_guard<recursive_mutex> lock(_runMutex);
+
+    // The stack is walked from the newest task, which is where coalesced tasks are dropped,
+    // and reversed on the way to run the tasks in order
+    auto node = _head.exchange(nullptr, memory_order_acquire);
+    Node* first = nullptr;
+    while (node)
+    {
+        auto next = node->next;
+        if (!node->key.empty() && !_coalescedKeys.insert(node->key).second)
+            node->task = nullptr;
+        node->next = first;
+        first = node;
+        node = next;
+    }
+    _coalescedKeys.clear();
+
+    uint32_t taskCount = 0;
+    try
+    {
+        while (first)
+        {
+            auto current = unique_ptr<Node>(first);
+            first = first->next;
+            if (current->task)
+            {
+                current->task();
+                ++taskCount;
+            }
+        }
+    }
+    catch (...)
+    {
+        // The tasks which did not run are put back in the queue, to be run by the next call
+        Node* remaining = nullptr;
+        Node* last = first;
+        while (first)
+        {
+            auto next = first->next;
+            first->next = remaining;
+            remaining = first;
+            first = next;
+        }
+
+        if (last)
+        {
+            last->next = _head.load(memory_order_relaxed);
+            while (!_head.compare_exchange_weak(last->next, remaining, memory_order_release, memory_order_relaxed))
+                continue;
+        }
+
+        throw;
+    }
+
+    return taskCount;
+}
+
+} // end of namespace
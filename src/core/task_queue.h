@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2018 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @task_queue.h
+ * Lock-free queue of tasks, filled from any thread and run by one thread at a time
+ */
+
+#ifndef SPLASH_TASK_QUEUE_H
+#define SPLASH_TASK_QUEUE_H
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+namespace Splash
+{
+
+/*************/
+/**
+ * Producers push tasks on a lock-free stack, the consumer takes the whole stack
+ * at once and runs it in the order the tasks were pushed.
+ * Tasks can be given a coalescing key: among the tasks sharing a key and waiting
+ * to be run, only the latest one is run, at its own position in the queue.
+ */
+class TaskQueue
+{
+  public:
+    using Task = std::function<void()>;
+
+    /**
+     * \brief Constructor
+     */
+    TaskQueue() = default;
+
+    /**
+     * \brief Destructor, drops the tasks which were not run
+     */
+    ~TaskQueue();
+
+    TaskQueue(const TaskQueue&) = delete;
+    TaskQueue& operator=(const TaskQueue&) = delete;
+
+    /**
+     * \brief Add a task to the queue, never blocks
+     * \param task Task to run, moved into the queue
+     * \param key Coalescing key, or an empty string to always run the task
+     */
+    void push(Task&& task, const std::string& key = "");
+
+    /**
+     * \brief Check whether some tasks are waiting
+     * \return Return true if the queue is empty
+     */
+    bool empty() const { return _head.load(std::memory_order_acquire) == nullptr; }
+
+    /**
+     * \brief Run the tasks queued so far. Tasks pushed while running are left for the next call
+     * If another thread is already running the queue, blocks until it is done. Can be called from a task
+     * \return Return the number of tasks which have been run
+     */
+    uint32_t run();
+
+  private:
+    struct Node
+    {
+        Task task{};
+        std::string key{};
+        Node* next{nullptr};
+    };
+
+    std::atomic<Node*> _head{nullptr};
+    std::recursive_mutex _runMutex{};
+    std::unordered_set<std::string> _coalescedKeys{}; //!< Keys met while running, only accessed by the consumer
+};
+
+} // end of namespace
+
+#endif // SPLASH_TASK_QUEUE_H
@@ -0,0 +1,215 @@
+#include "./core/thread_pool.h"
+
+#include <algorithm>
+#include <sched.h>
+
+#include "./utils/log.h"
+
+using namespace std;
+
+namespace Splash
+{
+
+thread_local ThreadPool* ThreadPool::_currentPool{nullptr};
+thread_local uint32_t ThreadPool::_currentWorker{0};
+
+/*************/
+ThreadPool::ThreadPool(uint32_t workerCount)
+{
+    if (workerCount == 0)
+        workerCount = getAvailableCoreCount();
+    workerCount = max(1u, min(workerCount, static_cast<uint32_t>(SPLASH_THREAD_POOL_MAX_WORKERS)));
+
+    // All queues have to exist before starting the workers, as they steal from each other
+    for (uint32_t i = 0; i < workerCount; ++i)
+        _workers.emplace_back(new Worker());
+    for (uint32_t i = 0; i < workerCount; ++i)
+        _workers[i]->thread = thread([this, i]() { workerLoop(i); });
+}
+
+/*************/
+ThreadPool::~ThreadPool()
+{
+    {
+        lock_guard<mutex> lockSleep(_sleepMutex);
+        _stop = true;
+    }
+    _sleepCondition.notify_all();
+
+    for (auto& worker : _workers)
+        if (worker->thread.joinable())
+            worker->thread.join();
+}
+
+/*************/
+void ThreadPool::run(Task&& task)
+{
+    // Tasks queued from a worker stay on its queue, others are spread over all workers
+    uint32_t index = 0;
+    if (_currentPool == this)
+        index = _currentWorker;
+    else
+        index = _nextWorker.fetch_add(1, memory_order_relaxed) % _workers.size();
+
+    // The counter is incremented first, so that it is never lower than the actual number of queued tasks
+    _queued.fetch_add(1, memory_order_acq_rel);
+    {
+        auto& worker = _workers[index];
+        lock_guard<Spinlock> lockQueue(worker->queueMutex);
+        worker->queue.push_back(std::move(task));
+    }
+
+    {
+        lock_guard<mutex> lockSleep(_sleepMutex);
+    }
+    _sleepCondition.notify_one();
+}
+
+/*************/
+bool ThreadPool::runPendingTask()
+{
+    Task task;
+    auto index = _currentPool == this ? _currentWorker : _nextWorker.load(memory_order_relaxed) % _workers.size();
+    if (!popTask(index, task))
+        return false;
+
+    try
+    {
+        task();
+    }
+    catch (const exception& e)
+    {
+        Log::get() << Log::WARNING << "ThreadPool::" << __FUNCTION__ << " - Exception caught while running a task: " << e.what() << Log::endl;
+    }
+    catch (...)
+    {
+        Log::get() << Log::WARNING << "ThreadPool::" << __FUNCTION__ << " - Unknown exception caught while running a task" << Log::endl;
+    }
+    _executed.fetch_add(1, memory_order_relaxed);
+
+    return true;
+}
+
+/*************/
+ThreadPool::Stats ThreadPool::getStats() const
+{
+    Stats stats;
+    stats.workers = _workers.size();
+    stats.queued = _queued.load(memory_order_acquire);
+    stats.executed = _executed.load(memory_order_relaxed);
+    stats.stolen = _stolen.load(memory_order_relaxed);
+    return stats;
+}
+
+/*************/
+uint32_t ThreadPool::getAvailableCoreCount()
+{
+#if HAVE_LINUX
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        return CPU_COUNT(&set);
+#endif
+    return thread::hardware_concurrency();
+}
+
+/*************/
+bool ThreadPool::popTask(uint32_t workerIndex, Task& task)
+{
+    if (_queued.load(memory_order_acquire) == 0)
+        return false;
+
+    // The worker own queue is used as a stack, the most recent tasks having the warmest data
+    if (_currentPool == this)
+    {
+        auto& worker = _workers[workerIndex];
+        lock_guard<Spinlock> lockQueue(worker->queueMutex);
+        if (!worker->queue.empty())
+        {
+            task = std::move(worker->queue.back());
+            worker->queue.pop_back();
+            _queued.fetch_sub(1, memory_order_acq_rel);
+            return true;
+        }
+    }
+
+    // Other queues are stolen from in FIFO order
+    for (uint32_t i = 0; i < _workers.size(); ++i)
+    {
+        auto& worker = _workers[(workerIndex + i) % _workers.size()];
+        if (_currentPool == this && worker.get() == _workers[workerIndex].get())
+            continue;
+
+        lock_guard<Spinlock> lockQueue(worker->queueMutex);
+        if (!worker->queue.empty())
+        {
+            task = std::move(worker->queue.front());
+            worker->queue.pop_front();
+            _queued.fetch_sub(1, memory_order_acq_rel);
+            _stolen.fetch_add(1, memory_order_relaxed);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*************/
+void ThreadPool::workerLoop(uint32_t workerIndex)
+{
+    _currentPool = this;
+    _currentWorker = workerIndex;
+
+    while (!_stop)
+    {
+        if (runPendingTask())
+            continue;
+
+        unique_lock<mutex> lockSleep(_sleepMutex);
+        _sleepCondition.wait(lockSleep, [&]() { return _stop || _queued.load(memory_order_acquire) != 0; });
+    }
+}
+
+/*************/
+void TaskGroup::run(function<void()>&& task)
+{
+    _pending.fetch_add(1, memory_order_acq_rel);
+    _pool.run([this, task = std::move(task)]() {
+        // The group is notified even if the task throws, otherwise waiting for it would never end
+        auto finish = [this]() {
+            lock_guard<mutex> lockDone(_doneMutex);
+            if (_pending.fetch_sub(1, memory_order_acq_rel) == 1)
+                _doneCondition.notify_all();
+        };
+
+        try
+        {
+            task();
+        }
+        catch (...)
+        {
+            finish();
+            throw;
+        }
+        finish();
+    });
+}
+
+/*************/
+void TaskGroup::wait()
+{
+    while (_pending.load(memory_order_acquire) != 0)
+    {
+        if (_pool.runPendingTask())
+            continue;
+
+        // Nothing left to help with, the remaining tasks are running on other threads
+        unique_lock<mutex> lockDone(_doneMutex);
+        _doneCondition.wait_for(lockDone, chrono::milliseconds(1), [&]() { return _pending.load(memory_order_acquire) == 0; });
+    }
+
+    // The last task notifies while holding the mutex, it must be released before the group can be destroyed
+    lock_guard<mutex> lockDone(_doneMutex);
+}
+
+} // end of namespace
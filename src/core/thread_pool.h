@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2018 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @thread_pool.h
+ * Persistent pool of worker threads, with work stealing, to run short tasks without spawning threads
+ */
+
+#ifndef SPLASH_THREAD_POOL_H
+#define SPLASH_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "./config.h"
+#include "./core/spinlock.h"
+
+#define SPLASH_THREAD_POOL_MAX_WORKERS 64
+
+namespace Splash
+{
+
+/*************/
+/**
+ * Each worker has its own queue. It runs its own tasks in LIFO order, to keep
+ * caches warm, and steals the oldest tasks of the other workers when idle.
+ * Tasks submitted from other threads are spread over the workers queues.
+ * Tasks are expected to be short: long running loops should keep their own thread.
+ */
+class ThreadPool
+{
+  public:
+    using Task = std::function<void()>;
+
+    struct Stats
+    {
+        uint32_t workers{0};  //!< Number of worker threads
+        uint64_t queued{0};   //!< Number of tasks waiting to be run
+        uint64_t executed{0}; //!< Number of tasks run since the creation of the pool
+        uint64_t stolen{0};   //!< Number of tasks run by another worker than the one they were queued to
+    };
+
+    /**
+     * \brief Get the shared pool, sized after the cores available to the process
+     * \return Return the pool
+     */
+    static ThreadPool& get()
+    {
+        // The pool is never destroyed, as tasks may still be submitted by static objects at exit
+        static auto instance = new ThreadPool;
+        return *instance;
+    }
+
+    /**
+     * \brief Constructor
+     * \param workerCount Number of workers, or 0 to use one worker per available core
+     */
+    explicit ThreadPool(uint32_t workerCount = 0);
+
+    /**
+     * \brief Destructor, waits for the running tasks and drops the queued ones
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * \brief Queue a task
+     * \param task Task to run
+     */
+    void run(Task&& task);
+
+    /**
+     * \brief Queue a task and get a future to its result
+     * Do not wait for the future from inside a task, use a TaskGroup instead
+     * \param func Function to run
+     * \return Return a future holding the result of func
+     */
+    template <typename F>
+    auto submit(F&& func) -> std::future<decltype(func())>
+    {
+        using ResultType = decltype(func());
+        auto task = std::make_shared<std::packaged_task<ResultType()>>(std::forward<F>(func));
+        auto future = task->get_future();
+        run([task]() { (*task)(); });
+        return future;
+    }
+
+    /**
+     * \brief Run a single queued task from the calling thread, if any, to help while waiting
+     * \return Return true if a task has been run
+     */
+    bool runPendingTask();
+
+    /**
+     * \brief Get the pool counters
+     * \return Return the counters
+     */
+    Stats getStats() const;
+
+    /**
+     * \brief Get the number of workers
+     * \return Return the worker count
+     */
+    uint32_t getWorkerCount() const { return static_cast<uint32_t>(_workers.size()); }
+
+  private:
+    struct Worker
+    {
+        Spinlock queueMutex{};
+        std::deque<Task> queue{};
+        std::thread thread{};
+    };
+
+    static thread_local ThreadPool* _currentPool; //!< Pool the current thread is a worker of, if any
+    static thread_local uint32_t _currentWorker;  //!< Index of the current worker in its pool
+
+    std::vector<std::unique_ptr<Worker>> _workers{};
+    std::atomic_uint _nextWorker{0};
+    std::atomic_bool _stop{false};
+
+    std::mutex _sleepMutex{};
+    std::condition_variable _sleepCondition{};
+
+    std::atomic_ullong _queued{0};
+    std::atomic_ullong _executed{0};
+    std::atomic_ullong _stolen{0};
+
+    /**
+     * \brief Get the number of cores the process is allowed to run on
+     * \return Return the core count
+     */
+    static uint32_t getAvailableCoreCount();
+
+    /**
+     * \brief Pop a task, from the given worker queue first, then from the others
+     * \param workerIndex Index of the worker to pop from first
+     * \param task Popped task
+     * \return Return true if a task was found
+     */
+    bool popTask(uint32_t workerIndex, Task& task);
+
+    /**
+     * \brief Worker loop
+     * \param workerIndex Index of the worker
+     */
+    void workerLoop(uint32_t workerIndex);
+};
+
+/*************/
+/**
+ * Set of tasks run on a ThreadPool, which can be waited for as a whole.
+ * The waiting thread runs queued tasks while waiting, so groups can be nested
+ * and waited for from inside a task without starving the pool.
+ */
+class TaskGroup
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param pool Pool to run the tasks on
+     */
+    explicit TaskGroup(ThreadPool& pool = ThreadPool::get())
+        : _pool(pool)
+    {
+    }
+
+    /**
+     * \brief Destructor, waits for all the tasks to finish
+     */
+    ~TaskGroup() { wait(); }
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    /**
+     * \brief Run a task as part of the group
+     * \param task Task to run
+     */
+    void run(std::function<void()>&& task);
+
+    /**
+     * \brief Wait for all the tasks of the group to finish
+     */
+    void wait();
+
+  private:
+    ThreadPool& _pool;
+    std::atomic_uint _pending{0};
+    std::mutex _doneMutex{};
+    std::condition_variable _doneCondition{};
+};
+
+} // end of namespace
+
+#endif // SPLASH_THREAD_POOL_H
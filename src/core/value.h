@@ -25,17 +25,27 @@
 #ifndef SPLASH_VALUE_H
 #define SPLASH_VALUE_H
 
-#include <deque>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <utility>
+
+#include "./core/small_vector.h"
+
+#define SPLASH_VALUES_INLINE_SIZE 4
 
 namespace Splash
 {
 
 struct Value;
-using Values = std::deque<Value>;
+using Values = SmallVector<Value, SPLASH_VALUES_INLINE_SIZE>;
 
 /*************/
+/**
+ * Tagged union holding either an integer, a real, a string or a list of values.
+ * Only the active member is constructed, and the name is allocated only if set,
+ * so that numeric values do not allocate at all.
+ */
 struct Value
 {
   public:
@@ -47,69 +57,96 @@ struct Value
         values       // values
     };
 
-    Value() = default;
+    Value()
+        : _integer(0)
+    {
+    }
 
     template <class T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
     Value(const T& v, const std::string& name = "")
-        : _name(name)
-        , _type(Type::integer)
+        : _type(Type::integer)
         , _integer(v)
     {
+        setName(name);
     }
 
     template <class T, typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
     Value(const T& v, const std::string& name = "")
-        : _name(name)
-        , _type(Type::real)
+        : _type(Type::real)
         , _real(v)
     {
+        setName(name);
     }
 
     template <class T, typename std::enable_if<std::is_same<T, std::string>::value>::type* = nullptr>
     Value(const T& v, const std::string& name = "")
-        : _name(name)
-        , _type(Type::string)
+        : _type(Type::string)
         , _string(v)
     {
+        setName(name);
+    }
+
+    Value(std::string&& v, const std::string& name = "")
+        : _type(Type::string)
+        , _string(std::move(v))
+    {
+        setName(name);
     }
 
     template <class T, typename std::enable_if<std::is_same<T, const char*>::value>::type* = nullptr>
     Value(T c, const std::string& name = "")
-        : _name(name)
-        , _type(Type::string)
+        : _type(Type::string)
         , _string(c)
     {
+        setName(name);
     }
 
     template <class T, typename std::enable_if<std::is_same<T, Values>::value>::type* = nullptr>
     Value(const T& v, const std::string& name = "")
-        : _name(name)
-        , _type(Type::values)
-        , _values(std::make_unique<Values>(v))
+        : _type(Type::values)
+        , _values(new Values(v))
+    {
+        setName(name);
+    }
+
+    Value(Values&& v, const std::string& name = "")
+        : _type(Type::values)
+        , _values(new Values(std::move(v)))
+    {
+        setName(name);
+    }
+
+    Value(const Value& v)
+        : _integer(0)
     {
+        copyFrom(v);
     }
 
-    Value(const Value& v) { operator=(v); }
+    Value(Value&& v) noexcept
+        : _integer(0)
+    {
+        moveFrom(std::move(v));
+    }
+
+    ~Value() { reset(); }
+
     Value& operator=(const Value& v)
     {
         if (this != &v)
         {
-            _name = v._name;
-            _type = v._type;
-            _integer = v._integer;
-            _real = v._real;
-            _string = v._string;
+            reset();
+            copyFrom(v);
+        }
 
-            if (v._values)
-            {
-                _values = std::make_unique<Values>();
-                if (v._values)
-                    *_values = *(v._values);
-            }
-            else
-            {
-                _values.reset(nullptr);
-            }
+        return *this;
+    }
+
+    Value& operator=(Value&& v) noexcept
+    {
+        if (this != &v)
+        {
+            reset();
+            moveFrom(std::move(v));
         }
 
         return *this;
@@ -117,14 +154,14 @@ struct Value
 
     Value& operator[](const std::string& name)
     {
-        _name = name;
+        setName(name);
         return *this;
     }
 
     template <class InputIt>
     Value(InputIt first, InputIt last)
-        : _values(std::make_unique<Values>())
-        , _type(Type::values)
+        : _type(Type::values)
+        , _values(new Values())
     {
         auto it = first;
         while (it != last)
@@ -139,7 +176,7 @@ struct Value
         if (_type != v._type)
             return false;
 
-        if (_name != v._name)
+        if (getName() != v.getName())
             return false;
 
         switch (_type)
@@ -153,12 +190,7 @@ struct Value
         case Type::string:
             return _string == v._string;
         case Type::values:
-            if (_values->size() != v._values->size())
-                return false;
-            bool isEqual = true;
-            for (uint32_t i = 0; i < _values->size(); ++i)
-                isEqual &= (_values->at(i) == v._values->at(i));
-            return isEqual;
+            return *_values == *v._values;
         }
     }
 
@@ -172,6 +204,14 @@ struct Value
             return _values->at(index);
     }
 
+    const Value& operator[](int index) const
+    {
+        if (_type != Type::values)
+            return *this;
+        else
+            return _values->at(index);
+    }
+
     template <class T, typename std::enable_if<std::is_same<T, std::string>::value>::type* = nullptr>
     T as() const
     {
@@ -244,9 +284,17 @@ struct Value
         }
     }
 
-    std::string getName() const { return _name; }
-    void setName(const std::string& name) { _name = name; }
-    bool isNamed() const { return !_name.empty(); }
+    std::string getName() const { return _name ? *_name : std::string(); }
+    void setName(const std::string& name)
+    {
+        if (name.empty())
+            _name.reset();
+        else if (_name)
+            *_name = name;
+        else
+            _name = std::make_unique<std::string>(name);
+    }
+    bool isNamed() const { return _name != nullptr; }
 
     Type getType() const { return _type; }
     char getTypeAsChar() const
@@ -284,12 +332,86 @@ struct Value
     }
 
   private:
-    std::string _name{""};
+    std::unique_ptr<std::string> _name{}; //!< Name, only allocated for named values
     Type _type{Type::integer};
-    int64_t _integer{0};
-    double _real{0.0};
-    std::string _string{""};
-    std::unique_ptr<Values> _values{nullptr};
+    union {
+        int64_t _integer;
+        double _real;
+        std::string _string;
+        Values* _values; //!< Owned, kept on the heap as Values contains Value objects
+    };
+
+    /**
+     * \brief Destroy the active member, leaving the value as an integer
+     */
+    void reset()
+    {
+        if (_type == Type::string)
+            _string.~basic_string();
+        else if (_type == Type::values)
+            delete _values;
+        _type = Type::integer;
+        _integer = 0;
+    }
+
+    /**
+     * \brief Copy another value, this one having no active member to destroy
+     * \param v Value to copy
+     */
+    void copyFrom(const Value& v)
+    {
+        if (v._name)
+            _name = std::make_unique<std::string>(*v._name);
+        else
+            _name.reset();
+
+        switch (v._type)
+        {
+        case Type::integer:
+            _integer = v._integer;
+            break;
+        case Type::real:
+            _real = v._real;
+            break;
+        case Type::string:
+            new (&_string) std::string(v._string);
+            break;
+        case Type::values:
+            _values = new Values(*v._values);
+            break;
+        }
+        _type = v._type;
+    }
+
+    /**
+     * \brief Move from another value, this one having no active member to destroy
+     * \param v Value to move from
+     */
+    void moveFrom(Value&& v)
+    {
+        _name = std::move(v._name);
+
+        switch (v._type)
+        {
+        case Type::integer:
+            _integer = v._integer;
+            break;
+        case Type::real:
+            _real = v._real;
+            break;
+        case Type::string:
+            new (&_string) std::string(std::move(v._string));
+            break;
+        case Type::values:
+            // The list is stolen, and the source is left as an integer so that it does not release it
+            _values = v._values;
+            v._type = Type::integer;
+            v._integer = 0;
+            _type = Type::values;
+            return;
+        }
+        _type = v._type;
+    }
 };
 
 } // namespace Splash
@@ -12,8 +12,11 @@
 #include <utility>
 
 #include "./core/buffer_object.h"
+#include "./core/buffer_pool.h"
 #include "./core/link.h"
 #include "./core/scene.h"
+#include "./core/thread_pool.h"
+#include "./image/frame_writer.h"
 #include "./image/image.h"
 #include "./image/queue.h"
 #include "./mesh/mesh.h"
@@ -21,11 +24,16 @@
 #include "./utils/log.h"
 #include "./utils/osutils.h"
 #include "./utils/timer.h"
+#include "./utils/tracer.h"
 
 using namespace glm;
 using namespace std;
 
 #define SPLASH_CAMERA_LINK "__camera_link"
+#define SPLASH_WORLD_OFFLINE_MEDIA_TIMEOUT 1000000
+#define SPLASH_WORLD_OFFLINE_FRAME_TIMEOUT 10000000
+#define SPLASH_WORLD_OFFLINE_STOP_TIMEOUT 60000000
+#define SPLASH_WORLD_DISTANT_RESYNC_PERIOD 2000000
 
 namespace Splash
 {
@@ -59,7 +67,7 @@ void World::run()
     {
         Log::get() << Log::MESSAGE << "World::" << __FUNCTION__ << " - Creating child Scene with name " << _childSceneName << Log::endl;
 
-        Scene scene(_childSceneName, _linkSocketPrefix);
+        Scene scene(_childSceneName, _linkSocketPrefix, _childListenPort);
         scene.run();
 
         return;
@@ -67,10 +75,17 @@ void World::run()
 
     applyConfig();
 
+    auto& timer = Timer::get();
+    const auto loopWorldSlot = timer.getSlot("loop_world");
+    const auto loopWorldInnerSlot = timer.getSlot("loop_world_inner");
+    const auto serializeSlot = timer.getSlot("serialize");
+    const auto uploadSlot = timer.getSlot("upload");
+    const auto waitBufferSendingSlot = timer.getSlot("wait_buffer_sending");
+
     while (true)
     {
-        Timer::get() << "loop_world";
-        Timer::get() << "loop_world_inner";
+        timer << loopWorldSlot;
+        timer << loopWorldInnerSlot;
         lock_guard<mutex> lockConfiguration(_configurationMutex);
 
         // Execute waiting tasks
@@ -80,10 +95,11 @@ void World::run()
             lock_guard<recursive_mutex> lockObjects(_objectsMutex);
 
             // Read and serialize new buffers
-            Timer::get() << "serialize";
+            timer << serializeSlot;
             unordered_map<string, shared_ptr<SerializedObject>> serializedObjects;
+            unordered_map<string, string> serializedObjectTypes;
             {
-                vector<future<void>> threads;
+                TaskGroup tasks;
                 for (auto& o : _objects)
                 {
                     // Run object tasks
@@ -94,8 +110,9 @@ void World::run()
                     auto serializedObjectIt = serializedObjects.emplace(std::make_pair(bufferObj->getDistantName(), shared_ptr<SerializedObject>(nullptr)));
                     if (!serializedObjectIt.second)
                         continue; // Error while inserting the object in the map
+                    serializedObjectTypes[bufferObj->getDistantName()] = bufferObj->getType();
 
-                    threads.push_back(async(launch::async, [=, &o]() {
+                    tasks.run([=, &o]() {
                         // Update the local objects
                         o.second->update();
 
@@ -110,30 +127,39 @@ void World::run()
                                     serializedObjectIt.first->second = obj;
                             }
                         }
-                    }));
+                    });
                 }
+                tasks.wait();
             }
-            Timer::get() >> "serialize";
+            timer >> serializeSlot;
 
             // Wait for previous buffers to be uploaded
+            timer << waitBufferSendingSlot;
             _link->waitForBufferSending(chrono::milliseconds(50)); // Maximum time to wait for frames to arrive
+            timer >> waitBufferSendingSlot;
             sendMessage(SPLASH_ALL_PEERS, "uploadTextures", {});
-            Timer::get() >> "upload";
+            timer >> uploadSlot;
 
             // Ask for the upload of the new buffers, during the next world loop
-            Timer::get() << "upload";
+            timer << uploadSlot;
             for (auto& o : serializedObjects)
                 if (o.second)
-                    _link->sendBuffer(o.first, std::move(o.second));
+                    _link->sendBuffer(o.first, std::move(o.second), serializedObjectTypes[o.first]);
         }
 
+        // Messages sent from here on are sent as a single frame at the end of the loop
+        _link->startBatch();
+
         // Update the distant attributes
+        auto resyncDistantAttributes = _distantAttributesResync.exchange(false) || Timer::getTime() - _distantAttributesResyncTime > SPLASH_WORLD_DISTANT_RESYNC_PERIOD;
+        if (resyncDistantAttributes)
+            _distantAttributesResyncTime = Timer::getTime();
         for (auto& o : _objects)
         {
-            auto attribs = o.second->getDistantAttributes();
+            auto attribs = o.second->getDistantAttributes(resyncDistantAttributes);
             for (auto& attrib : attribs)
             {
-                sendMessage(o.second->getName(), attrib.first, attrib.second);
+                _link->sendMessage(o.second->getName(), attrib.first, attrib.second, true);
             }
         }
 
@@ -141,7 +167,7 @@ void World::run()
         if (_scenes[_masterSceneName] != -1)
         {
             // Send current timings to all Scenes, for display purpose
-            auto& durationMap = Timer::get().getDurationMap();
+            auto durationMap = Timer::get().getDurationMap();
             for (auto& d : durationMap)
                 sendMessage(_masterSceneName, "duration", {d.first, (int)d.second});
             // Also send the master clock if needed
@@ -158,20 +184,26 @@ void World::run()
                 sendMessage(_masterSceneName, "log", {log.first, (int)log.second});
         }
 
+        _link->flushBatch();
+
         if (_quit)
         {
+            // The trace is gathered while the Scenes are still running
+            if (!_traceFile.empty())
+                saveTrace(_traceFile);
+
             for (auto& s : _scenes)
                 sendMessage(s.first, "quit", {});
             break;
         }
 
         // Sync with buffer object update
-        Timer::get() >> "loop_world_inner";
-        auto elapsed = Timer::get().getDuration("loop_world_inner");
+        timer >> loopWorldInnerSlot;
+        auto elapsed = timer.getDuration(loopWorldInnerSlot);
         waitSignalBufferObjectUpdated(1e6 / (float)_worldFramerate - elapsed);
 
         // Sync to world framerate
-        Timer::get() >> "loop_world";
+        timer >> loopWorldSlot;
     }
 }
 
@@ -198,6 +230,7 @@ void World::applyConfig()
 
     // We first destroy all scene and objects
     _scenes.clear();
+    _sceneAddresses.clear();
     _objects.clear();
     _masterSceneName = "";
 
@@ -302,8 +335,7 @@ void World::applyConfig()
                         }
 
                         auto values = jsonToValues(attr);
-                        values.push_front(objMembers[idxAttr]);
-                        values.push_front(objectName);
+                        values.insert(values.begin(), {objectName, objMembers[idxAttr]});
                         setAttribute("sendAll", values);
 
                         idxAttr++;
@@ -408,30 +440,7 @@ bool World::addScene(const std::string& sceneName, const std::string& sceneDispl
             {
                 // Spawn a new process containing this Scene
                 Log::get() << Log::MESSAGE << "World::" << __FUNCTION__ << " - Starting a Scene in another process" << Log::endl;
-
-                string cmd = _currentExePath;
-                string debug = (Log::get().getVerbosity() == Log::DEBUGGING) ? "-d" : "";
-                string timer = Timer::get().isDebug() ? "-t" : "";
-                string slave = "--child";
-                string xauth = "XAUTHORITY=" + Utils::getHomePath() + "/.Xauthority";
-
-                vector<char*> argv = {const_cast<char*>(cmd.c_str()), const_cast<char*>(slave.c_str())};
-                if (!_linkSocketPrefix.empty())
-                {
-                    argv.push_back((char*)"--prefix");
-                    argv.push_back(const_cast<char*>(_linkSocketPrefix.c_str()));
-                }
-                if (!debug.empty())
-                    argv.push_back(const_cast<char*>(debug.c_str()));
-                if (!timer.empty())
-                    argv.push_back(const_cast<char*>(timer.c_str()));
-                argv.push_back(const_cast<char*>(sceneName.c_str()));
-                argv.push_back(nullptr);
-                vector<char*> env = {const_cast<char*>(display.c_str()), const_cast<char*>(xauth.c_str()), nullptr};
-
-                int status = posix_spawn(&pid, cmd.c_str(), nullptr, nullptr, argv.data(), env.data());
-                if (status != 0)
-                    Log::get() << Log::ERROR << "World::" << __FUNCTION__ << " - Error while spawning process for scene " << sceneName << Log::endl;
+                pid = spawnSceneProcess(sceneName, display);
             }
 
             // We wait for the child process to be launched
@@ -449,6 +458,7 @@ bool World::addScene(const std::string& sceneName, const std::string& sceneDispl
         }
 
         _scenes[sceneName] = pid;
+        _sceneAddresses[sceneName] = sceneAddress;
         if (_masterSceneName.empty())
             _masterSceneName = sceneName;
 
@@ -457,14 +467,109 @@ bool World::addScene(const std::string& sceneName, const std::string& sceneDispl
             _link->connectTo(sceneName, _innerScene.get());
         else
             _link->connectTo(sceneName);
+        _distantAttributesResync = true;
 
         return true;
     }
     else
     {
-        Log::get() << Log::WARNING << "World::" << __FUNCTION__ << " - Non-local scenes are not implemented yet" << Log::endl;
-        return false;
+        // Scenes on other hosts are reached through TCP, the address being in the form host[:port]
+        auto host = sceneAddress;
+        auto port = SPLASH_LINK_TCP_DEFAULT_PORT;
+        auto separator = sceneAddress.rfind(':');
+        if (separator != string::npos)
+        {
+            host = sceneAddress.substr(0, separator);
+            try
+            {
+                port = stoi(sceneAddress.substr(separator + 1));
+            }
+            catch (...)
+            {
+                Log::get() << Log::WARNING << "World::" << __FUNCTION__ << " - Invalid port in address " << sceneAddress << " for scene " << sceneName << Log::endl;
+                return false;
+            }
+        }
+
+        // A Scene on the loopback interface can be spawned here, which is mostly useful for testing
+        int pid = 0;
+        if (spawn > 0 && (host == "127.0.0.1" || host == "::1"))
+        {
+            Log::get() << Log::MESSAGE << "World::" << __FUNCTION__ << " - Starting a Scene in another process, listening on port " << port << Log::endl;
+            string display = getenv("DISPLAY") != nullptr ? "DISPLAY=" + string(getenv("DISPLAY")) : "";
+            pid = spawnSceneProcess(sceneName, display, port);
+            if (pid == -1)
+                return false;
+        }
+        else
+        {
+            Log::get() << Log::MESSAGE << "World::" << __FUNCTION__ << " - Connecting to scene " << sceneName << " at " << host << ":" << port
+                       << ", which should have been started with: splash --child --listen " << port << " " << sceneName << Log::endl;
+        }
+
+        _link->connectTo(sceneName, host, port);
+
+        // The Scene answers once the connection is up
+        if (sendMessageWithAnswer(sceneName, "sync", {}, 10e6).size() == 0)
+        {
+            Log::get() << Log::ERROR << "World::" << __FUNCTION__ << " - Timeout when trying to connect to scene \"" << sceneName << "\" at " << sceneAddress << Log::endl;
+            _link->disconnectFrom(sceneName);
+            if (pid > 0)
+                kill(pid, SIGTERM);
+            return false;
+        }
+
+        _scenes[sceneName] = pid;
+        _sceneAddresses[sceneName] = sceneAddress;
+        if (_masterSceneName.empty())
+            _masterSceneName = sceneName;
+        _distantAttributesResync = true;
+
+        return true;
+    }
+}
+
+/*************/
+int World::spawnSceneProcess(const string& sceneName, const string& display, int listenPort)
+{
+    string cmd = _currentExePath;
+    string debug = (Log::get().getVerbosity() == Log::DEBUGGING) ? "-d" : "";
+    string timer = Timer::get().isDebug() ? "-t" : "";
+    string headless = Scene::isHeadless() ? "--headless" : "";
+    string slave = "--child";
+    string xauth = "XAUTHORITY=" + Utils::getHomePath() + "/.Xauthority";
+    string port = to_string(listenPort);
+
+    vector<char*> argv = {const_cast<char*>(cmd.c_str()), const_cast<char*>(slave.c_str())};
+    if (!_linkSocketPrefix.empty())
+    {
+        argv.push_back((char*)"--prefix");
+        argv.push_back(const_cast<char*>(_linkSocketPrefix.c_str()));
+    }
+    if (listenPort != 0)
+    {
+        argv.push_back((char*)"--listen");
+        argv.push_back(const_cast<char*>(port.c_str()));
     }
+    if (!debug.empty())
+        argv.push_back(const_cast<char*>(debug.c_str()));
+    if (!timer.empty())
+        argv.push_back(const_cast<char*>(timer.c_str()));
+    if (!headless.empty())
+        argv.push_back(const_cast<char*>(headless.c_str()));
+    argv.push_back(const_cast<char*>(sceneName.c_str()));
+    argv.push_back(nullptr);
+    vector<char*> env = {const_cast<char*>(display.c_str()), const_cast<char*>(xauth.c_str()), nullptr};
+
+    int pid = -1;
+    int status = posix_spawn(&pid, cmd.c_str(), nullptr, nullptr, argv.data(), env.data());
+    if (status != 0)
+    {
+        Log::get() << Log::ERROR << "World::" << __FUNCTION__ << " - Error while spawning process for scene " << sceneName << Log::endl;
+        return -1;
+    }
+
+    return pid;
 }
 
 /*************/
@@ -538,6 +643,219 @@ string World::getObjectsAttributesDescriptions()
     return jsonString;
 }
 
+/*************/
+void World::saveTrace(const string& path)
+{
+    auto getName = [](uint32_t id) { return Timer::get().getSlotName({id}); };
+    auto traceEvents = Tracer::toChromeTrace(Tracer::get().getEvents(), 0, "world", getName);
+
+    int pid = 1;
+    for (const auto& s : _scenes)
+    {
+        // The inner Scene runs in this process, its events are already there
+        if (_innerScene && s.first == _innerScene->getName())
+            continue;
+
+        auto requestTime = Timer::getTime();
+        auto answer = sendMessageWithAnswer(s.first, "getTrace", {}, 2e6);
+        auto answerTime = Timer::getTime();
+        if (answer.size() != 4)
+        {
+            Log::get() << Log::WARNING << "World::" << __FUNCTION__ << " - Scene " << s.first << " did not send its trace" << Log::endl;
+            continue;
+        }
+
+        Json::Value sceneEvents;
+        Json::Reader reader;
+        if (!reader.parse(answer[3].as<string>(), sceneEvents))
+            continue;
+
+        // Local Scenes share the same monotonic clock. For Scenes on other hosts, the offset is
+        // estimated assuming symmetric transmission delays
+        int64_t clockOffset = 0;
+        if (s.second == 0)
+            clockOffset = (requestTime + answerTime) / 2 - answer[2].as<int64_t>();
+
+        for (auto& event : sceneEvents)
+        {
+            event["pid"] = pid;
+            if (event.isMember("ts"))
+                event["ts"] = static_cast<Json::Int64>(event["ts"].asInt64() + clockOffset);
+            traceEvents.append(event);
+        }
+        ++pid;
+    }
+
+    Json::Value root;
+    root["traceEvents"] = traceEvents;
+    root["displayTimeUnit"] = "ms";
+
+    ofstream out(path, ios::out | ios::binary);
+    if (!out.is_open())
+    {
+        Log::get() << Log::WARNING << "World::" << __FUNCTION__ << " - Unable to open file " << path << Log::endl;
+        return;
+    }
+
+    Json::FastWriter writer;
+    out << writer.write(root);
+    Log::get() << Log::MESSAGE << "World::" << __FUNCTION__ << " - Trace saved to " << path << Log::endl;
+}
+
+/*************/
+bool World::renderOffline(const string& directory, int64_t frameCount, float framerate, const string& format)
+{
+    FrameWriter::Format writerFormat;
+    if (!FrameWriter::getFormatFromName(format, writerFormat))
+    {
+        Log::get() << Log::WARNING << "World::" << __FUNCTION__ << " - Unknown output format: " << format << Log::endl;
+        return false;
+    }
+
+    if (!Utils::isDir(directory))
+    {
+        Log::get() << Log::WARNING << "World::" << __FUNCTION__ << " - Output directory " << directory << " does not exist" << Log::endl;
+        return false;
+    }
+
+    if (framerate <= 0.f)
+        framerate = _worldFramerate;
+
+    Log::get() << Log::MESSAGE << "World::" << __FUNCTION__ << " - Rendering offline to " << directory << " at " << framerate << " fps" << Log::endl;
+
+    auto& timer = Timer::get();
+    timer.setVirtualTime(0);
+    timer.setVirtualClock(true);
+
+    sendMessage(SPLASH_ALL_PEERS, "startOfflineRendering", {directory, format});
+
+    int64_t mediaDuration = 0;
+    int64_t serializeDuration = 0;
+    int64_t transferDuration = 0;
+    int64_t scenesDuration = 0;
+    int64_t frame = 0;
+    bool completed = true;
+    auto startTime = Timer::getTime();
+
+    for (; (frameCount <= 0 || frame < frameCount) && !_quit; ++frame)
+    {
+        timer.setVirtualTime(static_cast<int64_t>(frame * 1e6 / framerate));
+
+        Values buffers{};
+        {
+            lock_guard<recursive_mutex> lockObjects(_objectsMutex);
+
+            // Media stage: wait for each media to reach the current time, then update the buffers
+            auto stageStart = Timer::getTime();
+            vector<shared_ptr<BufferObject>> bufferObjects;
+            {
+                TaskGroup tasks;
+                for (auto& o : _objects)
+                {
+                    o.second->runTasks();
+
+                    auto bufferObj = dynamic_pointer_cast<BufferObject>(o.second);
+                    if (!bufferObj)
+                        continue;
+                    bufferObjects.push_back(bufferObj);
+
+                    tasks.run([=]() {
+                        bufferObj->waitForVirtualClock(SPLASH_WORLD_OFFLINE_MEDIA_TIMEOUT);
+                        bufferObj->update();
+                    });
+                }
+                tasks.wait();
+            }
+            mediaDuration += Timer::getTime() - stageStart;
+
+            // Serialization stage
+            stageStart = Timer::getTime();
+            vector<shared_ptr<SerializedObject>> serializedObjects(bufferObjects.size());
+            {
+                TaskGroup tasks;
+                for (size_t i = 0; i < bufferObjects.size(); ++i)
+                {
+                    if (!bufferObjects[i]->wasUpdated())
+                        continue;
+
+                    tasks.run([=, &serializedObjects]() {
+                        serializedObjects[i] = bufferObjects[i]->serialize();
+                        bufferObjects[i]->setNotUpdated();
+                    });
+                }
+                tasks.wait();
+            }
+            serializeDuration += Timer::getTime() - stageStart;
+
+            // Transfer stage
+            stageStart = Timer::getTime();
+            for (size_t i = 0; i < bufferObjects.size(); ++i)
+            {
+                if (!serializedObjects[i])
+                    continue;
+
+                auto name = bufferObjects[i]->getDistantName();
+                if (_link->sendBuffer(name, std::move(serializedObjects[i]), bufferObjects[i]->getType()))
+                    buffers.push_back(name);
+            }
+            _link->waitForBufferSending(chrono::milliseconds(SPLASH_WORLD_OFFLINE_FRAME_TIMEOUT / 1000));
+            sendMessage(SPLASH_ALL_PEERS, "uploadTextures", {});
+            transferDuration += Timer::getTime() - stageStart;
+        }
+
+        // Distant attributes are sent once per frame, as in the realtime loop
+        auto resyncDistantAttributes = _distantAttributesResync.exchange(false);
+        for (auto& o : _objects)
+            for (auto& attrib : o.second->getDistantAttributes(resyncDistantAttributes))
+                _link->sendMessage(o.second->getName(), attrib.first, attrib.second, true);
+
+        // Scenes stage: every Scene has to render the frame before moving on
+        auto stageStart = Timer::getTime();
+        {
+            unique_lock<mutex> lock(_offlineMutex);
+            _offlineFrameIndex = frame;
+            _offlineScenesDone = 0;
+        }
+        sendMessage(SPLASH_ALL_PEERS, "renderOfflineFrame", {frame, buffers});
+
+        unique_lock<mutex> lock(_offlineMutex);
+        if (!_offlineCondition.wait_for(lock, chrono::microseconds(SPLASH_WORLD_OFFLINE_FRAME_TIMEOUT), [&]() { return _offlineScenesDone >= _scenes.size() || _quit; }))
+        {
+            Log::get() << Log::WARNING << "World::" << __FUNCTION__ << " - Timeout while waiting for the Scenes to render frame " << frame << ", stopping" << Log::endl;
+            completed = false;
+            break;
+        }
+        scenesDuration += Timer::getTime() - stageStart;
+    }
+
+    auto totalDuration = Timer::getTime() - startTime;
+    auto toFps = [](int64_t frames, int64_t duration) { return duration > 0 ? static_cast<float>(frames) * 1e6f / static_cast<float>(duration) : 0.f; };
+
+    Log::get() << Log::MESSAGE << "World::" << __FUNCTION__ << " - Rendered " << frame << " frames at " << toFps(frame, totalDuration) << " fps" << Log::endl;
+    Log::get() << Log::MESSAGE << "World::" << __FUNCTION__ << " - World stages: media " << toFps(frame, mediaDuration) << " fps, serialization " << toFps(frame, serializeDuration)
+               << " fps, transfer " << toFps(frame, transferDuration) << " fps, scenes " << toFps(frame, scenesDuration) << " fps" << Log::endl;
+
+    // Scenes answer once all their frames are written
+    for (const auto& s : _scenes)
+    {
+        auto answer = sendMessageWithAnswer(s.first, "stopOfflineRendering", {}, SPLASH_WORLD_OFFLINE_STOP_TIMEOUT);
+        if (answer.size() != 7)
+        {
+            Log::get() << Log::WARNING << "World::" << __FUNCTION__ << " - Scene " << s.first << " did not send its offline rendering statistics" << Log::endl;
+            continue;
+        }
+
+        auto sceneFrames = answer[2].as<int64_t>();
+        auto writtenFrames = answer[5].as<int64_t>();
+        Log::get() << Log::MESSAGE << "World::" << __FUNCTION__ << " - Scene " << s.first << ": buffer wait " << toFps(sceneFrames, answer[3].as<int64_t>()) << " fps, render "
+                   << toFps(sceneFrames, answer[4].as<int64_t>()) << " fps, write " << toFps(writtenFrames, answer[6].as<int64_t>()) << " fps, " << writtenFrames
+                   << " frames written" << Log::endl;
+    }
+
+    timer.setVirtualClock(false);
+    return completed;
+}
+
 /*************/
 void World::saveConfig()
 {
@@ -551,7 +869,7 @@ void World::saveConfig()
     {
         Json::Value scene;
         scene["name"] = s.first;
-        scene["address"] = "localhost"; // Distant scenes are not yet supported
+        scene["address"] = _sceneAddresses[s.first];
         distantScenes["scenes"].append(scene);
 
         // Get this scene's configuration
@@ -946,8 +1264,7 @@ bool World::loadProject(const string& filename)
                     }
 
                     auto values = jsonToValues(attr);
-                    values.push_front(objMembers[idxAttr]);
-                    values.push_front(objectName);
+                    values.insert(values.begin(), {objectName, objMembers[idxAttr]});
                     setAttribute("sendAll", values);
 
                     idxAttr++;
@@ -992,20 +1309,26 @@ void World::parseArguments(int argc, char** argv)
             {"forceDisplay", required_argument, 0, 'D'},
             {"displayServer", required_argument, 0, 'S'},
 #endif
+            {"headless", no_argument, 0, 'E'},
             {"help", no_argument, 0, 'h'},
             {"hide", no_argument, 0, 'H'},
             {"info", no_argument, 0, 'i'},
             {"log2file", no_argument, 0, 'l'},
+            {"frames", required_argument, 0, 'n'},
+            {"offline", required_argument, 0, 'O'},
             {"open", required_argument, 0, 'o'},
             {"prefix", required_argument, 0, 'p'},
+            {"raw", no_argument, 0, 'r'},
             {"silent", no_argument, 0, 's'},
             {"timer", no_argument, 0, 't'},
+            {"trace", required_argument, 0, 'T'},
             {"child", no_argument, 0, 'c'},
+            {"listen", required_argument, 0, 'L'},
             {0, 0, 0, 0}
         };
 
         int optionIndex = 0;
-        auto ret = getopt_long(argc, argv, "+cdD:S:hHilo:p:P:st", longOptions, &optionIndex);
+        auto ret = getopt_long(argc, argv, "+cdD:ES:hHilL:n:o:O:p:P:rstT:", longOptions, &optionIndex);
 
         if (ret == -1)
             break;
@@ -1022,6 +1345,7 @@ void World::parseArguments(int argc, char** argv)
             cout << "\t-o (--open) [filename] : set [filename] as the configuration file to open" << endl;
             cout << "\t-d (--debug) : activate debug messages (if Splash was compiled with -DDEBUG)" << endl;
             cout << "\t-t (--timer) : activate more timers, at the cost of performance" << endl;
+            cout << "\t-T (--trace) [filename] : record the timings of the World and all Scenes, and save them to [filename] when quitting" << endl;
 #if HAVE_LINUX
             cout << "\t-D (--forceDisplay) : force the display on which to show all windows" << endl;
             cout << "\t-S (--displayServer) : set the display server ID" << endl;
@@ -1029,11 +1353,17 @@ void World::parseArguments(int argc, char** argv)
             cout << "\t-s (--silent) : disable all messages" << endl;
             cout << "\t-i (--info) : get description for all objects attributes" << endl;
             cout << "\t-H (--hide) : run Splash in background" << endl;
+            cout << "\t-E (--headless) : render windows offscreen through EGL, without any display server (needs GLFW 3.4)" << endl;
+            cout << "\t-O (--offline) [directory] : render as fast as possible from a virtual clock, write the frames to [directory] and quit" << endl;
+            cout << "\t-n (--frames) [count] : when rendering offline, number of frames to render (defaults to 0, rendering until quitting)" << endl;
+            cout << "\t-r (--raw) : when rendering offline, write raw RGBA frames instead of PNG files" << endl;
             cout << "\t-P (--python) : add the given Python script to the loaded configuration" << endl;
             cout << "                  any argument after -- will be sent to the script" << endl;
             cout << "\t-l (--log2file) : write the logs to /var/log/splash.log, if possible" << endl;
             cout << "\t-p (--prefix) : set the shared memory socket paths prefix (defaults to the PID)" << endl;
             cout << "\t-c (--child): run as a child controlled by a master Splash process" << endl;
+            cout << "\t-L (--listen) [port] : when run as a child, wait for a master Splash process on another host to connect through TCP on [port] and the three following ports"
+                 << endl;
             cout << endl;
             exit(0);
         }
@@ -1087,6 +1417,31 @@ void World::parseArguments(int argc, char** argv)
             _runInBackground = true;
             break;
         }
+        case 'E':
+        {
+#if HAVE_HEADLESS
+            Scene::setHeadless(true);
+#else
+            Log::get() << Log::ERROR << "World::" << __FUNCTION__ << " - Headless rendering is not available, Splash was built against a GLFW older than 3.4" << Log::endl;
+            exit(1);
+#endif
+            break;
+        }
+        case 'n':
+        {
+            _offlineFrames = atoll(optarg);
+            break;
+        }
+        case 'O':
+        {
+            _offlineDirectory = Utils::getFullPathFromFilePath(string(optarg), Utils::getCurrentWorkingDirectory());
+            break;
+        }
+        case 'r':
+        {
+            _offlineFormat = "raw";
+            break;
+        }
         case 'P':
         {
             auto pythonScriptPath = Utils::getFullPathFromFilePath(string(optarg), Utils::getCurrentWorkingDirectory());
@@ -1157,11 +1512,28 @@ void World::parseArguments(int argc, char** argv)
             Timer::get().setDebug(true);
             break;
         }
+        case 'T':
+        {
+            _traceFile = Utils::getFullPathFromFilePath(string(optarg), Utils::getCurrentWorkingDirectory());
+            // Scenes are told to trace once they are created
+            addTask([&]() { setAttribute("tracing", {1}); });
+            break;
+        }
         case 'c':
         {
             _runAsChild = true;
             break;
         }
+        case 'L':
+        {
+            _childListenPort = atoi(optarg);
+            if (_childListenPort <= 0 || _childListenPort > 65532)
+            {
+                Log::get() << Log::WARNING << "World::" << __FUNCTION__ << " - " << string(optarg) << ": argument expects a valid port number" << Log::endl;
+                exit(0);
+            }
+            break;
+        }
         }
     }
 
@@ -1203,6 +1575,13 @@ void World::parseArguments(int argc, char** argv)
         {
             exit(0);
         }
+
+        // Offline rendering starts once the configuration is applied, and Splash quits when done
+        if (!_offlineDirectory.empty())
+            addTask([&]() {
+                renderOffline(_offlineDirectory, _offlineFrames, _worldFramerate, _offlineFormat);
+                _quit = true;
+            });
     }
 
     if (defaultFile)
@@ -1271,6 +1650,33 @@ void World::registerAttributes()
     });
     setAttributeDescription("sceneLaunched", "Message sent by Scenes to confirm they are running");
 
+    addAttribute("peerDesynced",
+        [&](const Values& args) {
+            auto sceneName = args[0].as<string>();
+            addTask([=]() {
+                auto sceneIt = _scenes.find(sceneName);
+                if (sceneIt == _scenes.end())
+                    return;
+
+                // The Scene missed some messages and can not be brought back in sync, so it is given up on
+                Log::get() << Log::ERROR << "World::peerDesynced - Scene " << sceneName << " stalled and missed some messages, disconnecting from it" << Log::endl;
+                _link->disconnectFrom(sceneName);
+                if (sceneIt->second > 0)
+                    kill(sceneIt->second, SIGTERM);
+                _scenes.erase(sceneIt);
+                _sceneAddresses.erase(sceneName);
+
+                if (sceneName == _masterSceneName)
+                {
+                    Log::get() << Log::ERROR << "World::peerDesynced - Lost the master Scene. Exiting." << Log::endl;
+                    _quit = true;
+                }
+            });
+            return true;
+        },
+        {'s'});
+    setAttributeDescription("peerDesynced", "Message sent by the Link when a remote Scene stalled for too long and missed some messages");
+
     addAttribute("deleteObject",
         [&](const Values& args) {
             addTask([=]() {
@@ -1421,11 +1827,11 @@ void World::registerAttributes()
                     {
                         sendMessage(s.first, "quit", {});
                         _link->disconnectFrom(s.first);
-                        if (s.second != -1)
+                        if (s.second > 0)
                         {
                             waitpid(s.second, nullptr, 0);
                         }
-                        else
+                        else if (s.second == -1)
                         {
                             if (_innerSceneThread.joinable())
                                 _innerSceneThread.join();
@@ -1453,6 +1859,25 @@ void World::registerAttributes()
         {'s'});
     setAttributeDescription("copyCameraParameters", "Copy the camera parameters from the given configuration file (based on camera names)");
 
+    addAttribute("compressedBufferTypes",
+        [&](const Values& args) {
+            vector<string> types;
+            for (const auto& arg : args)
+                types.push_back(arg.as<string>());
+            if (_link)
+                _link->setCompressedBufferTypes(types);
+            return true;
+        },
+        [&]() -> Values {
+            Values types;
+            if (_link)
+                for (const auto& type : _link->getCompressedBufferTypes())
+                    types.push_back(type);
+            return types;
+        },
+        {});
+    setAttributeDescription("compressedBufferTypes", "Set the object types whose buffers are compressed when sent to Scenes on other hosts");
+
 #if HAVE_PORTAUDIO
     addAttribute("clockDeviceName",
         [&](const Values& args) {
@@ -1481,6 +1906,36 @@ void World::registerAttributes()
         [&]() -> Values { return {static_cast<int>(Timer::get().isLoose())}; },
         {'n'});
 
+    addAttribute("bufferPoolSize",
+        [&](const Values& args) {
+            BufferPool::get().setMaxResidentSize(static_cast<size_t>(max(args[0].as<int>(), 0)) << 20);
+            setAttribute("sendAllScenes", {"bufferPoolSize", args[0]});
+            return true;
+        },
+        [&]() -> Values { return {static_cast<int>(BufferPool::get().getMaxResidentSize() >> 20)}; },
+        {'n'});
+    setAttributeDescription("bufferPoolSize", "Set the maximum size of the memory buffers kept for reuse, in MB, for the World and all Scenes");
+
+    addAttribute("bufferPoolIdleTime",
+        [&](const Values& args) {
+            BufferPool::get().setIdleTime(chrono::milliseconds(static_cast<int64_t>(max(args[0].as<float>(), 0.f) * 1000.f)));
+            setAttribute("sendAllScenes", {"bufferPoolIdleTime", args[0]});
+            return true;
+        },
+        [&]() -> Values { return {static_cast<float>(BufferPool::get().getIdleTime().count()) / 1000.f}; },
+        {'n'});
+    setAttributeDescription("bufferPoolIdleTime", "Set the time after which unused memory buffers are freed, in seconds, for the World and all Scenes");
+
+    addAttribute("tracing",
+        [&](const Values& args) {
+            Tracer::get().setEnabled(args[0].as<bool>());
+            setAttribute("sendAllScenes", {"tracing", args[0]});
+            return true;
+        },
+        [&]() -> Values { return {Tracer::get().isEnabled()}; },
+        {'n'});
+    setAttributeDescription("tracing", "If set to 1, record the CPU and GPU timings of the World and all Scenes, to be saved with saveTrace");
+
     addAttribute("pong",
         [&](const Values& args) {
             Timer::get() >> ("pingScene " + args[0].as<string>());
@@ -1585,6 +2040,43 @@ void World::registerAttributes()
         {'n'});
     setAttributeDescription("logToFile", "If set to 1, the process holding the World will try to write log to file");
 
+    addAttribute("saveTrace",
+        [&](const Values& args) {
+            auto path = args[0].as<string>();
+            addTask([=]() { saveTrace(path); });
+            return true;
+        },
+        {'s'});
+    setAttributeDescription("saveTrace", "Save the events recorded while tracing by the World and all Scenes to the given file, in the Chrome trace format");
+
+    addAttribute("renderOffline",
+        [&](const Values& args) {
+            auto directory = args[0].as<string>();
+            auto frames = args[1].as<int64_t>();
+            auto framerate = args[2].as<float>();
+            auto format = args.size() > 3 ? args[3].as<string>() : string("png");
+            addTask([=]() { renderOffline(directory, frames, framerate, format); });
+            return true;
+        },
+        {'s', 'n', 'n'});
+    setAttributeDescription("renderOffline",
+        "Render the given number of frames as fast as possible at the given virtual framerate, and write them to the given directory. An optional fourth argument sets the "
+        "format, either \"png\" or \"raw\"");
+
+    addAttribute("offlineFrameRendered",
+        [&](const Values& args) {
+            {
+                lock_guard<mutex> lock(_offlineMutex);
+                if (args[1].as<int64_t>() != _offlineFrameIndex)
+                    return true;
+                ++_offlineScenesDone;
+            }
+            _offlineCondition.notify_all();
+            return true;
+        },
+        {'s', 'n'});
+    setAttributeDescription("offlineFrameRendered", "Message sent by a Scene when it has rendered an offline frame");
+
     addAttribute("sendAll",
         [&](const Values& args) {
             addTask([=]() {
@@ -25,6 +25,7 @@
 #ifndef SPLASH_WORLD_H
 #define SPLASH_WORLD_H
 
+#include <atomic>
 #include <condition_variable>
 #include <glm/glm.hpp>
 #include <mutex>
@@ -106,12 +107,14 @@ class World : public RootObject
 
     bool _runAsChild{false}; //!< If true, runs as a child process
     std::string _childSceneName{"scene"};
+    int _childListenPort{0}; //!< If not zero, the child waits for a World on another host to connect through TCP on this port
 
-    NameRegistry _nameRegistry{};       //!< Object name registry
-    std::map<std::string, int> _scenes; //!< Map holding the PID of the Scene processes
-    std::string _masterSceneName{""};   //!< Name of the master Scene
-    std::string _displayServer{"0"};    //!< Display server.
-    std::string _forcedDisplay{""};     //!< Set to force an output display
+    NameRegistry _nameRegistry{};                         //!< Object name registry
+    std::map<std::string, int> _scenes;                   //!< Map holding the PID of the Scene processes, -1 for the inner Scene and 0 for Scenes on other hosts
+    std::map<std::string, std::string> _sceneAddresses{}; //!< Address of each Scene, as set in the configuration
+    std::string _masterSceneName{""};                     //!< Name of the master Scene
+    std::string _displayServer{"0"};                      //!< Display server.
+    std::string _forcedDisplay{""};                       //!< Set to force an output display
 
     std::string _configFilename;  //!< Configuration file path
     std::string _projectFilename; //!< Project configuration file path
@@ -121,9 +124,26 @@ class World : public RootObject
     std::mutex _childProcessMutex;
     std::condition_variable _childProcessConditionVariable;
 
+    // Only the distant attributes which changed are sent, but all of them are resent from time to time,
+    // and when a Scene connects, for Scenes to converge even if a message was dropped
+    std::atomic_bool _distantAttributesResync{true}; //!< If true, all distant attributes are sent during the next loop
+    int64_t _distantAttributesResyncTime{0};         //!< Time of the last full send of the distant attributes, in us
+
     // Synchronization testings
     int _swapSynchronizationTesting{0}; //!< If not 0, number of frames to keep the same color
 
+    // Tracing
+    std::string _traceFile{""}; //!< If not empty, the trace is saved to this file when quitting
+
+    // Offline rendering
+    std::string _offlineDirectory{""}; //!< If not empty, render offline to this directory once the configuration is loaded, then quit
+    int64_t _offlineFrames{0};         //!< Number of frames to render offline from the command line, 0 for no limit
+    std::string _offlineFormat{"png"}; //!< Output format for offline rendering from the command line
+    std::mutex _offlineMutex{};        //!< Protects _offlineFrameIndex and _offlineScenesDone
+    std::condition_variable _offlineCondition{};
+    int64_t _offlineFrameIndex{-1};    //!< Frame being rendered offline
+    size_t _offlineScenesDone{0};      //!< Number of Scenes which rendered the current offline frame
+
     /**
      * \brief Add an object to the world (used for Images and Meshes currently)
      * \param type Object type
@@ -145,6 +165,15 @@ class World : public RootObject
      */
     bool addScene(const std::string& sceneName, const std::string& sceneDisplay, const std::string& sceneAddress, bool spawn = true);
 
+    /**
+     * Spawn a process running a Scene
+     * \param sceneName Scene name
+     * \param display Display environment variable for the new process
+     * \param listenPort If not zero, the Scene is reached through TCP on this port
+     * \return Return the PID of the new process, or -1 if it could not be spawned
+     */
+    int spawnSceneProcess(const std::string& sceneName, const std::string& display, int listenPort = 0);
+
     /**
      * \brief Copies the camera calibration from the given file to the current configuration
      * \param filename Source configuration file
@@ -163,6 +192,23 @@ class World : public RootObject
      */
     void saveConfig();
 
+    /**
+     * \brief Merge the events recorded while tracing by the World and the Scenes, and save them as a Chrome trace
+     * \param path File path
+     */
+    void saveTrace(const std::string& path);
+
+    /**
+     * \brief Render frames as fast as possible, driving the media from a virtual clock, and write the windows content to disk
+     * Each frame is rendered exactly once by every Scene. Per stage frame rates are reported at the end
+     * \param directory Output directory
+     * \param frameCount Number of frames to render, 0 to render until quitting
+     * \param framerate Virtual framerate
+     * \param format Output format, either "png" or "raw"
+     * \return Return true if the rendering went to completion
+     */
+    bool renderOffline(const std::string& directory, int64_t frameCount, float framerate, const std::string& format);
+
     /**
      * \brief Partially save the configuration
      * This saves only the modifications to images, textures and meshes
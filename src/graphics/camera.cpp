@@ -319,9 +319,9 @@ bool Camera::doCalibration()
     else
     {
         // Third step: convert the values to camera parameters
-        if (!operator[]("fov").isLocked())
+        if (!_fovAttribute.isLocked())
             _fov = selectedValues[0];
-        if (!operator[]("principalPoint").isLocked())
+        if (!_principalPointAttribute.isLocked())
         {
             _cx = selectedValues[1];
             _cy = selectedValues[2];
@@ -363,8 +363,7 @@ bool Camera::doCalibration()
         {
             Values values;
             getAttribute(p, values);
-            values.push_front(p);
-            values.push_front(_name);
+            values.insert(values.begin(), {_name, p});
             scene->sendMessageToWorld("sendAll", values);
         }
     }
@@ -901,12 +900,13 @@ double Camera::calibrationCostFunc(const gsl_vector* v, void* params)
     double cy = gsl_vector_get(v, 2);
 
     // Check whether the camera parameters are locked
-    if (camera["fov"].isLocked())
-        fov = camera["fov"]()[0].as<float>();
-    if (camera["principalPoint"].isLocked())
+    if (camera._fovAttribute.isLocked())
+        fov = camera._fovAttribute.get();
+    if (camera._principalPointAttribute.isLocked())
     {
-        cx = camera["principalPoint"]()[0].as<float>();
-        cy = camera["principalPoint"]()[1].as<float>();
+        auto principalPoint = camera._principalPointAttribute.get();
+        cx = principalPoint[0].as<float>();
+        cy = principalPoint[1].as<float>();
     }
 
     // Some limits for the calibration parameters
@@ -1047,6 +1047,7 @@ void Camera::registerAttributes()
         },
         {'n', 'n', 'n'});
     setAttributeDescription("eye", "Set the camera position");
+    setAttributeParameter("eye", true, false, true);
 
     addAttribute("target",
         [&](const Values& args) {
@@ -1058,6 +1059,7 @@ void Camera::registerAttributes()
         },
         {'n', 'n', 'n'});
     setAttributeDescription("target", "Set the camera target position");
+    setAttributeParameter("target", true, false, true);
 
     addAttribute("fov",
         [&](const Values& args) {
@@ -1067,6 +1069,9 @@ void Camera::registerAttributes()
         [&]() -> Values { return {_fov}; },
         {'n'});
     setAttributeDescription("fov", "Set the camera field of view");
+    setAttributeParameter("fov", true, false, true);
+    bindAttribute("fov", &_fov);
+    _fovAttribute = getAttributeHandle<float>("fov");
 
     addAttribute("up",
         [&](const Values& args) {
@@ -1078,6 +1083,7 @@ void Camera::registerAttributes()
         },
         {'n', 'n', 'n'});
     setAttributeDescription("up", "Set the camera up vector");
+    setAttributeParameter("up", true, false, true);
 
     addAttribute("size",
         [&](const Values& args) {
@@ -1120,6 +1126,7 @@ void Camera::registerAttributes()
         },
         {'n', 'n'});
     setAttributeDescription("principalPoint", "Set the principal point of the lens (for lens shifting)");
+    _principalPointAttribute = getAttributeHandle<Values>("principalPoint");
 
     addAttribute("weightedCalibrationPoints",
         [&](const Values& args) {
@@ -260,6 +260,8 @@ class Camera : public GraphObject
     bool _displayCalibration{false};
     bool _displayAllCalibrations{false};
     bool _showAllCalibrationPoints{true};
+    AttributeHandle<float> _fovAttribute{};             //!< Checked at each step of the calibration, hence kept as handles
+    AttributeHandle<Values> _principalPointAttribute{};
     struct CalibrationPoint
     {
         CalibrationPoint() {}
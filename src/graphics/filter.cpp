@@ -222,6 +222,9 @@ void Filter::render()
 /*************/
 void Filter::updateUniforms()
 {
+    static const auto filmRemainingId = Shader::getUniformId("_filmRemaining");
+    static const auto filmDurationId = Shader::getUniformId("_filmDuration");
+
     auto shader = _screen->getShader();
 
     // Built-in uniforms
@@ -229,13 +232,11 @@ void Filter::updateUniforms()
 
     if (!_colorCurves.empty())
     {
-        Values tmpCurves;
+        Values curves;
         for (uint32_t i = 0; i < _colorCurves[0].size(); ++i)
             for (uint32_t j = 0; j < _colorCurves.size(); ++j)
-                tmpCurves.push_back(_colorCurves[j][i].as<float>());
-        Values curves;
-        curves.push_back(tmpCurves);
-        shader->setAttribute("uniform", {"_colorCurves", curves});
+                curves.push_back(_colorCurves[j][i].as<float>());
+        shader->setUniform("_colorCurves", curves);
     }
 
     // Update generic uniforms
@@ -250,22 +251,16 @@ void Filter::updateUniforms()
                 obj->getAttribute("duration", duration);
                 obj->getAttribute("remaining", remainingTime);
                 if (remainingTime.size() == 1)
-                    shader->setAttribute("uniform", {"_filmRemaining", remainingTime[0].as<float>()});
+                    shader->setUniform(filmRemainingId, remainingTime[0].as<float>());
                 if (duration.size() == 1)
-                    shader->setAttribute("uniform", {"_filmDuration", duration[0].as<float>()});
+                    shader->setUniform(filmDurationId, duration[0].as<float>());
             }
         }
     }
 
     // Update uniforms specific to the current filtering shader
     for (auto& uniform : _filterUniforms)
-    {
-        Values param;
-        param.push_back(uniform.first);
-        for (auto& v : uniform.second)
-            param.push_back(v);
-        shader->setAttribute("uniform", param);
-    }
+        shader->setUniform(uniform.first, uniform.second);
 }
 
 /*************/
@@ -11,7 +11,6 @@
 #include "./utils/timer.h"
 
 #include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
 #include <glm/gtx/euler_angles.hpp>
 #include <glm/gtx/string_cast.hpp>
 #include <limits>
@@ -114,8 +113,10 @@ void Object::activate()
 
     // Set some uniforms
     _shader->setAttribute("sideness", {_sideness});
-    _shader->setAttribute("uniform", {"_normalExp", _normalExponent});
-    _shader->setAttribute("uniform", {"_color", _color.r, _color.g, _color.b, _color.a});
+    static const auto normalExpId = Shader::getUniformId("_normalExp");
+    static const auto colorId = Shader::getUniformId("_color");
+    _shader->setUniform(normalExpId, _normalExponent);
+    _shader->setUniform(colorId, glm::vec4(_color));
 
     if (_geometries.size() > 0)
     {
@@ -380,6 +381,9 @@ void Object::resetVisibility(int primitiveIdShift)
         _computeShaderResetVisibility->setAttribute("computePhase", {"resetVisibility"});
     }
 
+    static const auto vertexNbrId = Shader::getUniformId("_vertexNbr");
+    static const auto primitiveIdShiftId = Shader::getUniformId("_primitiveIdShift");
+
     if (_computeShaderResetVisibility)
     {
         for (auto& geom : _geometries)
@@ -387,8 +391,8 @@ void Object::resetVisibility(int primitiveIdShift)
             geom->update();
             geom->activateAsSharedBuffer();
             auto verticesNbr = geom->getVerticesNumber();
-            _computeShaderResetVisibility->setAttribute("uniform", {"_vertexNbr", verticesNbr});
-            _computeShaderResetVisibility->setAttribute("uniform", {"_primitiveIdShift", primitiveIdShift});
+            _computeShaderResetVisibility->setUniform(vertexNbrId, verticesNbr);
+            _computeShaderResetVisibility->setUniform(primitiveIdShiftId, primitiveIdShift);
             _computeShaderResetVisibility->doCompute(verticesNbr / 3 / 128 + 1);
             geom->deactivate();
         }
@@ -406,6 +410,8 @@ void Object::resetBlendingAttribute()
         _computeShaderResetBlendingAttributes->setAttribute("computePhase", {"resetBlending"});
     }
 
+    static const auto vertexNbrId = Shader::getUniformId("_vertexNbr");
+
     if (_computeShaderResetBlendingAttributes)
     {
         for (auto& geom : _geometries)
@@ -413,7 +419,7 @@ void Object::resetBlendingAttribute()
             geom->update();
             geom->activateAsSharedBuffer();
             auto verticesNbr = geom->getVerticesNumber();
-            _computeShaderResetBlendingAttributes->setAttribute("uniform", {"_vertexNbr", verticesNbr});
+            _computeShaderResetBlendingAttributes->setUniform(vertexNbrId, verticesNbr);
             _computeShaderResetBlendingAttributes->doCompute(verticesNbr / 3 / 128 + 1);
             geom->deactivate();
         }
@@ -443,6 +449,15 @@ void Object::tessellateForThisCamera(glm::dmat4 viewMatrix, glm::dmat4 projectio
         _feedbackShaderSubdivideCamera->setAttribute("feedbackVaryings", {"GEOM_OUT.vertex", "GEOM_OUT.texcoord", "GEOM_OUT.normal", "GEOM_OUT.annexe"});
     }
 
+    static const auto blendWidthId = Shader::getUniformId("_blendWidth");
+    static const auto blendPrecisionId = Shader::getUniformId("_blendPrecision");
+    static const auto sidenessId = Shader::getUniformId("_sideness");
+    static const auto fovId = Shader::getUniformId("_fov");
+    static const auto mvId = Shader::getUniformId("_mv");
+    static const auto mvpId = Shader::getUniformId("_mvp");
+    static const auto ipId = Shader::getUniformId("_ip");
+    static const auto mNormalId = Shader::getUniformId("_mNormal");
+
     if (_feedbackShaderSubdivideCamera)
     {
         for (auto& geom : _geometries)
@@ -452,26 +467,22 @@ void Object::tessellateForThisCamera(glm::dmat4 viewMatrix, glm::dmat4 projectio
                 geom->update();
                 geom->activate();
 
-                _feedbackShaderSubdivideCamera->setAttribute("uniform", {"_blendWidth", blendWidth});
-                _feedbackShaderSubdivideCamera->setAttribute("uniform", {"_blendPrecision", blendPrecision});
-                _feedbackShaderSubdivideCamera->setAttribute("uniform", {"_sideness", _sideness});
-                _feedbackShaderSubdivideCamera->setAttribute("uniform", {"_fov", fovX, fovY});
+                _feedbackShaderSubdivideCamera->setUniform(blendWidthId, blendWidth);
+                _feedbackShaderSubdivideCamera->setUniform(blendPrecisionId, blendPrecision);
+                _feedbackShaderSubdivideCamera->setUniform(sidenessId, _sideness);
+                _feedbackShaderSubdivideCamera->setUniform(fovId, glm::vec2(fovX, fovY));
 
                 auto mv = viewMatrix * computeModelMatrix();
-                auto mvAsValues = Values(glm::value_ptr(mv), glm::value_ptr(mv) + 16);
-                _feedbackShaderSubdivideCamera->setAttribute("uniform", {"_mv", mvAsValues});
+                _feedbackShaderSubdivideCamera->setUniform(mvId, glm::mat4(mv));
 
                 auto mvp = projectionMatrix * viewMatrix * computeModelMatrix();
-                auto mvpAsValues = Values(glm::value_ptr(mvp), glm::value_ptr(mvp) + 16);
-                _feedbackShaderSubdivideCamera->setAttribute("uniform", {"_mvp", mvpAsValues});
+                _feedbackShaderSubdivideCamera->setUniform(mvpId, glm::mat4(mvp));
 
                 auto ip = glm::inverse(projectionMatrix);
-                auto ipAsValues = Values(glm::value_ptr(ip), glm::value_ptr(ip) + 16);
-                _feedbackShaderSubdivideCamera->setAttribute("uniform", {"_ip", ipAsValues});
+                _feedbackShaderSubdivideCamera->setUniform(ipId, glm::mat4(ip));
 
                 auto mNormal = projectionMatrix * glm::transpose(glm::inverse(viewMatrix * computeModelMatrix()));
-                auto mNormalAsValues = Values(glm::value_ptr(mNormal), glm::value_ptr(mNormal) + 16);
-                _feedbackShaderSubdivideCamera->setAttribute("uniform", {"_mNormal", mNormalAsValues});
+                _feedbackShaderSubdivideCamera->setUniform(mNormalId, glm::mat4(mNormal));
 
                 geom->activateForFeedback();
                 _feedbackShaderSubdivideCamera->activate();
@@ -501,12 +512,15 @@ void Object::transferVisibilityFromTexToAttr(int width, int height, int primitiv
         _computeShaderTransferVisibilityToAttr->setAttribute("computePhase", {"transferVisibilityToAttr"});
     }
 
+    static const auto texSizeId = Shader::getUniformId("_texSize");
+    static const auto idShiftId = Shader::getUniformId("_idShift");
+
     for (auto& geom : _geometries)
     {
         geom->update();
         geom->activateAsSharedBuffer();
-        _computeShaderTransferVisibilityToAttr->setAttribute("uniform", {"_texSize", (float)width, (float)height});
-        _computeShaderTransferVisibilityToAttr->setAttribute("uniform", {"_idShift", primitiveIdShift});
+        _computeShaderTransferVisibilityToAttr->setUniform(texSizeId, glm::vec2((float)width, (float)height));
+        _computeShaderTransferVisibilityToAttr->setUniform(idShiftId, primitiveIdShift);
         _computeShaderTransferVisibilityToAttr->doCompute(width / 32 + 1, height / 32 + 1);
         glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
         geom->deactivate();
@@ -524,6 +538,12 @@ void Object::computeCameraContribution(glm::dmat4 viewMatrix, glm::dmat4 project
         _computeShaderComputeBlending->setAttribute("computePhase", {"computeCameraContribution"});
     }
 
+    static const auto vertexNbrId = Shader::getUniformId("_vertexNbr");
+    static const auto sidenessId = Shader::getUniformId("_sideness");
+    static const auto blendWidthId = Shader::getUniformId("_blendWidth");
+    static const auto mvpId = Shader::getUniformId("_mvp");
+    static const auto mNormalId = Shader::getUniformId("_mNormal");
+
     if (_computeShaderComputeBlending)
     {
         for (auto& geom : _geometries)
@@ -533,17 +553,15 @@ void Object::computeCameraContribution(glm::dmat4 viewMatrix, glm::dmat4 project
 
             // Set uniforms
             auto verticesNbr = geom->getVerticesNumber();
-            _computeShaderComputeBlending->setAttribute("uniform", {"_vertexNbr", verticesNbr});
-            _computeShaderComputeBlending->setAttribute("uniform", {"_sideness", _sideness});
-            _computeShaderComputeBlending->setAttribute("uniform", {"_blendWidth", blendWidth});
+            _computeShaderComputeBlending->setUniform(vertexNbrId, verticesNbr);
+            _computeShaderComputeBlending->setUniform(sidenessId, _sideness);
+            _computeShaderComputeBlending->setUniform(blendWidthId, blendWidth);
 
             auto mvp = projectionMatrix * viewMatrix * computeModelMatrix();
-            auto mvpAsValues = Values(glm::value_ptr(mvp), glm::value_ptr(mvp) + 16);
-            _computeShaderComputeBlending->setAttribute("uniform", {"_mvp", mvpAsValues});
+            _computeShaderComputeBlending->setUniform(mvpId, glm::mat4(mvp));
 
             auto mNormal = projectionMatrix * glm::transpose(glm::inverse(viewMatrix * computeModelMatrix()));
-            auto mNormalAsValues = Values(glm::value_ptr(mNormal), glm::value_ptr(mNormal) + 16);
-            _computeShaderComputeBlending->setAttribute("uniform", {"_mNormal", mNormalAsValues});
+            _computeShaderComputeBlending->setUniform(mNormalId, glm::mat4(mNormal));
 
             _computeShaderComputeBlending->doCompute(verticesNbr / 3);
 
@@ -585,6 +603,7 @@ void Object::registerAttributes()
         },
         {'n', 'n', 'n'});
     setAttributeDescription("position", "Set the object position");
+    setAttributeParameter("position", true, false, true);
 
     addAttribute("rotation",
         [&](const Values& args) {
@@ -596,6 +615,7 @@ void Object::registerAttributes()
         },
         {'n', 'n', 'n'});
     setAttributeDescription("rotation", "Set the object rotation");
+    setAttributeParameter("rotation", true, false, true);
 
     addAttribute("scale",
         [&](const Values& args) {
@@ -611,6 +631,7 @@ void Object::registerAttributes()
         },
         {'n'});
     setAttributeDescription("scale", "Set the object scale");
+    setAttributeParameter("scale", true, false, true);
 
     addAttribute("sideness",
         [&](const Values& args) {
@@ -1,5 +1,6 @@
 #include "./graphics/shader.h"
 
+#include <algorithm>
 #include <fstream>
 #include <regex>
 
@@ -16,6 +17,10 @@ using namespace std;
 namespace Splash
 {
 
+atomic_ullong Shader::_uniformUploads{0};
+atomic_ullong Shader::_uniformUploadsLastFrame{0};
+atomic_ullong Shader::_uniformUploadsTotal{0};
+
 /*************/
 Shader::Shader(ProgramType type)
     : GraphObject(nullptr)
@@ -278,26 +283,142 @@ void Shader::setTexture(const shared_ptr<Texture>& texture, const GLuint texture
 /*************/
 void Shader::setModelViewProjectionMatrix(const glm::dmat4& mv, const glm::dmat4& mp)
 {
+    static const auto mvpId = getUniformId("_modelViewProjectionMatrix");
+    static const auto mvId = getUniformId("_modelViewMatrix");
+    static const auto mpId = getUniformId("_projectionMatrix");
+    static const auto normalId = getUniformId("_normalMatrix");
+
     glm::mat4 floatMv = (glm::mat4)mv;
     glm::mat4 floatMp = (glm::mat4)mp;
     glm::mat4 floatMvp = (glm::mat4)(mp * mv);
 
-    auto uniformIt = _uniforms.find("_modelViewProjectionMatrix");
-    if (uniformIt != _uniforms.end())
-        if (uniformIt->second.glIndex != -1)
-            glUniformMatrix4fv(uniformIt->second.glIndex, 1, GL_FALSE, glm::value_ptr(floatMvp));
+    // The program is active at this point, so matrices are uploaded right away
+    auto getIndex = [&](UniformId id) -> GLint {
+        auto uniformIt = _uniformsById.find(id);
+        if (uniformIt == _uniformsById.end())
+            return -1;
+        return uniformIt->second->glIndex;
+    };
 
-    if ((uniformIt = _uniforms.find("_modelViewMatrix")) != _uniforms.end())
-        if (uniformIt->second.glIndex != -1)
-            glUniformMatrix4fv(uniformIt->second.glIndex, 1, GL_FALSE, glm::value_ptr(floatMv));
+    GLint index = -1;
+    if ((index = getIndex(mvpId)) != -1)
+    {
+        glUniformMatrix4fv(index, 1, GL_FALSE, glm::value_ptr(floatMvp));
+        _uniformUploads.fetch_add(1, memory_order_relaxed);
+    }
 
-    if ((uniformIt = _uniforms.find("_projectionMatrix")) != _uniforms.end())
-        if (uniformIt->second.glIndex != -1)
-            glUniformMatrix4fv(uniformIt->second.glIndex, 1, GL_FALSE, glm::value_ptr(floatMp));
+    if ((index = getIndex(mvId)) != -1)
+    {
+        glUniformMatrix4fv(index, 1, GL_FALSE, glm::value_ptr(floatMv));
+        _uniformUploads.fetch_add(1, memory_order_relaxed);
+    }
 
-    if ((uniformIt = _uniforms.find("_normalMatrix")) != _uniforms.end())
-        if (uniformIt->second.glIndex != -1)
-            glUniformMatrix4fv(uniformIt->second.glIndex, 1, GL_FALSE, glm::value_ptr(glm::transpose(glm::inverse(floatMv))));
+    if ((index = getIndex(mpId)) != -1)
+    {
+        glUniformMatrix4fv(index, 1, GL_FALSE, glm::value_ptr(floatMp));
+        _uniformUploads.fetch_add(1, memory_order_relaxed);
+    }
+
+    if ((index = getIndex(normalId)) != -1)
+    {
+        glUniformMatrix4fv(index, 1, GL_FALSE, glm::value_ptr(glm::transpose(glm::inverse(floatMv))));
+        _uniformUploads.fetch_add(1, memory_order_relaxed);
+    }
+}
+
+/*************/
+void Shader::setUniform(UniformId id, int value)
+{
+    stageUniform(id, StagedType::integer, nullptr, &value, 1);
+}
+
+/*************/
+void Shader::setUniform(UniformId id, float value)
+{
+    stageUniform(id, StagedType::real, &value, nullptr, 1);
+}
+
+/*************/
+void Shader::setUniform(UniformId id, const glm::ivec2& value)
+{
+    stageUniform(id, StagedType::ivec2, nullptr, glm::value_ptr(value), 2);
+}
+
+/*************/
+void Shader::setUniform(UniformId id, const glm::vec2& value)
+{
+    stageUniform(id, StagedType::vec2, glm::value_ptr(value), nullptr, 2);
+}
+
+/*************/
+void Shader::setUniform(UniformId id, const glm::vec3& value)
+{
+    stageUniform(id, StagedType::vec3, glm::value_ptr(value), nullptr, 3);
+}
+
+/*************/
+void Shader::setUniform(UniformId id, const glm::vec4& value)
+{
+    stageUniform(id, StagedType::vec4, glm::value_ptr(value), nullptr, 4);
+}
+
+/*************/
+void Shader::setUniform(UniformId id, const glm::mat3& value)
+{
+    stageUniform(id, StagedType::mat3, glm::value_ptr(value), nullptr, 9);
+}
+
+/*************/
+void Shader::setUniform(UniformId id, const glm::mat4& value)
+{
+    stageUniform(id, StagedType::mat4, glm::value_ptr(value), nullptr, 16);
+}
+
+/*************/
+void Shader::setUniform(const string& name, const Values& values)
+{
+    // Check if the values changed from previous use
+    auto uniformIt = _uniforms.find(name);
+    if (uniformIt == _uniforms.end())
+        uniformIt = (_uniforms.emplace(make_pair(name, Uniform()))).first;
+    else if (!uniformIt->second.setValues(values))
+        return;
+
+    uniformIt->second.values = values;
+    _uniformsToUpdate.push_back(name);
+}
+
+/*************/
+Shader::Uniform* Shader::getUniform(UniformId id)
+{
+    auto uniformIt = _uniformsById.find(id);
+    if (uniformIt != _uniformsById.end())
+        return uniformIt->second;
+
+    const auto& name = NameRegistry::getInternedName(id);
+    if (name.empty())
+        return nullptr;
+
+    auto uniform = &_uniforms[name];
+    _uniformsById[id] = uniform;
+    return uniform;
+}
+
+/*************/
+void Shader::stageUniform(UniformId id, StagedType type, const float* floats, const int* ints, uint32_t count)
+{
+    auto uniform = getUniform(id);
+    if (!uniform)
+        return;
+
+    if (!uniform->stage(type, floats, ints, count))
+        return;
+
+    if (!uniform->stagedDirty)
+    {
+        uniform->stagedDirty = true;
+        _stagedUniformsToUpdate.push_back(uniform);
+    }
 }
 
 /*************/
@@ -556,6 +677,21 @@ void Shader::parseUniforms(const std::string& src)
                 u.second.glIndex = -1;
         }
     }
+
+    // Locations are resolved here once and for all, typed setters then only go through identifiers.
+    // Staged values are uploaded again, as linking resets the uniforms
+    for (auto& u : _uniforms)
+    {
+        if (u.second.type == "buffer")
+            continue;
+
+        _uniformsById[NameRegistry::intern(u.first)] = &u.second;
+        if (u.second.stagedType != StagedType::none && !u.second.stagedDirty)
+        {
+            u.second.stagedDirty = true;
+            _stagedUniformsToUpdate.push_back(&u.second);
+        }
+    }
 }
 
 /*************/
@@ -702,12 +838,75 @@ void Shader::updateUniforms()
                     }
                 }
             }
+
+            _uniformUploads.fetch_add(1, memory_order_relaxed);
         }
 
         _uniformsToUpdate.clear();
+
+        for (auto uniform : _stagedUniformsToUpdate)
+        {
+            uniform->stagedDirty = false;
+            // Not linked yet, the value will be queued again by parseUniforms
+            if (uniform->glIndex == -1)
+                continue;
+
+            const auto& floats = uniform->stagedFloats;
+            const auto& ints = uniform->stagedInts;
+            switch (uniform->stagedType)
+            {
+            default:
+                continue;
+            case StagedType::integer:
+                glUniform1i(uniform->glIndex, ints[0]);
+                break;
+            case StagedType::ivec2:
+                glUniform2i(uniform->glIndex, ints[0], ints[1]);
+                break;
+            case StagedType::real:
+                glUniform1f(uniform->glIndex, floats[0]);
+                break;
+            case StagedType::vec2:
+                glUniform2fv(uniform->glIndex, 1, floats.data());
+                break;
+            case StagedType::vec3:
+                glUniform3fv(uniform->glIndex, 1, floats.data());
+                break;
+            case StagedType::vec4:
+                glUniform4fv(uniform->glIndex, 1, floats.data());
+                break;
+            case StagedType::mat3:
+                glUniformMatrix3fv(uniform->glIndex, 1, GL_FALSE, floats.data());
+                break;
+            case StagedType::mat4:
+                glUniformMatrix4fv(uniform->glIndex, 1, GL_FALSE, floats.data());
+                break;
+            }
+
+            _uniformUploads.fetch_add(1, memory_order_relaxed);
+        }
+
+        _stagedUniformsToUpdate.clear();
     }
 }
 
+/*************/
+void Shader::markFrameEnd()
+{
+    auto frameUploads = _uniformUploads.exchange(0, memory_order_relaxed);
+    _uniformUploadsLastFrame.store(frameUploads, memory_order_relaxed);
+    _uniformUploadsTotal.fetch_add(frameUploads, memory_order_relaxed);
+}
+
+/*************/
+Shader::UniformUploadStats Shader::getUniformUploadStats()
+{
+    UniformUploadStats stats;
+    stats.lastFrame = _uniformUploadsLastFrame.load(memory_order_relaxed);
+    stats.total = _uniformUploadsTotal.load(memory_order_relaxed) + _uniformUploads.load(memory_order_relaxed);
+    return stats;
+}
+
 /*************/
 void Shader::resetShader(ShaderType type)
 {
@@ -742,16 +941,7 @@ void Shader::registerAttributes()
             uniformArgs = args[1].as<Values>();
         }
 
-        // Check if the values changed from previous use
-        auto uniformIt = _uniforms.find(uniformName);
-        if (uniformIt != _uniforms.end() && Value(uniformArgs) == Value(uniformIt->second.values))
-            return true;
-        else if (uniformIt == _uniforms.end())
-            uniformIt = (_uniforms.emplace(make_pair(uniformName, Uniform()))).first;
-
-        uniformIt->second.values = uniformArgs;
-        _uniformsToUpdate.push_back(uniformName);
-
+        setUniform(uniformName, uniformArgs);
         return true;
     });
 }
@@ -25,6 +25,8 @@
 #ifndef SPLASH_SHADER_H
 #define SPLASH_SHADER_H
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <map>
 #include <memory>
@@ -32,11 +34,14 @@
 #include <unordered_map>
 #include <vector>
 
+#include <glm/glm.hpp>
+
 #include "./config.h"
 
 #include "./core/attribute.h"
 #include "./core/coretypes.h"
 #include "./core/graph_object.h"
+#include "./core/name_registry.h"
 #include "./graphics/texture.h"
 
 namespace Splash
@@ -45,6 +50,92 @@ namespace Splash
 class Shader : public GraphObject
 {
   public:
+    using UniformId = NameId;
+
+    struct UniformUploadStats
+    {
+        uint64_t lastFrame{0}; //!< Number of uniform uploads during the last frame, for all shaders
+        uint64_t total{0};     //!< Number of uniform uploads since the start
+    };
+
+    /**
+     * Type of the value set through the typed setUniform overloads
+     */
+    enum class StagedType
+    {
+        none,
+        integer,
+        ivec2,
+        real,
+        vec2,
+        vec3,
+        vec4,
+        mat3,
+        mat4
+    };
+
+    /**
+     * Uniform state, as set through either the Values or the typed setUniform overloads
+     * Each setter invalidates the value cached by the other one, so that the last set value is the one uploaded
+     */
+    struct Uniform
+    {
+        std::string type{""};
+        uint32_t elementSize{1};
+        uint32_t arraySize{0};
+        Values values{};
+        GLint glIndex{-1};
+        GLuint glBuffer{0};
+        bool glBufferReady{false};
+
+        StagedType stagedType{StagedType::none}; //!< Type of the value set through setUniform
+        std::array<float, 16> stagedFloats{};    //!< Staged floating point value
+        std::array<int, 2> stagedInts{};         //!< Staged integer value
+        bool stagedDirty{false};                 //!< True if the staged value is waiting to be uploaded
+
+        /**
+         * \brief Set the value from Values
+         * \param newValues Values to set
+         * \return Return true if the value differs from the last one set, and has to be uploaded
+         */
+        bool setValues(const Values& newValues)
+        {
+            if (stagedType == StagedType::none && Value(newValues) == Value(values))
+                return false;
+            values = newValues;
+            stagedType = StagedType::none;
+            return true;
+        }
+
+        /**
+         * \brief Set the value from a typed value
+         * \param type Value type
+         * \param floats Floating point components, or nullptr if the type is integral
+         * \param ints Integer components, or nullptr if the type is floating point
+         * \param count Component count
+         * \return Return true if the value differs from the last one set, and has to be uploaded
+         */
+        bool stage(StagedType type, const float* floats, const int* ints, uint32_t count)
+        {
+            bool changed = stagedType != type;
+            if (floats)
+            {
+                changed = changed || !std::equal(floats, floats + count, stagedFloats.begin());
+                std::copy(floats, floats + count, stagedFloats.begin());
+            }
+            else
+            {
+                changed = changed || !std::equal(ints, ints + count, stagedInts.begin());
+                std::copy(ints, ints + count, stagedInts.begin());
+            }
+
+            if (!changed)
+                return false;
+            values.clear();
+            stagedType = type;
+            return true;
+        }
+    };
     enum ProgramType
     {
         prgGraphic = 0,
@@ -182,11 +273,51 @@ class Shader : public GraphObject
      */
     void setModelViewProjectionMatrix(const glm::dmat4& mv, const glm::dmat4& mp);
 
+    /**
+     * \brief Get the identifier of a uniform, to be kept by the caller for use with setUniform
+     * \param name Uniform name
+     * \return Return the identifier, which is the same for all shaders
+     */
+    static UniformId getUniformId(const std::string& name) { return NameRegistry::intern(name); }
+
+    /**
+     * \brief Set a uniform from a typed value. The value is staged and uploaded on the next call to updateUniforms, if it changed
+     * Uniforms set this way do not show in getUniforms
+     * \param id Uniform identifier
+     * \param value Uniform value
+     */
+    void setUniform(UniformId id, int value);
+    void setUniform(UniformId id, float value);
+    void setUniform(UniformId id, const glm::ivec2& value);
+    void setUniform(UniformId id, const glm::vec2& value);
+    void setUniform(UniformId id, const glm::vec3& value);
+    void setUniform(UniformId id, const glm::vec4& value);
+    void setUniform(UniformId id, const glm::mat3& value);
+    void setUniform(UniformId id, const glm::mat4& value);
+
+    /**
+     * \brief Set a uniform from generic values, which is what the "uniform" attribute does
+     * \param name Uniform name
+     * \param values Uniform values
+     */
+    void setUniform(const std::string& name, const Values& values);
+
     /**
      * \brief Set the currently queued uniforms updates
      */
     void updateUniforms();
 
+    /**
+     * \brief Mark the end of a frame for the uniform upload counter
+     */
+    static void markFrameEnd();
+
+    /**
+     * \brief Get the uniform upload counters
+     * \return Return the counters
+     */
+    static UniformUploadStats getUniformUploadStats();
+
   private:
     mutable std::mutex _mutex;
     std::atomic_bool _activated{false};
@@ -197,19 +328,15 @@ class Shader : public GraphObject
     GLuint _program{0};
     bool _isLinked = {false};
 
-    struct Uniform
-    {
-        std::string type{""};
-        uint32_t elementSize{1};
-        uint32_t arraySize{0};
-        Values values{};
-        GLint glIndex{-1};
-        GLuint glBuffer{0};
-        bool glBufferReady{false};
-    };
     std::map<std::string, Uniform> _uniforms;
     std::unordered_map<std::string, std::string> _uniformsDocumentation;
     std::vector<std::string> _uniformsToUpdate;
+    std::unordered_map<UniformId, Uniform*> _uniformsById{}; //!< Uniforms by identifier, pointing into _uniforms
+    std::vector<Uniform*> _stagedUniformsToUpdate{};         //!< Uniforms with a staged value to upload
+
+    static std::atomic_ullong _uniformUploads;          //!< Uniform uploads during the current frame
+    static std::atomic_ullong _uniformUploadsLastFrame; //!< Uniform uploads during the last frame
+    static std::atomic_ullong _uniformUploadsTotal;     //!< Uniform uploads since the start
     std::vector<std::shared_ptr<Texture>> _textures; // Currently used textures
     std::string _currentProgramName{};
 
@@ -240,6 +367,23 @@ class Shader : public GraphObject
      */
     void parseUniforms(const std::string& src);
 
+    /**
+     * \brief Get a uniform from its identifier, creating it if needed so that it is set once the program is linked
+     * \param id Uniform identifier
+     * \return Return a pointer to the uniform
+     */
+    Uniform* getUniform(UniformId id);
+
+    /**
+     * \brief Stage a typed uniform value
+     * \param id Uniform identifier
+     * \param type Value type
+     * \param floats Floating point values, or nullptr
+     * \param ints Integer values, or nullptr
+     * \param count Number of values
+     */
+    void stageUniform(UniformId id, StagedType type, const float* floats, const int* ints, uint32_t count);
+
     /**
      * \brief Get a string expression of the shader type, used for logging
      * \param type Shader type
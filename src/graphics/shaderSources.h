@@ -144,6 +144,31 @@ struct ShaderSources
                 yuv = pow(yuv, vec3(2.2));
                 return yuv;
             }
+
+            // Conversion for planar formats, which are not stored with a gamma applied
+            // matrix: 0 = BT.601, 1 = BT.709, 2 = BT.2020
+            vec3 yuv2rgb(vec3 yuv, int matrix, bool fullRange)
+            {
+                if (fullRange)
+                    yuv -= vec3(0.0, 0.5, 0.5);
+                else
+                    yuv = (yuv - vec3(16.0, 128.0, 128.0) / 255.0) * vec3(255.0 / 219.0, 255.0 / 224.0, 255.0 / 224.0);
+
+                // Red and blue luma coefficients
+                vec2 k = vec2(0.299, 0.114);
+                if (matrix == 1)
+                    k = vec2(0.2126, 0.0722);
+                else if (matrix == 2)
+                    k = vec2(0.2627, 0.0593);
+                float kg = 1.0 - k.x - k.y;
+
+                vec3 rgb = vec3(yuv.x + 2.0 * (1.0 - k.x) * yuv.z,
+                                yuv.x - (2.0 * k.y * (1.0 - k.y) * yuv.y + 2.0 * k.x * (1.0 - k.x) * yuv.z) / kg,
+                                yuv.x + 2.0 * (1.0 - k.y) * yuv.y);
+                rgb = clamp(rgb, vec3(0.0), vec3(1.0));
+                rgb = pow(rgb, vec3(2.2));
+                return rgb;
+            }
         )"},
         //
         // Color correction: brightness, saturation and contrast
@@ -843,7 +868,10 @@ struct ShaderSources
         uniform int _tex0_flop = 0;
         // Format specific parameters
         uniform int _tex0_YCoCg = 0;
-        uniform int _tex0_YUV = 0; // 1 = UYVY, 2 = YUYV
+        uniform int _tex0_YUV = 0; // 1 = UYVY, 2 = YUYV, 3 = YUV420P, 4 = NV12, 5 = YUV422P
+        uniform int _tex0_yuvMatrix = 0;
+        uniform int _tex0_yuvFullRange = 0;
+        uniform float _tex0_yuvScale = 1.0;
 
         // Film uniforms
         uniform float _filmDuration = 0.f;
@@ -910,7 +938,7 @@ struct ShaderSources
             }
 
             // If the color format is YUYV
-            if (_tex0_YUV > 0)
+            if (_tex0_YUV == 1 || _tex0_YUV == 2)
             {
                 // Texture coord rounded to the closer even pixel
                 ivec2 yuyvCoords = ivec2((int(realCoords.x * _tex0_size.x) / 2) * 2, int(realCoords.y * _tex0_size.y));
@@ -926,6 +954,38 @@ struct ShaderSources
                 else // Odd pixel
                     color.rgb = yuv2rgb(yuyv.bga);
             }
+            // If the color format is planar, the planes are stacked in a single channel texture
+            else if (_tex0_YUV >= 3)
+            {
+                ivec2 size = ivec2(_tex0_size);
+                ivec2 pixel = min(ivec2(realCoords * _tex0_size), size - ivec2(1));
+                vec3 yuv;
+                yuv.x = texelFetch(_tex0, pixel, 0).r;
+
+                // Chroma planes rows do not match the texture rows, their samples are addressed linearly
+                int lumaSize = size.x * size.y;
+                // Odd sizes are rounded up, as for the packed planes
+                int chromaWidth = (size.x + 1) / 2;
+                int chromaHeight = _tex0_YUV == 5 ? size.y : (size.y + 1) / 2;
+                ivec2 chromaPixel = ivec2(pixel.x / 2, _tex0_YUV == 5 ? pixel.y : pixel.y / 2);
+
+                int uIndex, vIndex;
+                if (_tex0_YUV == 4)
+                {
+                    uIndex = lumaSize + chromaPixel.y * chromaWidth * 2 + chromaPixel.x * 2;
+                    vIndex = uIndex + 1;
+                }
+                else
+                {
+                    uIndex = lumaSize + chromaPixel.y * chromaWidth + chromaPixel.x;
+                    vIndex = uIndex + chromaWidth * chromaHeight;
+                }
+
+                yuv.y = texelFetch(_tex0, ivec2(uIndex % size.x, uIndex / size.x), 0).r;
+                yuv.z = texelFetch(_tex0, ivec2(vIndex % size.x, vIndex / size.x), 0).r;
+                color.rgb = yuv2rgb(yuv * _tex0_yuvScale, _tex0_yuvMatrix, _tex0_yuvFullRange == 1);
+                color.a = 1.0;
+            }
             
             // Invert channels
             if (_invertChannels == 1)
@@ -7,12 +7,18 @@
 #include "./utils/timer.h"
 
 #define SPLASH_TEXTURE_COPY_THREADS 2
+// The image holds up to three slots (shown, next and being received), one is filled by the copy threads,
+// and the others wait for the GPU to be done uploading from them
+#define SPLASH_TEXTURE_PBO_RING_SIZE 6
 
 using namespace std;
 
 namespace Splash
 {
 
+list<shared_ptr<Texture_Image::StagingRing>> Texture_Image::_orphanStagingRings{};
+mutex Texture_Image::_orphanStagingRingsMutex{};
+
 /*************/
 Texture_Image::Texture_Image(RootObject* root)
     : Texture(root)
@@ -39,14 +45,29 @@ Texture_Image::~Texture_Image()
 #endif
 
     lock_guard<mutex> lock(_mutex);
+    flushPbo();
+
+    // The image must not keep buffers in the staging slots, which are about to be deleted
+    auto img = _img.lock();
+    if (img)
+        img->removeStagingAllocator(this);
+
     glDeleteTextures(1, &_glTex);
-    glDeleteBuffers(2, _pbos);
+
+    // Serialized objects may still point to the mapped memory of the slots, in which case the ring is kept until released
+    retireStagingRing();
+    deleteUnusedStagingRings(_retiredStagingRings);
+    if (!_retiredStagingRings.empty())
+    {
+        lock_guard<mutex> lockOrphans(_orphanStagingRingsMutex);
+        _orphanStagingRings.splice(_orphanStagingRings.end(), _retiredStagingRings);
+    }
 }
 
 /*************/
 Texture_Image& Texture_Image::operator=(const shared_ptr<Image>& img)
 {
-    _img = weak_ptr<Image>(img);
+    setSourceImage(img);
     return *this;
 }
 
@@ -104,7 +125,7 @@ bool Texture_Image::linkTo(const std::shared_ptr<GraphObject>& obj)
     {
         auto img = dynamic_pointer_cast<Image>(obj);
         img->setDirty();
-        _img = weak_ptr<Image>(img);
+        setSourceImage(img);
         return true;
     }
 
@@ -288,6 +309,8 @@ GLenum Texture_Image::getChannelOrder(const ImageBufferSpec& spec)
         glChannelOrder = GL_RGBA;
     else if (spec.format == "YUYV" || spec.format == "UYVY")
         glChannelOrder = GL_RG;
+    else if (spec.isPlanarYUV())
+        glChannelOrder = GL_RED;
     else if (spec.channels == 1)
         glChannelOrder = GL_RED;
     else if (spec.channels == 3)
@@ -298,6 +321,26 @@ GLenum Texture_Image::getChannelOrder(const ImageBufferSpec& spec)
     return glChannelOrder;
 }
 
+/*************/
+void Texture_Image::setSourceImage(const shared_ptr<Image>& img)
+{
+    lock_guard<mutex> lock(_mutex);
+    auto previousImg = _img.lock();
+    if (previousImg && previousImg != img)
+        previousImg->removeStagingAllocator(this);
+
+    _img = weak_ptr<Image>(img);
+    if (!img)
+        return;
+
+    // Images received by the Scene are then written straight to the staging slots
+    img->setStagingAllocator(this, [this](const ImageBufferSpec& spec) { return acquireStagingBuffer(spec); });
+
+    _imgSrgb = img->getAttributeHandle<bool>("srgb");
+    _imgFlip = img->getAttributeHandle<bool>("flip");
+    _imgFlop = img->getAttributeHandle<bool>("flop");
+}
+
 /*************/
 void Texture_Image::update()
 {
@@ -321,10 +364,7 @@ void Texture_Image::update()
     }
 
     auto spec = img->getSpec();
-    Values srgb, flip, flop;
-    img->getAttribute("srgb", srgb);
-    img->getAttribute("flip", flip);
-    img->getAttribute("flop", flop);
+    auto srgb = _imgSrgb.get();
 
     // Store the image data size
     int imageDataSize = spec.rawSize();
@@ -348,15 +388,30 @@ void Texture_Image::update()
         isCompressed = true;
     }
 
+    // Planar YUV images are uploaded as a single channel texture, the chroma planes following the luma plane.
+    // With odd sizes the planes do not end on a texture row, the last row is then only partially filled
+    bool isPlanar = spec.isPlanarYUV();
+    int sampleBytes = spec.type == ImageBufferSpec::Type::UINT16 ? 2 : 1;
+    uint32_t sampleCount = imageDataSize / sampleBytes;
+    uint32_t textureHeight = isPlanar ? (sampleCount + spec.width - 1) / spec.width : spec.height;
+    // Mipmaps of the stacked planes would mix luma and chroma, so planar textures only have one level.
+    // The Filter converting them to RGB generates the mipmaps of its output instead
+    int textureLevels = isPlanar ? 1 : _texLevels;
+
     // Get GL parameters
     GLenum internalFormat;
     GLenum dataFormat = GL_UNSIGNED_BYTE;
     if (!isCompressed)
     {
-        if (spec.channels == 4 && spec.type == ImageBufferSpec::Type::UINT8)
+        if (isPlanar)
+        {
+            dataFormat = sampleBytes == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_BYTE;
+            internalFormat = sampleBytes == 2 ? GL_R16 : GL_R8;
+        }
+        else if (spec.channels == 4 && spec.type == ImageBufferSpec::Type::UINT8)
         {
             dataFormat = GL_UNSIGNED_INT_8_8_8_8_REV;
-            if (srgb[0].as<int>() > 0)
+            if (srgb)
                 internalFormat = GL_SRGB8_ALPHA8;
             else
                 internalFormat = GL_RGBA;
@@ -364,7 +419,7 @@ void Texture_Image::update()
         else if (spec.channels == 3 && spec.type == ImageBufferSpec::Type::UINT8)
         {
             dataFormat = GL_UNSIGNED_BYTE;
-            if (srgb[0].as<int>() > 0)
+            if (srgb)
                 internalFormat = GL_SRGB8_ALPHA8;
             else
                 internalFormat = GL_RGBA;
@@ -389,14 +444,14 @@ void Texture_Image::update()
     {
         if (spec.format == "RGB_DXT1")
         {
-            if (srgb[0].as<int>() > 0)
+            if (srgb)
                 internalFormat = GL_COMPRESSED_SRGB_S3TC_DXT1_EXT;
             else
                 internalFormat = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
         }
         else if (spec.format == "RGBA_DXT5")
         {
-            if (srgb[0].as<int>() > 0)
+            if (srgb)
                 internalFormat = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT;
             else
                 internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
@@ -412,6 +467,25 @@ void Texture_Image::update()
         }
     }
 
+    // Uncompressed pixels are uploaded from the image, or from a staging buffer when pixels is an offset in it
+    auto uploadPixels = [&](const void* pixels) {
+        if (!isPlanar)
+        {
+            glTextureSubImage2D(_glTex, 0, 0, 0, spec.width, textureHeight, glChannelOrder, dataFormat, pixels);
+            return;
+        }
+
+        uint32_t fullRows = sampleCount / spec.width;
+        glTextureSubImage2D(_glTex, 0, 0, 0, spec.width, fullRows, glChannelOrder, dataFormat, pixels);
+        if (sampleCount % spec.width != 0)
+            glTextureSubImage2D(_glTex, 0, 0, fullRows, sampleCount % spec.width, 1, glChannelOrder, dataFormat,
+                reinterpret_cast<const void*>(reinterpret_cast<uintptr_t>(pixels) + static_cast<uintptr_t>(fullRows) * spec.width * sampleBytes));
+    };
+
+    // Planes rows are tightly packed
+    if (isPlanar)
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
     // Update the textures if the format changed
     if (spec != _spec || !spec.videoFrame)
     {
@@ -424,7 +498,7 @@ void Texture_Image::update()
 
         if (_filtering)
         {
-            if (isCompressed)
+            if (isCompressed || isPlanar)
                 glTextureParameteri(_glTex, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
             else
                 glTextureParameteri(_glTex, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
@@ -443,8 +517,8 @@ void Texture_Image::update()
             Log::get() << Log::DEBUGGING << "Texture_Image::" << __FUNCTION__ << " - Creating a new texture" << Log::endl;
 #endif
             img->lockWrite();
-            glTextureStorage2D(_glTex, _texLevels, internalFormat, spec.width, spec.height);
-            glTextureSubImage2D(_glTex, 0, 0, 0, spec.width, spec.height, glChannelOrder, dataFormat, img->data());
+            glTextureStorage2D(_glTex, textureLevels, internalFormat, spec.width, textureHeight);
+            uploadPixels(img->data());
             img->unlockWrite();
         }
         else if (isCompressed)
@@ -454,58 +528,114 @@ void Texture_Image::update()
 #endif
 
             img->lockWrite();
-            glTextureStorage2D(_glTex, _texLevels, internalFormat, spec.width, spec.height);
+            glTextureStorage2D(_glTex, _texLevels, internalFormat, spec.width, textureHeight);
             glCompressedTextureSubImage2D(_glTex, 0, 0, 0, spec.width, spec.height, internalFormat, imageDataSize, img->data());
             img->unlockWrite();
         }
 
-        if (!updatePbos(spec.width, spec.height, spec.pixelBytes()))
-            return;
-
-        // Fill one of the PBOs right now
-        auto pixels = _pbosPixels[0];
-        if (pixels != NULL)
+        // Static images do not need staging buffers
+        if (!spec.videoFrame)
+            retireStagingRing();
+        else if (!updatePbos(imageDataSize))
         {
-            img->lockWrite();
-            memcpy((void*)pixels, img->data(), imageDataSize);
-            img->unlockWrite();
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            return;
         }
 
-        // And copy it to the second PBO
-        glCopyNamedBufferSubData(_pbos[0], _pbos[1], 0, 0, imageDataSize);
         _spec = spec;
     }
     // Update the content of the texture, i.e the image
     else
     {
-        // Copy the pixels from the current PBO to the texture
-        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pbos[_pboUploadIndex]);
-        if (!isCompressed)
-            glTextureSubImage2D(_glTex, 0, 0, 0, spec.width, spec.height, glChannelOrder, dataFormat, 0);
-        else
-            glCompressedTextureSubImage2D(_glTex, 0, 0, 0, spec.width, spec.height, internalFormat, imageDataSize, 0);
-        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        auto uploadFromSlot = [&](int index) {
+            lock_guard<mutex> lockRing(_stagingRing->mutex);
+            auto& slot = _stagingRing->slots[index];
 
-        _pboUploadIndex = (_pboUploadIndex + 1) % 2;
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.pbo);
+            if (!isCompressed)
+                uploadPixels(nullptr);
+            else
+                glCompressedTextureSubImage2D(_glTex, 0, 0, 0, spec.width, spec.height, internalFormat, imageDataSize, 0);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+            // The slot is not written to again until the GPU is done reading it
+            if (slot.fence)
+                glDeleteSync(slot.fence);
+            slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        };
+
+        auto releaseCopySlot = [&]() {
+            lock_guard<mutex> lockRing(_stagingRing->mutex);
+            _stagingRing->slots[_pboCopySlot].acquired = false;
+            _pboCopySlot = -1;
+        };
+
+        if (_stagingRing)
+            recycleStagingSlots(*_stagingRing);
+
+        // The image must not give its slot back before the upload has been issued
+        img->lockWrite();
+        auto stagingIndex = findStagingSlot(img->data());
+        if (stagingIndex >= 0)
+        {
+            // The image has been written straight to a staging slot, no copy needed
+            if (_pboCopySlot >= 0)
+                releaseCopySlot();
+            uploadFromSlot(stagingIndex);
+        }
+        img->unlockWrite();
 
-        // Fill the next PBO with the image pixels
-        auto pixels = _pbosPixels[_pboUploadIndex];
-        if (pixels != NULL)
+        if (stagingIndex < 0 && _stagingRing)
         {
-            img->lockWrite();
+            // Copy the pixels from the slot filled during the previous update to the texture
+            if (_pboCopySlot >= 0)
+            {
+                uploadFromSlot(_pboCopySlot);
+                releaseCopySlot();
+            }
 
-            int stride = SPLASH_TEXTURE_COPY_THREADS;
-            int size = imageDataSize;
-            for (int i = 0; i < stride - 1; ++i)
+            // Fill the next slot with the image pixels
+            {
+                lock_guard<mutex> lockRing(_stagingRing->mutex);
+                _pboCopySlot = acquireStagingSlot(*_stagingRing);
+            }
+
+            if (_pboCopySlot >= 0)
+            {
+                auto pixels = _stagingRing->slots[_pboCopySlot].pixels;
+                img->lockWrite();
+
+                int stride = SPLASH_TEXTURE_COPY_THREADS;
+                int size = imageDataSize;
+                for (int i = 0; i < stride - 1; ++i)
+                    _pboCopyTasks.run([=]() { copy((char*)img->data() + size / stride * i, (char*)img->data() + size / stride * (i + 1), (char*)pixels + size / stride * i); });
+                _pboCopyTasks.run([=]() { copy((char*)img->data() + size / stride * (stride - 1), (char*)img->data() + size, (char*)pixels + size / stride * (stride - 1)); });
+                _pboCopyPending = true;
+            }
+            else
             {
-                _pboCopyThreads.push_back(
-                    async(launch::async, [=]() { copy((char*)img->data() + size / stride * i, (char*)img->data() + size / stride * (i + 1), (char*)pixels + size / stride * i); }));
+                // All slots are held by the image or still read by the GPU, so the image is uploaded directly
+                img->lockWrite();
+                if (!isCompressed)
+                    uploadPixels(img->data());
+                else
+                    glCompressedTextureSubImage2D(_glTex, 0, 0, 0, spec.width, spec.height, internalFormat, imageDataSize, img->data());
+                img->unlockWrite();
             }
-            _pboCopyThreads.push_back(
-                async(launch::async, [=]() { copy((char*)img->data() + size / stride * (stride - 1), (char*)img->data() + size, (char*)pixels + size / stride * (stride - 1)); }));
         }
     }
 
+    // Retired rings are deleted once the GPU and the images are done with them
+    deleteUnusedStagingRings(_retiredStagingRings);
+    {
+        unique_lock<mutex> lockOrphans(_orphanStagingRingsMutex, try_to_lock);
+        if (lockOrphans.owns_lock())
+            deleteUnusedStagingRings(_orphanStagingRings);
+    }
+
+    if (isPlanar)
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
     // If needed, specify some uniforms for the shader which will use this texture
     _shaderUniforms.clear();
     if (spec.format == "YCoCg_DXT5")
@@ -517,23 +647,38 @@ void Texture_Image::update()
         _shaderUniforms["YUV"] = {1};
     else if (spec.format == "YUYV")
         _shaderUniforms["YUV"] = {2};
+    else if (spec.format == "YUV420P" || spec.format == "YUV420P10")
+        _shaderUniforms["YUV"] = {3};
+    else if (spec.format == "NV12")
+        _shaderUniforms["YUV"] = {4};
+    else if (spec.format == "YUV422P" || spec.format == "YUV422P10")
+        _shaderUniforms["YUV"] = {5};
     else
         _shaderUniforms["YUV"] = {0};
 
-    _shaderUniforms["flip"] = flip;
-    _shaderUniforms["flop"] = flop;
+    if (isPlanar)
+    {
+        _shaderUniforms["yuvMatrix"] = {static_cast<int>(spec.colorMatrix)};
+        _shaderUniforms["yuvFullRange"] = {spec.fullRange};
+        // 10 bits samples are stored in the low bits of 16 bits values
+        _shaderUniforms["yuvScale"] = {spec.format.find("10") != string::npos ? 65535.f / 1023.f : 1.f};
+    }
+
+    _shaderUniforms["flip"] = {_imgFlip.get()};
+    _shaderUniforms["flop"] = {_imgFlop.get()};
     _shaderUniforms["size"] = {(float)_spec.width, (float)_spec.height};
 
-    if (_filtering && !isCompressed)
+    if (_filtering && !isCompressed && !isPlanar)
         generateMipmap();
 }
 
 /*************/
 void Texture_Image::flushPbo()
 {
-    if (!_pboCopyThreads.empty())
+    if (_pboCopyPending)
     {
-        _pboCopyThreads.clear(); // This waits for the threaded copies to finish
+        _pboCopyTasks.wait();
+        _pboCopyPending = false;
         if (!_img.expired())
             _img.lock()->unlockWrite();
     }
@@ -553,27 +698,163 @@ void Texture_Image::init()
 }
 
 /*************/
-bool Texture_Image::updatePbos(int width, int height, int bytes)
+bool Texture_Image::updatePbos(int imageDataSize)
 {
-    glDeleteBuffers(2, _pbos);
+    retireStagingRing();
 
     auto flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
-    auto imageDataSize = width * height * bytes;
 
-    glCreateBuffers(2, _pbos);
-    glNamedBufferStorage(_pbos[0], imageDataSize, 0, flags);
-    glNamedBufferStorage(_pbos[1], imageDataSize, 0, flags);
+    auto ring = make_shared<StagingRing>();
+    ring->slotSize = imageDataSize;
+    ring->slots.resize(SPLASH_TEXTURE_PBO_RING_SIZE);
+    for (auto& slot : ring->slots)
+    {
+        glCreateBuffers(1, &slot.pbo);
+        glNamedBufferStorage(slot.pbo, imageDataSize, 0, flags);
+        slot.pixels = (GLubyte*)glMapNamedBufferRange(slot.pbo, 0, imageDataSize, flags);
 
-    _pbosPixels[0] = (GLubyte*)glMapNamedBufferRange(_pbos[0], 0, imageDataSize, flags);
-    _pbosPixels[1] = (GLubyte*)glMapNamedBufferRange(_pbos[1], 0, imageDataSize, flags);
+        if (!slot.pixels)
+        {
+            Log::get() << Log::ERROR << "Texture_Image::" << __FUNCTION__ << " - Unable to initialize upload PBOs" << Log::endl;
+            deleteStagingRing(*ring);
+            return false;
+        }
+    }
+
+    lock_guard<Spinlock> lock(_stagingRingMutex);
+    _stagingRing = ring;
 
-    if (!_pbosPixels[0] || !_pbosPixels[1])
+    return true;
+}
+
+/*************/
+ImageBuffer Texture_Image::acquireStagingBuffer(const ImageBufferSpec& spec)
+{
+    shared_ptr<StagingRing> ring;
     {
-        Log::get() << Log::ERROR << "Texture_Image::" << __FUNCTION__ << " - Unable to initialize upload PBOs" << Log::endl;
-        return false;
+        lock_guard<Spinlock> lock(_stagingRingMutex);
+        ring = _stagingRing;
     }
 
-    return true;
+    auto size = static_cast<size_t>(spec.rawSize());
+    if (!ring || size == 0 || size > ring->slotSize)
+        return {};
+
+    lock_guard<mutex> lockRing(ring->mutex);
+    auto index = acquireStagingSlot(*ring);
+    if (index < 0)
+        return {};
+
+    // The slot is given back when the image buffer is destroyed. The ring is held until then
+    auto pixels = reinterpret_cast<char*>(ring->slots[index].pixels);
+    auto buffer = ResizableArray<char>(pixels, pixels + size, [ring, index](char*) {
+        lock_guard<mutex> lockRing(ring->mutex);
+        ring->slots[index].acquired = false;
+    });
+
+    return ImageBuffer(spec, std::move(buffer));
+}
+
+/*************/
+int Texture_Image::acquireStagingSlot(StagingRing& ring)
+{
+    for (size_t i = 0; i < ring.slots.size(); ++i)
+    {
+        auto& slot = ring.slots[i];
+        if (slot.acquired || slot.fence)
+            continue;
+        slot.acquired = true;
+        return static_cast<int>(i);
+    }
+
+    return -1;
+}
+
+/*************/
+int Texture_Image::findStagingSlot(const void* data)
+{
+    if (!_stagingRing || !data)
+        return -1;
+
+    lock_guard<mutex> lockRing(_stagingRing->mutex);
+    for (size_t i = 0; i < _stagingRing->slots.size(); ++i)
+        if (_stagingRing->slots[i].pixels == data && static_cast<int>(i) != _pboCopySlot)
+            return static_cast<int>(i);
+
+    return -1;
+}
+
+/*************/
+bool Texture_Image::recycleStagingSlots(StagingRing& ring)
+{
+    lock_guard<mutex> lockRing(ring.mutex);
+    bool isFree = true;
+    for (auto& slot : ring.slots)
+    {
+        if (slot.fence)
+        {
+            auto status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+            if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED)
+            {
+                glDeleteSync(slot.fence);
+                slot.fence = nullptr;
+            }
+        }
+
+        if (slot.acquired || slot.fence)
+            isFree = false;
+    }
+
+    return isFree;
+}
+
+/*************/
+void Texture_Image::deleteStagingRing(StagingRing& ring)
+{
+    lock_guard<mutex> lockRing(ring.mutex);
+    for (auto& slot : ring.slots)
+    {
+        if (slot.fence)
+            glDeleteSync(slot.fence);
+        if (slot.pbo)
+            glDeleteBuffers(1, &slot.pbo);
+        slot = StagingSlot();
+    }
+}
+
+/*************/
+void Texture_Image::retireStagingRing()
+{
+    if (!_stagingRing)
+        return;
+
+    if (_pboCopySlot >= 0)
+    {
+        lock_guard<mutex> lockRing(_stagingRing->mutex);
+        _stagingRing->slots[_pboCopySlot].acquired = false;
+        _pboCopySlot = -1;
+    }
+
+    lock_guard<Spinlock> lock(_stagingRingMutex);
+    _retiredStagingRings.push_back(_stagingRing);
+    _stagingRing.reset();
+}
+
+/*************/
+void Texture_Image::deleteUnusedStagingRings(list<shared_ptr<StagingRing>>& rings)
+{
+    for (auto ringIt = rings.begin(); ringIt != rings.end();)
+    {
+        if (recycleStagingSlots(**ringIt))
+        {
+            deleteStagingRing(**ringIt);
+            ringIt = rings.erase(ringIt);
+        }
+        else
+        {
+            ++ringIt;
+        }
+    }
 }
 
 /*************/
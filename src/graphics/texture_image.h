@@ -26,15 +26,18 @@
 #define SPLASH_TEXTURE_IMAGE_H
 
 #include <chrono>
-#include <future>
 #include <glm/glm.hpp>
 #include <list>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include "./config.h"
 
 #include "./core/attribute.h"
 #include "./core/coretypes.h"
+#include "./core/spinlock.h"
+#include "./core/thread_pool.h"
 #include "./graphics/texture.h"
 #include "./image/image.h"
 #include "./utils/cgutils.h"
@@ -171,14 +174,42 @@ class Texture_Image : public Texture
     void update() final;
 
   private:
+    /**
+     * Persistently mapped pixel buffer the texture is uploaded from
+     */
+    struct StagingSlot
+    {
+        GLuint pbo{0};
+        GLubyte* pixels{nullptr};
+        GLsync fence{nullptr}; //!< Set after each upload from the slot, until the GPU is done reading it
+        bool acquired{false};  //!< True while the slot is written to, or held by an image
+    };
+
+    /**
+     * Ring of staging slots, shared with the image buffers written to them
+     */
+    struct StagingRing
+    {
+        std::mutex mutex{};
+        size_t slotSize{0};
+        std::vector<StagingSlot> slots{};
+    };
+
     GLuint _glTex{0};
-    GLuint _pbos[2];
-    GLubyte* _pbosPixels[2];
 
     int _multisample{0};
     bool _cubemap{false};
-    int _pboUploadIndex{0};
-    std::list<std::future<void>> _pboCopyThreads;
+
+    std::shared_ptr<StagingRing> _stagingRing{nullptr};
+    std::list<std::shared_ptr<StagingRing>> _retiredStagingRings{}; //!< Rings replaced after a format change, kept until nothing uses them anymore
+    Spinlock _stagingRingMutex{};                                   //!< Protects _stagingRing, which the staging allocator reads from other threads
+    int _pboCopySlot{-1};                                           //!< Slot filled by the copy threads, uploaded at the next update
+    TaskGroup _pboCopyTasks{};                                      //!< Copies of the image to the staging slot, run on the thread pool
+    bool _pboCopyPending{false};                                    //!< True if copies were started and not waited for yet
+
+    // Rings still referenced by image buffers when their texture was destroyed, deleted by the other textures once unused
+    static std::list<std::shared_ptr<StagingRing>> _orphanStagingRings;
+    static std::mutex _orphanStagingRingsMutex;
 
     // Store some texture parameters
     static constexpr int _texLevels{4};
@@ -192,10 +223,19 @@ class Texture_Image : public Texture
     GLint _activeTexture{0}; // Texture unit to which the texture is bound
 
     std::weak_ptr<Image> _img;
+    AttributeHandle<bool> _imgSrgb{}; //!< Handles to the attributes of _img read at each update
+    AttributeHandle<bool> _imgFlip{};
+    AttributeHandle<bool> _imgFlop{};
 
     // Parameters to send to the shader
     std::unordered_map<std::string, Values> _shaderUniforms;
 
+    /**
+     * \brief Set the image this texture is updated from
+     * \param img Source image
+     */
+    void setSourceImage(const std::shared_ptr<Image>& img);
+
     /**
      * \brief Initialization
      */
@@ -210,12 +250,55 @@ class Texture_Image : public Texture
 
     /**
      * \brief Update the pbos according to the parameters
-     * \param width Width
-     * \param height Height
-     * \param bytes Bytes per pixel
+     * \param imageDataSize Size of the images to upload, in bytes
      * \return Return true if all went well
      */
-    bool updatePbos(int width, int height, int bytes);
+    bool updatePbos(int imageDataSize);
+
+    /**
+     * \brief Give a staging slot to write an image to, called by the source image from any thread
+     * \param spec Spec of the image to be written
+     * \return Return an image buffer holding the slot until destroyed, or an empty buffer if no slot is free
+     */
+    ImageBuffer acquireStagingBuffer(const ImageBufferSpec& spec);
+
+    /**
+     * \brief Get the index of a free slot and mark it as acquired. The ring must be locked
+     * \param ring Staging ring
+     * \return Return the slot index, or -1 if none is free
+     */
+    static int acquireStagingSlot(StagingRing& ring);
+
+    /**
+     * \brief Get the slot of the current ring holding the given data
+     * \param data Pointer to the data
+     * \return Return the slot index, or -1 if the data is not in a slot
+     */
+    int findStagingSlot(const void* data);
+
+    /**
+     * \brief Mark the slots for which the GPU is done uploading as free again
+     * \param ring Staging ring
+     * \return Return true if no slot is in use anymore
+     */
+    static bool recycleStagingSlots(StagingRing& ring);
+
+    /**
+     * \brief Delete the buffers and fences of the given ring
+     * \param ring Staging ring
+     */
+    static void deleteStagingRing(StagingRing& ring);
+
+    /**
+     * \brief Move the current ring to the retired ones, they are deleted once not in use anymore
+     */
+    void retireStagingRing();
+
+    /**
+     * \brief Delete the rings from the given list which are not used anymore, by the GPU nor by any image buffer
+     * \param rings Staging rings
+     */
+    static void deleteUnusedStagingRings(std::list<std::shared_ptr<StagingRing>>& rings);
 
     /**
      * \brief Register new functors to modify attributes
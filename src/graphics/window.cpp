@@ -13,6 +13,7 @@
 #include "./utils/log.h"
 #include "./utils/timer.h"
 
+#include <cstring>
 #include <functional>
 #include <glm/gtc/matrix_transform.hpp>
 
@@ -83,6 +84,8 @@ Window::~Window()
 
     glDeleteFramebuffers(1, &_renderFbo);
     glDeleteFramebuffers(1, &_readFbo);
+    if (_readbackPbo != 0)
+        glDeleteBuffers(1, &_readbackPbo);
 }
 
 /*************/
@@ -438,6 +441,24 @@ void Window::swapBuffers()
 
     glWaitSync(_renderFence, 0, GL_TIMEOUT_IGNORED);
 
+    if (_readback)
+        startReadback();
+
+    // Without any display, swapping comes down to waiting for the frame to be rendered
+    if (Scene::isHeadless())
+    {
+        auto fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        if (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, SPLASH_WINDOW_HEADLESS_SYNC_TIMEOUT) == GL_TIMEOUT_EXPIRED)
+            Log::get() << Log::WARNING << "Window::" << __FUNCTION__ << " - Timeout while waiting for window " << _name << " to be rendered" << Log::endl;
+        glDeleteSync(fence);
+
+        if (_readback)
+            finishReadback();
+
+        _window->releaseContext();
+        return;
+    }
+
     // Only one window will wait for vblank, the others draws directly into front buffer
     auto windowIndex = _swappableWindowsCount.fetch_add(1, std::memory_order_acq_rel);
 
@@ -465,9 +486,55 @@ void Window::swapBuffers()
     if (drawToFront)
         glDrawBuffer(GL_BACK);
 
+    if (_readback)
+        finishReadback();
+
     _window->releaseContext();
 }
 
+/*************/
+ImageBuffer Window::getReadback() const
+{
+    lock_guard<mutex> lock(_readbackMutex);
+    return _readbackImage;
+}
+
+/*************/
+void Window::startReadback()
+{
+    auto spec = ImageBufferSpec(_windowRect[2], _windowRect[3], 4, 32);
+    if (spec.rawSize() != _readbackPboSize)
+    {
+        if (_readbackPbo != 0)
+            glDeleteBuffers(1, &_readbackPbo);
+        glCreateBuffers(1, &_readbackPbo);
+        glNamedBufferStorage(_readbackPbo, spec.rawSize(), nullptr, GL_MAP_READ_BIT);
+        _readbackPboSize = spec.rawSize();
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, _readbackPbo);
+    glGetTextureImage(_colorTexture->getTexId(), 0, GL_RGBA, GL_UNSIGNED_INT_8_8_8_8_REV, _readbackPboSize, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+/*************/
+void Window::finishReadback()
+{
+    auto spec = ImageBufferSpec(_windowRect[2], _windowRect[3], 4, 32);
+    auto pixels = glMapNamedBufferRange(_readbackPbo, 0, _readbackPboSize, GL_MAP_READ_BIT);
+    if (!pixels)
+    {
+        Log::get() << Log::WARNING << "Window::" << __FUNCTION__ << " - Unable to map the readback buffer of window " << _name << Log::endl;
+        return;
+    }
+
+    lock_guard<mutex> lock(_readbackMutex);
+    if (_readbackImage.getSpec() != spec)
+        _readbackImage = ImageBuffer(spec);
+    memcpy(_readbackImage.data(), pixels, _readbackPboSize);
+    glUnmapNamedBuffer(_readbackPbo);
+}
+
 /*************/
 void Window::showCursor(bool visibility)
 {
@@ -589,7 +656,8 @@ bool Window::setProjectionSurface()
         Log::get() << Log::WARNING << "Window::" << __FUNCTION__ << " - A previous context has not been released." << Log::endl;
     ;
     glfwShowWindow(_window->get());
-    glfwSwapInterval(_swapInterval);
+    if (!Scene::isHeadless())
+        glfwSwapInterval(_swapInterval);
 
 // Setup the projection surface
 #ifdef DEBUG
@@ -660,7 +728,9 @@ void Window::updateSwapInterval(int swapInterval)
         Log::get() << Log::WARNING << "Window::" << __FUNCTION__ << " - A previous context has not been released." << Log::endl;
 
     _swapInterval = max<int>(-1, swapInterval);
-    glfwSwapInterval(_swapInterval);
+    // There is no surface to swap when headless
+    if (!Scene::isHeadless())
+        glfwSwapInterval(_swapInterval);
 
     _window->releaseContext();
 }
@@ -781,6 +851,15 @@ void Window::registerAttributes()
         {'n'});
     setAttributeDescription("swapTest", "Activate video swap test if set to 1");
 
+    addAttribute("readback",
+        [&](const Values& args) {
+            _readback = args[0].as<bool>();
+            return true;
+        },
+        [&]() -> Values { return {_readback}; },
+        {'n'});
+    setAttributeDescription("readback", "If set to 1, each rendered frame is read back to the CPU");
+
     addAttribute("swapTestColor",
         [&](const Values& args) {
             _swapSynchronizationColor = glm::vec4(args[0].as<float>(), args[1].as<float>(), args[2].as<float>(), args[3].as<float>());
@@ -40,10 +40,13 @@
 #include "./core/attribute.h"
 #include "./core/coretypes.h"
 #include "./core/graph_object.h"
+#include "./core/imagebuffer.h"
 #include "./graphics/object.h"
 #include "./graphics/texture.h"
 #include "./graphics/texture_image.h"
 
+#define SPLASH_WINDOW_HEADLESS_SYNC_TIMEOUT 1000000000ull
+
 namespace Splash
 {
 
@@ -175,9 +178,16 @@ class Window : public GraphObject
 
     /**
      * \brief Swap the back and front buffers
+     * When headless, wait for the frame to be rendered and read it back if needed
      */
     void swapBuffers();
 
+    /**
+     * \brief Get the last frame read back from this window, with readback active
+     * \return Return the frame as RGBA, or an empty buffer if none has been read
+     */
+    ImageBuffer getReadback() const;
+
   private:
     bool _isInitialized{false};
     std::shared_ptr<GlWindow> _window;
@@ -203,6 +213,13 @@ class Window : public GraphObject
     std::shared_ptr<Texture_Image> _colorTexture{nullptr};
     GLsync _renderFence{nullptr};
 
+    // Headless readback
+    bool _readback{false};             //!< If true, each frame is read back to _readbackImage
+    GLuint _readbackPbo{0};            //!< Pixel buffer the frame is read into
+    int _readbackPboSize{0};           //!< Size of the pixel buffer, in bytes
+    mutable std::mutex _readbackMutex; //!< Protects _readbackImage
+    ImageBuffer _readbackImage{};      //!< Last frame read back
+
     std::shared_ptr<Object> _screen;
     std::shared_ptr<Object> _screenGui;
     glm::dmat4 _viewProjectionMatrix;
@@ -229,6 +246,16 @@ class Window : public GraphObject
     static void pathdropCallback(GLFWwindow* win, int count, const char** paths);
     static void closeCallback(GLFWwindow* win);
 
+    /**
+     * \brief Start reading the rendered frame back into the pixel buffer, with the context current
+     */
+    void startReadback();
+
+    /**
+     * \brief Copy the pixel buffer to _readbackImage, once the read is complete
+     */
+    void finishReadback();
+
     /**
      * \brief Set FBOs up
      */
@@ -0,0 +1,150 @@
+#include "./image/frame_writer.h"
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#include <stb_image_write.h>
+
+#include "./utils/log.h"
+#include "./utils/timer.h"
+
+using namespace std;
+
+namespace Splash
+{
+
+/*************/
+FrameWriter::FrameWriter(const string& directory, Format format)
+    : _directory(directory)
+    , _format(format)
+{
+    if (!_directory.empty() && _directory.back() != '/')
+        _directory += "/";
+
+    _writerThread = thread([&]() { writerLoop(); });
+}
+
+/*************/
+FrameWriter::~FrameWriter()
+{
+    {
+        lock_guard<mutex> lock(_queueMutex);
+        _stop = true;
+    }
+    _queueCondition.notify_all();
+
+    if (_writerThread.joinable())
+        _writerThread.join();
+}
+
+/*************/
+bool FrameWriter::getFormatFromName(const string& name, Format& format)
+{
+    if (name == "png")
+        format = Format::png;
+    else if (name == "raw")
+        format = Format::raw;
+    else
+        return false;
+
+    return true;
+}
+
+/*************/
+void FrameWriter::push(const string& name, uint64_t frame, ImageBuffer&& image)
+{
+    unique_lock<mutex> lock(_queueMutex);
+    _queueCondition.wait(lock, [&]() { return _queue.size() < SPLASH_FRAME_WRITER_MAX_QUEUED || _stop; });
+    if (_stop)
+        return;
+
+    _queue.emplace_back();
+    auto& job = _queue.back();
+    job.name = name;
+    job.frame = frame;
+    job.image = move(image);
+
+    lock.unlock();
+    _queueCondition.notify_all();
+}
+
+/*************/
+void FrameWriter::flush()
+{
+    unique_lock<mutex> lock(_queueMutex);
+    _queueCondition.wait(lock, [&]() { return (_queue.empty() && !_writing) || _stop; });
+}
+
+/*************/
+void FrameWriter::writerLoop()
+{
+    while (true)
+    {
+        Job job;
+        {
+            unique_lock<mutex> lock(_queueMutex);
+            _queueCondition.wait(lock, [&]() { return !_queue.empty() || _stop; });
+            // Remaining frames are written before stopping
+            if (_queue.empty())
+                break;
+
+            job = move(_queue.front());
+            _queue.pop_front();
+            _writing = true;
+        }
+        _queueCondition.notify_all();
+
+        auto start = Timer::getTime();
+        if (write(job))
+            _writtenCount.fetch_add(1, memory_order_acq_rel);
+        _writeDuration.fetch_add(Timer::getTime() - start, memory_order_acq_rel);
+
+        {
+            lock_guard<mutex> lock(_queueMutex);
+            _writing = false;
+        }
+        _queueCondition.notify_all();
+    }
+}
+
+/*************/
+bool FrameWriter::write(const Job& job) const
+{
+    auto spec = job.image.getSpec();
+    if (spec.width == 0 || spec.height == 0 || spec.channels != 4)
+        return false;
+
+    stringstream path;
+    path << _directory << job.name << "_" << setfill('0') << setw(6) << job.frame << (_format == Format::png ? ".png" : ".rgba");
+
+    if (_format == Format::raw)
+    {
+        ofstream file(path.str(), ios::out | ios::binary);
+        file.write(job.image.data(), spec.rawSize());
+        if (!file)
+        {
+            Log::get() << Log::WARNING << "FrameWriter::" << __FUNCTION__ << " - Unable to write frame to " << path.str() << Log::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // OpenGL gives the bottom row first
+    auto stride = spec.width * spec.channels;
+    vector<char> flipped(spec.rawSize());
+    for (uint32_t row = 0; row < spec.height; ++row)
+        memcpy(flipped.data() + row * stride, job.image.data() + (spec.height - 1 - row) * stride, stride);
+
+    if (stbi_write_png(path.str().c_str(), spec.width, spec.height, spec.channels, flipped.data(), stride) == 0)
+    {
+        Log::get() << Log::WARNING << "FrameWriter::" << __FUNCTION__ << " - Unable to write frame to " << path.str() << Log::endl;
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace Splash
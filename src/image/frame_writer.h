@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2018 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @frame_writer.h
+ * The FrameWriter class, writing rendered frames to disk from its own thread
+ */
+
+#ifndef SPLASH_FRAME_WRITER_H
+#define SPLASH_FRAME_WRITER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "./core/imagebuffer.h"
+
+#define SPLASH_FRAME_WRITER_MAX_QUEUED 8
+
+namespace Splash
+{
+
+/*************/
+/**
+ * Writes RGBA frames read back from the GPU, either as PNG files or as raw
+ * buffers. Frames are expected bottom row first, as given by OpenGL: they
+ * are flipped when written as PNG, and written as is when raw.
+ */
+class FrameWriter
+{
+  public:
+    enum class Format
+    {
+        png,
+        raw
+    };
+
+    /**
+     * \brief Constructor
+     * \param directory Directory to write the frames to
+     * \param format Output format
+     */
+    FrameWriter(const std::string& directory, Format format);
+
+    /**
+     * \brief Destructor, writes the remaining frames
+     */
+    ~FrameWriter();
+
+    FrameWriter(const FrameWriter&) = delete;
+    FrameWriter& operator=(const FrameWriter&) = delete;
+
+    /**
+     * \brief Get the format matching the given name
+     * \param name Format name, either "png" or "raw"
+     * \param format Matching format
+     * \return Return true if the name is valid
+     */
+    static bool getFormatFromName(const std::string& name, Format& format);
+
+    /**
+     * \brief Queue a frame to be written, waiting if too many frames are already queued
+     * \param name Name of the frame source, used as a file name prefix
+     * \param frame Frame index
+     * \param image Frame content, in RGBA
+     */
+    void push(const std::string& name, uint64_t frame, ImageBuffer&& image);
+
+    /**
+     * \brief Wait for all queued frames to be written
+     */
+    void flush();
+
+    /**
+     * \brief Get the number of frames written so far
+     * \return Return the number of frames
+     */
+    uint64_t getWrittenCount() const { return _writtenCount.load(std::memory_order_acquire); }
+
+    /**
+     * \brief Get the total time spent writing frames
+     * \return Return the duration in us
+     */
+    uint64_t getWriteDuration() const { return _writeDuration.load(std::memory_order_acquire); }
+
+  private:
+    struct Job
+    {
+        std::string name{};
+        uint64_t frame{0};
+        ImageBuffer image{};
+    };
+
+    std::string _directory;
+    Format _format;
+
+    std::mutex _queueMutex{};
+    std::condition_variable _queueCondition{};
+    std::deque<Job> _queue{};
+    bool _writing{false}; //!< True while a job taken from the queue is being written
+    bool _stop{false};
+    std::thread _writerThread{};
+
+    std::atomic<uint64_t> _writtenCount{0};
+    std::atomic<uint64_t> _writeDuration{0};
+
+    /**
+     * \brief Writer thread loop
+     */
+    void writerLoop();
+
+    /**
+     * \brief Write a single frame
+     * \param job Frame to write
+     * \return Return true if the frame has been written
+     */
+    bool write(const Job& job) const;
+};
+
+} // namespace Splash
+
+#endif // SPLASH_FRAME_WRITER_H
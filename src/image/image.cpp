@@ -1,7 +1,8 @@
 #include "./image/image.h"
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
-#include <future>
 #include <memory>
 
 #define STB_IMAGE_IMPLEMENTATION
@@ -13,7 +14,6 @@
 #include "./utils/osutils.h"
 #include "./utils/timer.h"
 
-#define SPLASH_IMAGE_COPY_THREADS 2
 #define SPLASH_IMAGE_SERIALIZED_HEADER_SIZE 4096
 
 using namespace std;
@@ -55,11 +55,25 @@ Image::~Image()
 {
     lock_guard<shared_timed_mutex> writeLock(_writeMutex);
     lock_guard<Spinlock> readlock(_readMutex);
+    Timer::get().releaseSlot(_serializeSlot);
+    Timer::get().releaseSlot(_deserializeSlot);
 #ifdef DEBUG
     Log::get() << Log::DEBUGGING << "Image::~Image - Destructor" << Log::endl;
 #endif
 }
 
+/*************/
+void Image::setName(const string& name)
+{
+    BufferObject::setName(name);
+
+    auto& timer = Timer::get();
+    timer.releaseSlot(_serializeSlot);
+    timer.releaseSlot(_deserializeSlot);
+    _serializeSlot = timer.acquireSlot("serialize " + _name);
+    _deserializeSlot = timer.acquireSlot("deserialize " + _name);
+}
+
 /*************/
 const void* Image::data() const
 {
@@ -94,7 +108,7 @@ void Image::set(const ImageBuffer& img)
 {
     lock_guard<Spinlock> lockRead(_readMutex);
     if (_image)
-        *_image = img;
+        _image = make_shared<ImageBuffer>(img);
 }
 
 /*************/
@@ -104,9 +118,7 @@ void Image::set(unsigned int w, unsigned int h, unsigned int channels, ImageBuff
     ImageBuffer img(spec);
 
     lock_guard<Spinlock> lock(_readMutex);
-    if (!_image)
-        _image = unique_ptr<ImageBuffer>(new ImageBuffer());
-    std::swap(*_image, img);
+    _image = make_shared<ImageBuffer>(std::move(img));
     updateTimestamp();
 }
 
@@ -116,17 +128,16 @@ shared_ptr<SerializedObject> Image::serialize() const
     lock_guard<Spinlock> lock(_readMutex);
 
     if (Timer::get().isDebug())
-        Timer::get() << "serialize " + _name;
+        Timer::get() << _serializeSlot;
 
     // We first get the xml version of the specs, and pack them into the obj
-    if (!_image)
+    if (!_image || !_image->data())
         return {};
     string xmlSpec = _image->getSpec().to_string();
     int nbrChar = xmlSpec.size();
     int imgSize = _image->getSpec().rawSize();
-    int totalSize = SPLASH_IMAGE_SERIALIZED_HEADER_SIZE + imgSize;
 
-    auto obj = make_shared<SerializedObject>(totalSize);
+    auto obj = make_shared<SerializedObject>(SPLASH_IMAGE_SERIALIZED_HEADER_SIZE);
 
     auto currentObjPtr = obj->data();
     const char* ptr = reinterpret_cast<const char*>(&nbrChar);
@@ -135,23 +146,12 @@ shared_ptr<SerializedObject> Image::serialize() const
 
     const char* charPtr = reinterpret_cast<const char*>(xmlSpec.c_str());
     copy(charPtr, charPtr + nbrChar, currentObjPtr);
-    currentObjPtr = obj->data() + SPLASH_IMAGE_SERIALIZED_HEADER_SIZE;
 
-    // And then, the image
-    const char* imgPtr = reinterpret_cast<const char*>(_image->data());
-    if (imgPtr == NULL)
-        return {};
-
-    {
-        vector<future<void>> threads;
-        int stride = SPLASH_IMAGE_COPY_THREADS;
-        for (int i = 0; i < stride - 1; ++i)
-            threads.push_back(async(launch::async, ([=]() { copy(imgPtr + imgSize / stride * i, imgPtr + imgSize / stride * (i + 1), currentObjPtr + imgSize / stride * i); })));
-        copy(imgPtr + imgSize / stride * (stride - 1), imgPtr + imgSize, currentObjPtr + imgSize / stride * (stride - 1));
-    }
+    // And then, the image, which is not copied but shared until the object is sent
+    obj->setPayload(_image, _image->data(), imgSize);
 
     if (Timer::get().isDebug())
-        Timer::get() >> ("serialize " + _name);
+        Timer::get() >> _serializeSlot;
 
     return obj;
 }
@@ -163,7 +163,7 @@ bool Image::deserialize(const shared_ptr<SerializedObject>& obj)
         return false;
 
     if (Timer::get().isDebug())
-        Timer::get() << "deserialize " + _name;
+        Timer::get() << _deserializeSlot;
 
     // First, we get the size of the metadata
     int nbrChar;
@@ -183,13 +183,33 @@ bool Image::deserialize(const shared_ptr<SerializedObject>& obj)
         ImageBufferSpec spec;
         spec.from_string(xmlSpec.c_str());
 
-        ImageBufferSpec curSpec = _bufferDeserialize.getSpec();
-        if (spec != curSpec)
-            _bufferDeserialize = ImageBuffer(spec);
+        auto staging = ImageBuffer();
+        if (_stagingAllocator)
+        {
+            // The previous buffer is released first, for it to be given back by the allocator
+            _bufferDeserialize = ImageBuffer();
+            staging = _stagingAllocator(spec);
+        }
 
-        auto rawBuffer = obj->grabData();
-        rawBuffer.shift(SPLASH_IMAGE_SERIALIZED_HEADER_SIZE);
-        _bufferDeserialize.setRawBuffer(std::move(rawBuffer));
+        if (staging.data())
+        {
+            // The image is copied once, straight from the sender buffer to where it will be uploaded from
+            const char* pixels = obj->hasPayload() ? obj->getPayloadData() : obj->data() + SPLASH_IMAGE_SERIALIZED_HEADER_SIZE;
+            size_t pixelsSize = obj->hasPayload() ? obj->getPayloadSize() : obj->size() - SPLASH_IMAGE_SERIALIZED_HEADER_SIZE;
+            memcpy(staging.data(), pixels, std::min(pixelsSize, staging.getSize()));
+            _bufferDeserialize = std::move(staging);
+        }
+        else
+        {
+            ImageBufferSpec curSpec = _bufferDeserialize.getSpec();
+            if (spec != curSpec)
+                _bufferDeserialize = ImageBuffer(spec);
+
+            obj->flatten();
+            auto rawBuffer = obj->grabData();
+            rawBuffer.shift(SPLASH_IMAGE_SERIALIZED_HEADER_SIZE);
+            _bufferDeserialize.setRawBuffer(std::move(rawBuffer));
+        }
 
         if (!_bufferImage)
             _bufferImage = unique_ptr<ImageBuffer>(new ImageBuffer());
@@ -205,11 +225,48 @@ bool Image::deserialize(const shared_ptr<SerializedObject>& obj)
     }
 
     if (Timer::get().isDebug())
-        Timer::get() >> ("deserialize " + _name);
+        Timer::get() >> _deserializeSlot;
 
     return true;
 }
 
+/*************/
+void Image::setStagingAllocator(const void* owner, const StagingAllocator& allocator)
+{
+    lock_guard<shared_timed_mutex> lockWrite(_writeMutex);
+    lock_guard<Spinlock> lockRead(_readMutex);
+    if (_stagingOwner != owner)
+        releaseStagingBuffers();
+    _stagingAllocator = allocator;
+    _stagingOwner = owner;
+}
+
+/*************/
+void Image::removeStagingAllocator(const void* owner)
+{
+    lock_guard<shared_timed_mutex> lockWrite(_writeMutex);
+    lock_guard<Spinlock> lockRead(_readMutex);
+    if (_stagingOwner != owner)
+        return;
+    releaseStagingBuffers();
+    _stagingAllocator = nullptr;
+    _stagingOwner = nullptr;
+}
+
+/*************/
+void Image::releaseStagingBuffers()
+{
+    if (!_stagingAllocator)
+        return;
+
+    // Copying an ImageBuffer copies its content to newly allocated memory
+    if (_image)
+        _image = make_shared<ImageBuffer>(*_image);
+    if (_bufferImage)
+        *_bufferImage = ImageBuffer(*_bufferImage);
+    _bufferDeserialize = ImageBuffer();
+}
+
 /*************/
 bool Image::read(const string& filename)
 {
@@ -263,6 +320,9 @@ void Image::zero()
     if (!_image)
         return;
 
+    // The image may still be shared with a serialized object being sent
+    if (_image.use_count() > 1)
+        _image = make_shared<ImageBuffer>(_image->getSpec());
     _image->zero();
 }
 
@@ -273,7 +333,11 @@ void Image::update()
     {
         lock_guard<Spinlock> lockRead(_readMutex);
         shared_lock<shared_timed_mutex> lockWrite(_writeMutex);
-        _image.swap(_bufferImage);
+        auto previousImage = std::move(_image);
+        _image = std::move(_bufferImage);
+        // The previous image is given back to be written to, unless it is still being sent
+        if (previousImage && previousImage.use_count() == 1)
+            _bufferImage = unique_ptr<ImageBuffer>(new ImageBuffer(std::move(*previousImage)));
         _imageUpdated = false;
 
         if (_remoteType.empty() || _type == _remoteType)
@@ -342,9 +406,7 @@ void Image::createDefaultImage()
     img.zero();
 
     lock_guard<Spinlock> lock(_readMutex);
-    if (!_image)
-        _image = unique_ptr<ImageBuffer>(new ImageBuffer());
-    std::swap(*_image, img);
+    _image = make_shared<ImageBuffer>(std::move(img));
     updateTimestamp();
 }
 
@@ -368,9 +430,7 @@ void Image::createPattern()
         }
 
     lock_guard<Spinlock> lock(_readMutex);
-    if (!_image)
-        _image = unique_ptr<ImageBuffer>(new ImageBuffer());
-    std::swap(*_image, img);
+    _image = make_shared<ImageBuffer>(std::move(img));
     updateTimestamp();
 }
 
@@ -387,6 +447,7 @@ void Image::registerAttributes()
         [&]() -> Values { return {_flip}; },
         {'n'});
     setAttributeDescription("flip", "Mirrors the image on the Y axis");
+    bindAttribute("flip", &_flip);
 
     addAttribute("flop",
         [&](const Values& args) {
@@ -396,6 +457,7 @@ void Image::registerAttributes()
         [&]() -> Values { return {_flop}; },
         {'n'});
     setAttributeDescription("flop", "Mirrors the image on the X axis");
+    bindAttribute("flop", &_flop);
 
     addAttribute("file",
         [&](const Values& args) {
@@ -416,6 +478,7 @@ void Image::registerAttributes()
         [&]() -> Values { return {_srgb}; },
         {'n'});
     setAttributeDescription("srgb", "Set to 1 if the image file is stored as sRGB");
+    bindAttribute("srgb", &_srgb);
 
     addAttribute("benchmark",
         [&](const Values& args) {
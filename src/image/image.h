@@ -26,6 +26,7 @@
 #define SPLASH_IMAGE_H
 
 #include <chrono>
+#include <functional>
 #include <mutex>
 
 #include "config.h"
@@ -42,6 +43,11 @@ namespace Splash
 class Image : public BufferObject
 {
   public:
+    /**
+     * Function giving a buffer to write the next image to, or an empty buffer if none is available
+     */
+    using StagingAllocator = std::function<ImageBuffer(const ImageBufferSpec&)>;
+
     /**
      * \brief Constructor
      * \param root Root object
@@ -67,6 +73,12 @@ class Image : public BufferObject
     Image& operator=(const Image&) = delete;
     Image& operator=(Image&&) = default;
 
+    /**
+     * \brief Set the name of the object, and of the durations measured for it
+     * \param name Name of the object
+     */
+    void setName(const std::string& name) override;
+
     /**
      * \brief Get a pointer to the data
      * \return Return a pointer to the data
@@ -119,6 +131,19 @@ class Image : public BufferObject
      */
     bool deserialize(const std::shared_ptr<SerializedObject>& obj) override;
 
+    /**
+     * \brief Set the function giving the buffers received images are written to, usually memory mapped by the texture uploading them
+     * \param owner Owner of the allocator, the only one allowed to remove it
+     * \param allocator Staging allocator
+     */
+    void setStagingAllocator(const void* owner, const StagingAllocator& allocator);
+
+    /**
+     * \brief Remove the staging allocator, copying out the buffers it gave as their memory is about to be released
+     * \param owner Owner of the allocator
+     */
+    void removeStagingAllocator(const void* owner);
+
     /**
      * \brief Set the path to read from
      * \param filename File path
@@ -144,7 +169,8 @@ class Image : public BufferObject
     bool write(const std::string& filename);
 
   protected:
-    std::unique_ptr<ImageBuffer> _image{nullptr};
+    // The current image is shared with the serialized objects still being sent, and must not be modified in place
+    std::shared_ptr<ImageBuffer> _image{nullptr};
     std::unique_ptr<ImageBuffer> _bufferImage{nullptr};
     std::string _filepath{""};
 
@@ -157,6 +183,9 @@ class Image : public BufferObject
     bool _srgb{true};
     bool _benchmark{false};
 
+    Timer::Slot _serializeSlot{};   //!< Timer slot for serialization, named after the image
+    Timer::Slot _deserializeSlot{}; //!< Timer slot for deserialization, named after the image
+
     void createDefaultImage(); //< Create a default black image
     void createPattern();      //< Create a default pattern
 
@@ -181,6 +210,20 @@ class Image : public BufferObject
     // Deserialization is done in this buffer, to avoid realloc
     ImageBuffer _bufferDeserialize;
 
+    StagingAllocator _stagingAllocator{}; //!< Gives the buffers to deserialize to, if set
+    const void* _stagingOwner{nullptr};   //!< Owner of the staging allocator
+
+    /**
+     * \brief Images sent within the same process are copied straight from the sender buffer
+     * \return Return true
+     */
+    bool deserializesPayload() const final { return true; }
+
+    /**
+     * \brief Copy out the buffers given by the staging allocator
+     */
+    void releaseStagingBuffers();
+
     /**
      * Add more media info, to be implemented by derived classes
      */
@@ -1,20 +1,27 @@
 #include "./image/image_ffmpeg.h"
 
+#include <algorithm>
 #include <chrono>
 #include <functional>
 #include <future>
+#include <limits>
 #include <numeric>
 #if HAVE_LINUX
 #include <fcntl.h>
 #endif
 #include <fstream>
 #include <hap.h>
+#include <sys/stat.h>
 
 #include "./utils/cgutils.h"
 #include "./utils/log.h"
 #include "./utils/osutils.h"
 #include "./utils/timer.h"
 
+#define SPLASH_FFMPEG_KEYFRAME_INDEX_SUFFIX ".keyframes"
+#define SPLASH_FFMPEG_KEYFRAME_INDEX_HEADER "splash_keyframes"
+#define SPLASH_FFMPEG_KEYFRAME_INDEX_VERSION 1
+
 using namespace std;
 
 namespace Splash
@@ -31,6 +38,20 @@ Image_FFmpeg::Image_FFmpeg(RootObject* root)
 Image_FFmpeg::~Image_FFmpeg()
 {
     freeFFmpegObjects();
+    Timer::get().releaseSlot(_decodeSlot);
+    Timer::get().releaseSlot(_seekSlot);
+}
+
+/*************/
+void Image_FFmpeg::setName(const string& name)
+{
+    Image::setName(name);
+
+    auto& timer = Timer::get();
+    timer.releaseSlot(_decodeSlot);
+    timer.releaseSlot(_seekSlot);
+    _decodeSlot = timer.acquireSlot("decode " + _name);
+    _seekSlot = timer.acquireSlot("seek " + _name);
 }
 
 /*************/
@@ -63,6 +84,18 @@ void Image_FFmpeg::freeFFmpegObjects()
 #endif
     }
 
+    // The index is built from its own context, it stops reading when _continueRead is false
+    if (_keyframesFuture.valid())
+        _keyframesFuture.wait();
+    {
+        lock_guard<mutex> lockKeyframes(_keyframesMutex);
+        _keyframes.clear();
+    }
+    _seekTarget = -1;
+    _prerolled = false;
+    _endOfStream = false;
+    _displayedTime = -1;
+
     if (_avContext)
     {
         avformat_close_input(&_avContext);
@@ -120,10 +153,230 @@ bool Image_FFmpeg::read(const string& filename)
     _audioThread = thread([&]() { audioLoop(); });
 #endif
     _readLoopThread = thread([&]() { readLoop(); });
+    _keyframesFuture = async(launch::async, [=]() { buildKeyframeIndex(filename); });
 
     return true;
 }
 
+/*************/
+void Image_FFmpeg::buildKeyframeIndex(const string& filename)
+{
+    struct stat fileStat;
+    if (stat(filename.c_str(), &fileStat) != 0)
+        return;
+
+    auto indexStart = Timer::getTime();
+    auto indexPath = filename + SPLASH_FFMPEG_KEYFRAME_INDEX_SUFFIX;
+    auto fileSize = static_cast<int64_t>(fileStat.st_size);
+    auto fileTime = static_cast<int64_t>(fileStat.st_mtime);
+    vector<int64_t> keyframes;
+
+    // The cached index is only used if it was built for this exact file
+    ifstream indexFile(indexPath, ios::in);
+    if (indexFile.is_open())
+    {
+        string header;
+        int version = 0;
+        int64_t size = 0, time = 0;
+        size_t count = 0;
+        if (indexFile >> header >> version >> size >> time >> count && header == SPLASH_FFMPEG_KEYFRAME_INDEX_HEADER && version == SPLASH_FFMPEG_KEYFRAME_INDEX_VERSION &&
+            size == fileSize && time == fileTime)
+        {
+            int64_t timestamp;
+            while (keyframes.size() < count && indexFile >> timestamp)
+                keyframes.push_back(timestamp);
+            if (keyframes.size() != count)
+                keyframes.clear();
+        }
+    }
+    indexFile.close();
+
+    if (keyframes.empty())
+    {
+        bool needsIndex = true;
+        keyframes = scanKeyframes(filename, needsIndex);
+        if (!needsIndex || keyframes.empty() || !_continueRead)
+            return;
+
+        ofstream outFile(indexPath, ios::out | ios::trunc);
+        if (outFile.is_open())
+        {
+            outFile << SPLASH_FFMPEG_KEYFRAME_INDEX_HEADER << " " << SPLASH_FFMPEG_KEYFRAME_INDEX_VERSION << "\n";
+            outFile << fileSize << " " << fileTime << " " << keyframes.size() << "\n";
+            for (const auto& timestamp : keyframes)
+                outFile << timestamp << "\n";
+        }
+        else
+        {
+            Log::get() << Log::DEBUGGING << "Image_FFmpeg::" << __FUNCTION__ << " - Unable to write the keyframe index to " << indexPath << Log::endl;
+        }
+    }
+
+    Log::get() << Log::MESSAGE << "Image_FFmpeg::" << __FUNCTION__ << " - Keyframe index for file " << filename << " ready with " << keyframes.size() << " keyframes, in "
+               << (Timer::getTime() - indexStart) / 1000 << "ms" << Log::endl;
+
+    lock_guard<mutex> lockKeyframes(_keyframesMutex);
+    _keyframes = std::move(keyframes);
+}
+
+/*************/
+vector<int64_t> Image_FFmpeg::scanKeyframes(const string& filename, bool& needsIndex)
+{
+    vector<int64_t> keyframes;
+
+    AVFormatContext* context = nullptr;
+    if (avformat_open_input(&context, filename.c_str(), nullptr, nullptr) != 0)
+        return keyframes;
+
+    if (avformat_find_stream_info(context, nullptr) < 0)
+    {
+        avformat_close_input(&context);
+        return keyframes;
+    }
+
+    // Same stream as the one read by readLoop, the other ones are not even parsed
+    int streamIndex = -1;
+    for (uint32_t i = 0; i < context->nb_streams; ++i)
+    {
+        if (context->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_VIDEO && streamIndex < 0)
+            streamIndex = i;
+        else
+            context->streams[i]->discard = AVDISCARD_ALL;
+    }
+
+    if (streamIndex < 0)
+    {
+        avformat_close_input(&context);
+        return keyframes;
+    }
+
+    // Intra only codecs seek right to the frame
+    auto stream = context->streams[streamIndex];
+    auto desc = avcodec_descriptor_get(stream->codecpar->codec_id);
+    if ((desc && (desc->props & AV_CODEC_PROP_INTRA_ONLY)) || tagToFourCC(stream->codecpar->codec_tag).find("Hap") != string::npos)
+    {
+        needsIndex = false;
+        avformat_close_input(&context);
+        return keyframes;
+    }
+
+    // Most containers (MP4, MOV) already hold an index of the keyframes
+    for (int i = 0; i < stream->nb_index_entries; ++i)
+        if (stream->index_entries[i].flags & AVINDEX_KEYFRAME)
+            keyframes.push_back(stream->index_entries[i].timestamp);
+
+    // Otherwise, the packets are read through, without decoding them
+    if (keyframes.size() < 2)
+    {
+        keyframes.clear();
+
+        AVPacket packet;
+        av_init_packet(&packet);
+        while (_continueRead && av_read_frame(context, &packet) >= 0)
+        {
+            if (packet.stream_index == streamIndex && (packet.flags & AV_PKT_FLAG_KEY))
+                keyframes.push_back(packet.pts != AV_NOPTS_VALUE ? packet.pts : packet.dts);
+            av_packet_unref(&packet);
+        }
+    }
+
+    avformat_close_input(&context);
+
+    sort(keyframes.begin(), keyframes.end());
+    keyframes.erase(unique(keyframes.begin(), keyframes.end()), keyframes.end());
+    return keyframes;
+}
+
+/*************/
+bool Image_FFmpeg::isBeforeSeekTarget(uint64_t timing)
+{
+    auto seekTarget = _seekTarget.load(memory_order_acquire);
+    if (seekTarget < 0)
+        return false;
+
+    // The first frame shown is the one displayed at the target time
+    if (static_cast<int64_t>(timing) + _videoFrameDuration <= seekTarget)
+        return true;
+
+    _seekTarget = -1;
+    _seekStall = Timer::getTime() - _seekRequestTime;
+    Timer::get().setDuration(_seekSlot, _seekStall);
+    Log::get() << Log::DEBUGGING << "Image_FFmpeg::" << __FUNCTION__ << " - Seek to " << seekTarget / 1e6 << "s in file " << _filepath << " stalled for " << _seekStall / 1000
+               << "ms" << Log::endl;
+    return false;
+}
+
+/*************/
+bool Image_FFmpeg::waitForVirtualClock(uint64_t timeout)
+{
+    auto& timer = Timer::get();
+    auto waitStart = Timer::getTime();
+    while (_continueRead && _displayedTime.load(memory_order_acquire) < timer.getVirtualTime())
+    {
+        if (static_cast<uint64_t>(Timer::getTime() - waitStart) > timeout)
+            return false;
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+
+    return true;
+}
+
+/*************/
+ImageBufferSpec Image_FFmpeg::getPlanarSpec(const AVFrame* frame) const
+{
+    ImageBufferSpec spec;
+
+    switch (frame->format)
+    {
+    default:
+        return spec;
+    case AV_PIX_FMT_YUV420P:
+    case AV_PIX_FMT_YUVJ420P:
+        spec = ImageBufferSpec(frame->width, frame->height, 3, 12, ImageBufferSpec::Type::UINT8, "YUV420P");
+        break;
+    case AV_PIX_FMT_NV12:
+        spec = ImageBufferSpec(frame->width, frame->height, 3, 12, ImageBufferSpec::Type::UINT8, "NV12");
+        break;
+    case AV_PIX_FMT_YUV422P:
+    case AV_PIX_FMT_YUVJ422P:
+        spec = ImageBufferSpec(frame->width, frame->height, 3, 16, ImageBufferSpec::Type::UINT8, "YUV422P");
+        break;
+    case AV_PIX_FMT_YUV420P10LE:
+        spec = ImageBufferSpec(frame->width, frame->height, 3, 24, ImageBufferSpec::Type::UINT16, "YUV420P10");
+        break;
+    case AV_PIX_FMT_P010LE:
+        // Samples are stored in the high bits, which reads as 16 bits samples
+        spec = ImageBufferSpec(frame->width, frame->height, 3, 24, ImageBufferSpec::Type::UINT16, "NV12");
+        break;
+    case AV_PIX_FMT_YUV422P10LE:
+        spec = ImageBufferSpec(frame->width, frame->height, 3, 32, ImageBufferSpec::Type::UINT16, "YUV422P10");
+        break;
+    }
+
+    switch (frame->colorspace)
+    {
+    case AVCOL_SPC_BT709:
+        spec.colorMatrix = ImageBufferSpec::ColorMatrix::BT709;
+        break;
+    case AVCOL_SPC_BT2020_NCL:
+    case AVCOL_SPC_BT2020_CL:
+        spec.colorMatrix = ImageBufferSpec::ColorMatrix::BT2020;
+        break;
+    case AVCOL_SPC_BT470BG:
+    case AVCOL_SPC_SMPTE170M:
+        spec.colorMatrix = ImageBufferSpec::ColorMatrix::BT601;
+        break;
+    default:
+        // Unspecified, HD content is most likely BT.709
+        spec.colorMatrix = frame->height >= 720 ? ImageBufferSpec::ColorMatrix::BT709 : ImageBufferSpec::ColorMatrix::BT601;
+        break;
+    }
+
+    spec.fullRange = frame->color_range == AVCOL_RANGE_JPEG || frame->format == AV_PIX_FMT_YUVJ420P || frame->format == AV_PIX_FMT_YUVJ422P;
+
+    return spec;
+}
+
 /*************/
 string Image_FFmpeg::tagToFourCC(unsigned int tag)
 {
@@ -318,40 +571,23 @@ void Image_FFmpeg::readLoop()
 #endif
 
     // Start reading frames
-    AVFrame *frame, *rgbFrame;
-    frame = av_frame_alloc();
-    rgbFrame = av_frame_alloc();
-
-    if (!frame || !rgbFrame)
+    AVFrame* frame = av_frame_alloc();
+    if (!frame)
     {
         Log::get() << Log::WARNING << "Image_FFmpeg::" << __FUNCTION__ << " - Error while allocating frame structures" << Log::endl;
         return;
     }
 
-    int numBytes = av_image_get_buffer_size(AV_PIX_FMT_YUYV422, videoCodecContext->width, videoCodecContext->height, 1);
-    vector<unsigned char> buffer(numBytes);
-
+    // Only created if some frames are not in a planar YUV format the textures can handle
     struct SwsContext* swsContext = nullptr;
-    if (!isHap)
-    {
-        swsContext = sws_getContext(videoCodecContext->width,
-            videoCodecContext->height,
-            videoCodecContext->pix_fmt,
-            videoCodecContext->width,
-            videoCodecContext->height,
-            AV_PIX_FMT_YUYV422,
-            SWS_BILINEAR,
-            nullptr,
-            nullptr,
-            nullptr);
-
-        av_image_fill_arrays(rgbFrame->data, rgbFrame->linesize, buffer.data(), AV_PIX_FMT_YUYV422, videoCodecContext->width, videoCodecContext->height, 1);
-    }
 
     AVPacket packet;
     av_init_packet(&packet);
 
     _videoTimeBase = (double)videoStream->time_base.num / (double)videoStream->time_base.den;
+    auto frameRate = av_guess_frame_rate(_avContext, videoStream, nullptr);
+    if (frameRate.num > 0 && frameRate.den > 0)
+        _videoFrameDuration = static_cast<int64_t>(1e6 * frameRate.den / frameRate.num);
 
     // This implements looping
     _startTime = Timer::getTime();
@@ -364,9 +600,12 @@ void Image_FFmpeg::readLoop()
 
         while (shouldContinueLoop())
         {
+            _endOfStream = false;
+
             // Reading the video
             if (packet.stream_index == _videoStreamIndex && _videoSeekMutex.try_lock())
             {
+                Timer::get() << _decodeSlot;
                 auto img = unique_ptr<ImageBuffer>();
                 uint64_t timing = 0;
                 bool hasFrame = false;
@@ -375,6 +614,10 @@ void Image_FFmpeg::readLoop()
                 // If the codec is handled by FFmpeg
                 if (!isHap)
                 {
+                    // Frames decoded before a seek must not be mixed with the following ones
+                    if (_seekFlush.exchange(false, memory_order_acq_rel))
+                        avcodec_flush_buffers(videoCodecContext);
+
                     auto frameFinished = false;
                     if (avcodec_send_packet(videoCodecContext, &packet) < 0)
                         Log::get() << Log::WARNING << "Image_FFmpeg::" << __FUNCTION__ << " - Error while decoding a frame in file " << _filepath << Log::endl;
@@ -383,20 +626,58 @@ void Image_FFmpeg::readLoop()
 
                     if (frameFinished)
                     {
-                        sws_scale(swsContext, (const uint8_t* const*)frame->data, frame->linesize, 0, videoCodecContext->height, rgbFrame->data, rgbFrame->linesize);
-
-                        ImageBufferSpec spec(videoCodecContext->width, videoCodecContext->height, 3, 16, ImageBufferSpec::Type::UINT8, "YUYV");
-                        img.reset(new ImageBuffer(spec));
-
-                        unsigned char* pixels = reinterpret_cast<unsigned char*>(img->data());
-                        copy(buffer.begin(), buffer.end(), pixels);
-
                         if (packet.pts != AV_NOPTS_VALUE)
                             timing = static_cast<uint64_t>((double)av_frame_get_best_effort_timestamp(frame) * _videoTimeBase * 1e6);
                         else
                             timing = 0.0;
                         // This handles repeated frames
                         timing += frame->repeat_pict * _videoTimeBase * 0.5;
+                    }
+
+                    // After a seek, frames are decoded from the previous keyframe but only shown from the target
+                    if (frameFinished && packet.pts != AV_NOPTS_VALUE && isBeforeSeekTarget(timing))
+                        frameFinished = false;
+
+                    if (frameFinished)
+                    {
+                        auto spec = getPlanarSpec(frame);
+                        if (spec.width != 0)
+                        {
+                            // Planes are packed one after the other, the conversion to RGB is done by the shader
+                            img.reset(new ImageBuffer(spec));
+                            av_image_copy_to_buffer(reinterpret_cast<uint8_t*>(img->data()),
+                                img->getSize(),
+                                frame->data,
+                                frame->linesize,
+                                static_cast<AVPixelFormat>(frame->format),
+                                frame->width,
+                                frame->height,
+                                1);
+                        }
+                        else
+                        {
+                            spec = ImageBufferSpec(videoCodecContext->width, videoCodecContext->height, 3, 16, ImageBufferSpec::Type::UINT8, "YUYV");
+                            img.reset(new ImageBuffer(spec));
+
+                            swsContext = sws_getCachedContext(swsContext,
+                                frame->width,
+                                frame->height,
+                                static_cast<AVPixelFormat>(frame->format),
+                                videoCodecContext->width,
+                                videoCodecContext->height,
+                                AV_PIX_FMT_YUYV422,
+                                SWS_BILINEAR,
+                                nullptr,
+                                nullptr,
+                                nullptr);
+
+                            // The frame is converted straight to the image buffer
+                            uint8_t* pixels[4];
+                            int linesizes[4];
+                            av_image_fill_arrays(
+                                pixels, linesizes, reinterpret_cast<uint8_t*>(img->data()), AV_PIX_FMT_YUYV422, videoCodecContext->width, videoCodecContext->height, 1);
+                            sws_scale(swsContext, (const uint8_t* const*)frame->data, frame->linesize, 0, frame->height, pixels, linesizes);
+                        }
 
                         hasFrame = true;
                     }
@@ -410,7 +691,8 @@ void Image_FFmpeg::readLoop()
                     // We are using kind of a hack to store a DXT compressed image in an ImageBuffer
                     // First, we check the texture format type
                     std::string textureFormat;
-                    if (hapDecodeFrame(packet.data, packet.size, nullptr, 0, textureFormat))
+                    auto isBeforeTarget = packet.pts != AV_NOPTS_VALUE && isBeforeSeekTarget(static_cast<uint64_t>((double)packet.pts * _videoTimeBase * 1e6));
+                    if (!isBeforeTarget && hapDecodeFrame(packet.data, packet.size, nullptr, 0, textureFormat))
                     {
                         // Check if we need to resize the reader buffer
                         // We set the size so as to have just enough place for the given texture format
@@ -450,6 +732,8 @@ void Image_FFmpeg::readLoop()
                     }
                 }
 
+                Timer::get() >> _decodeSlot;
+
                 int64_t totalBufferSize = 0;
                 {
                     lock_guard<mutex> lockFrames(_videoQueueMutex);
@@ -531,14 +815,18 @@ void Image_FFmpeg::readLoop()
 
         // If we loop, seek to the beginning, or whatever time is set in _trimStart
         if (_loopOnVideo)
+        {
             seek(static_cast<float>(_trimStart) / 1e6, false);
+        }
         else
+        {
+            _endOfStream = true;
             this_thread::sleep_for(chrono::milliseconds(50));
+        }
     }
 
-    av_frame_free(&rgbFrame);
     av_frame_free(&frame);
-    if (!isHap)
+    if (swsContext)
         sws_freeContext(swsContext);
     avcodec_close(videoCodecContext);
     avcodec_free_context(&videoCodecContext);
@@ -612,17 +900,44 @@ void Image_FFmpeg::seek(float seconds, bool clearQueues)
     else if (seconds > duration)
         seconds = duration;
 
-    int frame = static_cast<int>(floor(seconds / _videoTimeBase));
-    if (avformat_seek_file(_avContext, _videoStreamIndex, 0, frame, frame, seekFlag) < 0)
+    int64_t frame = static_cast<int64_t>(floor(seconds / _videoTimeBase));
+
+    // With the keyframe index, seeking goes right to the keyframe preceding the target
+    int64_t keyframe = -1;
+    {
+        lock_guard<mutex> lockKeyframes(_keyframesMutex);
+        if (!_keyframes.empty())
+        {
+            auto keyframeIt = upper_bound(_keyframes.begin(), _keyframes.end(), frame);
+            keyframe = keyframeIt == _keyframes.begin() ? _keyframes.front() : *(keyframeIt - 1);
+        }
+    }
+
+    int result = 0;
+    if (keyframe >= 0)
+        result = av_seek_frame(_avContext, _videoStreamIndex, keyframe, AVSEEK_FLAG_BACKWARD);
+    else
+        result = avformat_seek_file(_avContext, _videoStreamIndex, 0, frame, frame, seekFlag);
+
+    if (result < 0)
     {
         Log::get() << Log::WARNING << "Image_FFmpeg::" << __FUNCTION__ << " - Could not seek to timestamp " << seconds << Log::endl;
     }
     else
     {
         lock_guard<mutex> lockQueue(_videoQueueMutex);
-        // As seeking will no necessarily go to the desired timestamp, but to the closest i-frame,
-        // we will set _startTime at the next frame in the videoDisplayLoop
+        // Frames are decoded from the keyframe up to the target, while the last frame stays shown.
+        // _startTime is then set from the first frame shown, in the videoDisplayLoop
         _startTime = -1;
+        _seekFlush = true;
+        _seekRequestTime = Timer::getTime();
+        _seekTarget = static_cast<int64_t>(seconds * 1e6);
+        _prerolled = false;
+
+        // Frames are coming again after the end of the video
+        _endOfStream = false;
+        auto endOfStreamTime = numeric_limits<int64_t>::max();
+        _displayedTime.compare_exchange_strong(endOfStreamTime, -1);
 
         if (clearQueues)
         {
@@ -647,6 +962,9 @@ void Image_FFmpeg::seek_async(float seconds, bool clearQueues)
 /*************/
 void Image_FFmpeg::videoDisplayLoop()
 {
+    auto& timer = Timer::get();
+    bool virtualClock = false;
+
     while (_continueRead)
     {
         auto localQueue = deque<TimedFrame>();
@@ -658,13 +976,16 @@ void Image_FFmpeg::videoDisplayLoop()
         }
         else
         {
+            // Once the end of the video is displayed, there is nothing to wait for when rendering offline
+            if (_endOfStream && _seekTarget < 0)
+                _displayedTime = numeric_limits<int64_t>::max();
             this_thread::sleep_for(chrono::milliseconds(1));
             continue;
         }
 
         // This sets the start time after a seek
         if (!localQueue.empty() && _startTime == -1)
-            _startTime = Timer::getTime() - localQueue[0].timing;
+            _startTime = timer.getMediaTime() - localQueue[0].timing;
 
         lock_guard<mutex> lockEnd(_videoEndMutex);
         while (!localQueue.empty() && _continueRead)
@@ -678,7 +999,16 @@ void Image_FFmpeg::videoDisplayLoop()
 
             //
             // Get the current master and local clocks
+            // When rendering offline, the media time is the virtual time, which only moves once a frame is rendered
             //
+            auto mediaTime = timer.getMediaTime();
+            if (timer.isVirtualClock() != virtualClock)
+            {
+                virtualClock = !virtualClock;
+                _startTime = (virtualClock ? timer.getVirtualTime() : Timer::getTime()) - _currentTime;
+                mediaTime = timer.getMediaTime();
+            }
+
             int64_t clockAsMs = 0;
             bool clockIsPaused = false;
             bool useClock = _useClock && Timer::get().getMasterClock<chrono::milliseconds>(clockAsMs, clockIsPaused);
@@ -694,26 +1024,33 @@ void Image_FFmpeg::videoDisplayLoop()
             TimedFrame& timedFrame = localQueue[0];
             if (timedFrame.timing != 0ull)
             {
+                // While paused, the first frame after opening or seeking is still shown, so that the source is prerolled
+                bool preroll = false;
                 if (_paused || (clockIsPaused && useClock))
                 {
-                    _startTime = Timer::getTime() - _currentTime;
-                    this_thread::sleep_for(chrono::milliseconds(2));
-                    continue;
+                    _startTime = mediaTime - _currentTime;
+                    _displayedTime = mediaTime;
+                    if (_prerolled)
+                    {
+                        this_thread::sleep_for(chrono::milliseconds(2));
+                        continue;
+                    }
+                    preroll = true;
                 }
                 else if (useClock && _clockTime != -1l)
                 {
-                    _currentTime = Timer::getTime() - _startTime;
+                    _currentTime = mediaTime - _startTime;
                     auto delta = abs(_currentTime - _clockTime);
                     // If the difference between master clock and local clock is greater than 1.5 frames @30Hz, we adjust local clock
                     if (delta > 50000)
                     {
-                        _startTime = Timer::getTime() - _clockTime;
+                        _startTime = mediaTime - _clockTime;
                         _currentTime = _clockTime;
                     }
                 }
                 else
                 {
-                    _currentTime = Timer::getTime() - _startTime;
+                    _currentTime = mediaTime - _startTime;
                 }
 
                 // If the frame is beyond the trimming end, seek to the trimming start
@@ -740,8 +1077,15 @@ void Image_FFmpeg::videoDisplayLoop()
                 // Compute the difference between next frame and the current clock
                 int64_t waitTime = timedFrame.timing - _currentTime;
 
+                if (preroll)
+                {
+                    // Playback resumes from this frame when unpaused
+                    _currentTime = timedFrame.timing;
+                    _startTime = mediaTime - _currentTime;
+                    waitTime = 0;
+                }
                 // If the gap is too big, we seek through the video
-                if (abs(waitTime / 1e6) > (_intraOnly ? 1.f : 3.f)) // Maximum gap duration depending on encoding type (arbitrary values)
+                else if (abs(waitTime / 1e6) > (_intraOnly ? 1.f : 3.f)) // Maximum gap duration depending on encoding type (arbitrary values)
                 {
                     auto expectedValue = false;
                     if (_timeJump.compare_exchange_strong(expectedValue, true, std::memory_order_acquire))
@@ -755,8 +1099,17 @@ void Image_FFmpeg::videoDisplayLoop()
                 }
 
                 // Wait for the right time to display the frame
-                if (waitTime > 0)
+                if (waitTime > 0 && virtualClock)
+                {
+                    // All frames up to the virtual time are displayed, wait for it to move forward
+                    _displayedTime = mediaTime;
+                    this_thread::sleep_for(chrono::milliseconds(1));
+                    continue;
+                }
+                else if (waitTime > 0)
+                {
                     this_thread::sleep_for(chrono::microseconds(waitTime));
+                }
 
                 _elapsedTime = timedFrame.timing;
 
@@ -765,6 +1118,7 @@ void Image_FFmpeg::videoDisplayLoop()
                     _bufferImage = unique_ptr<ImageBuffer>(new ImageBuffer());
                 std::swap(_bufferImage, timedFrame.frame);
                 _imageUpdated = true;
+                _prerolled = true;
                 updateTimestamp();
             }
 
@@ -863,6 +1217,13 @@ void Image_FFmpeg::registerAttributes()
     setAttributeParameter("seek", false, true);
     setAttributeDescription("seek", "Change the read position in the video file");
 
+    addAttribute("seekStall",
+        [&](const Values&) { return false; },
+        [&]() -> Values { return {static_cast<float>(_seekStall) / 1e3f}; },
+        {});
+    setAttributeParameter("seekStall", false, true);
+    setAttributeDescription("seekStall", "Duration of the last seek until the target frame was decoded, in ms");
+
     addAttribute("trim",
         [&](const Values& args) {
             auto start = args[0].as<double>();
@@ -79,7 +79,23 @@ class Image_FFmpeg : public Image
      */
     bool read(const std::string& filename) final;
 
+    /**
+     * \brief Set the name of the object, and of the durations measured for it
+     * \param name Name of the object
+     */
+    void setName(const std::string& name) final;
+
+    /**
+     * \brief Wait for the frame matching the virtual clock to be displayed, when rendering offline
+     * \param timeout Maximum duration to wait, in us
+     * \return Return true if the displayed frame is up to date
+     */
+    bool waitForVirtualClock(uint64_t timeout) final;
+
   private:
+    Timer::Slot _decodeSlot{}; //!< Timer slot for decoding a frame, named after the image
+    Timer::Slot _seekSlot{};   //!< Timer slot for the seek stalls, named after the image
+
     std::thread _readLoopThread;
     std::atomic_bool _continueRead{false};
     std::atomic_bool _loopOnVideo{true};
@@ -103,6 +119,16 @@ class Image_FFmpeg : public Image
 
     std::atomic_bool _timeJump{false};
 
+    // Seeking goes to the keyframe preceding the target, then frames are decoded up to it
+    std::vector<int64_t> _keyframes{};       //!< Timestamps of the keyframes in the video stream time base, cached next to the media
+    std::mutex _keyframesMutex{};            //!< Protects _keyframes
+    std::future<void> _keyframesFuture{};    //!< Holds the task building the keyframe index
+    std::atomic<int64_t> _seekTarget{-1};    //!< Timing of the frame to seek to, in us. Frames before it are decoded but not shown
+    std::atomic_bool _seekFlush{false};      //!< Set by seek for the read loop to flush the decoder
+    int64_t _seekRequestTime{0};             //!< Time of the last seek
+    std::atomic<int64_t> _seekStall{0};      //!< Duration of the last seek until the target frame was decoded, in us
+    int64_t _videoFrameDuration{33333};      //!< Frame duration, in us
+
     bool _intraOnly{false};
     int64_t _startTime{0};
     int64_t _currentTime{0};
@@ -110,6 +136,9 @@ class Image_FFmpeg : public Image
     float _shiftTime{0};
     float _seekTime{0};
     bool _paused{false};
+    std::atomic_bool _prerolled{false};      //!< True once a frame has been shown since opening or seeking, even while paused
+    std::atomic<int64_t> _displayedTime{-1}; //!< Virtual time up to which the frames have been displayed, when rendering offline
+    std::atomic_bool _endOfStream{false};    //!< Set when the end of a non looping video has been read
     uint64_t _trimStart{0ull}; //!< Start trimming time
     uint64_t _trimEnd{0ull};   //!< End trimming time
 
@@ -140,6 +169,34 @@ class Image_FFmpeg : public Image
     std::mutex _audioMutex{};
 #endif
 
+    /**
+     * \brief Get the spec to keep a decoded frame in its planar YUV format, to be converted to RGB by the shader
+     * \param frame Decoded frame
+     * \return Return the spec, with a null width if the frame format is not handled natively and has to be converted
+     */
+    ImageBufferSpec getPlanarSpec(const AVFrame* frame) const;
+
+    /**
+     * \brief Load the keyframe index cached next to the file, or build and cache it
+     * \param filename Media file
+     */
+    void buildKeyframeIndex(const std::string& filename);
+
+    /**
+     * \brief Get the keyframes of the first video stream, from the container index or by reading all packets
+     * \param filename Media file
+     * \param needsIndex Set to false if the codec is intra only, in which case no index is needed
+     * \return Return the sorted keyframe timestamps, in the stream time base
+     */
+    std::vector<int64_t> scanKeyframes(const std::string& filename, bool& needsIndex);
+
+    /**
+     * \brief Check whether a decoded frame comes before the current seek target, and should be dropped
+     * \param timing Frame timing, in us
+     * \return Return true if the frame should be dropped
+     */
+    bool isBeforeSeekTarget(uint64_t timing);
+
     /**
      * \brief Convert a codec tag to a fourcc
      * \param tag Tag to convert
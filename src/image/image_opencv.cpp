@@ -27,6 +27,15 @@ Image_OpenCV::~Image_OpenCV()
     _continueReading = false;
     if (_readLoopThread.joinable())
         _readLoopThread.join();
+    Timer::get().releaseSlot(_readSlot);
+}
+
+/*************/
+void Image_OpenCV::setName(const string& name)
+{
+    Image::setName(name);
+    Timer::get().releaseSlot(_readSlot);
+    _readSlot = Timer::get().acquireSlot("read " + _name);
 }
 
 /*************/
@@ -102,7 +111,7 @@ void Image_OpenCV::readLoop()
     while (_continueReading)
     {
         if (Timer::get().isDebug())
-            Timer::get() << "read " + _name;
+            Timer::get() << _readSlot;
 
         auto capture = cv::Mat();
         if (!_videoCapture->read(capture))
@@ -131,7 +140,7 @@ void Image_OpenCV::readLoop()
         updateTimestamp();
 
         if (Timer::get().isDebug())
-            Timer::get() >> ("read " + _name);
+            Timer::get() >> _readSlot;
     }
 }
 
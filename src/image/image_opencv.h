@@ -67,8 +67,15 @@ class Image_OpenCV : public Image
      */
     bool read(const std::string& filename) final;
 
+    /**
+     * \brief Set the name of the object, and of the durations measured for it
+     * \param name Name of the object
+     */
+    void setName(const std::string& name) final;
+
   private:
     std::unique_ptr<cv::VideoCapture> _videoCapture;
+    Timer::Slot _readSlot{}; //!< Timer slot for reading a frame, named after the image
     int _inputIndex{-1};
     unsigned int _width{640};
     unsigned int _height{480};
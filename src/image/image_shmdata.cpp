@@ -13,6 +13,7 @@
 #include <glm/glm.hpp>
 #endif
 
+#include "./core/thread_pool.h"
 #include "./utils/cgutils.h"
 #include "./utils/log.h"
 #include "./utils/osutils.h"
@@ -37,11 +38,20 @@ Image_Shmdata::Image_Shmdata(RootObject* root)
 Image_Shmdata::~Image_Shmdata()
 {
     _reader.reset();
+    Timer::get().releaseSlot(_frameSlot);
 #ifdef DEBUG
     Log::get() << Log::DEBUGGING << "Image_Shmdata::~Image_Shmdata - Destructor" << Log::endl;
 #endif
 }
 
+/*************/
+void Image_Shmdata::setName(const string& name)
+{
+    Image::setName(name);
+    Timer::get().releaseSlot(_frameSlot);
+    _frameSlot = Timer::get().acquireSlot("image_shmdata " + _name);
+}
+
 /*************/
 bool Image_Shmdata::read(const string& filename)
 {
@@ -200,7 +210,7 @@ void Image_Shmdata::onData(void* data, int data_size)
 {
     if (Timer::get().isDebug())
     {
-        Timer::get() << "image_shmdata " + _name;
+        Timer::get() << _frameSlot;
     }
 
     // Standard images, RGB or YUV
@@ -215,7 +225,7 @@ void Image_Shmdata::onData(void* data, int data_size)
     }
 
     if (Timer::get().isDebug())
-        Timer::get() >> ("image_shmdata " + _name);
+        Timer::get() >> _frameSlot;
 }
 
 /*************/
@@ -290,11 +300,11 @@ void Image_Shmdata::readUncompressedFrame(void* data, int /*data_size*/)
     if (!_isYUV && (_channels == 3 || _channels == 4))
     {
         char* pixels = (char*)(_readerBuffer).data();
-        vector<future<void>> threads;
+        TaskGroup blocks;
         for (int block = 0; block < SPLASH_SHMDATA_THREADS; ++block)
         {
             int size = _width * _height * _channels * sizeof(char);
-            threads.push_back(async(launch::async, [=]() {
+            blocks.run([=]() {
                 int sizeOfBlock; // We compute the size of the block, to handle image size non divisible by SPLASH_SHMDATA_THREADS
                 if (size - size / SPLASH_SHMDATA_THREADS * block < 2 * size / SPLASH_SHMDATA_THREADS)
                     sizeOfBlock = size - size / SPLASH_SHMDATA_THREADS * block;
@@ -302,8 +312,9 @@ void Image_Shmdata::readUncompressedFrame(void* data, int /*data_size*/)
                     sizeOfBlock = size / SPLASH_SHMDATA_THREADS;
 
                 memcpy(pixels + size / SPLASH_SHMDATA_THREADS * block, (const char*)data + size / SPLASH_SHMDATA_THREADS * block, sizeOfBlock);
-            }));
+            });
         }
+        blocks.wait();
     }
     else if (_is420)
     {
@@ -60,7 +60,14 @@ class Image_Shmdata : public Image
      */
     bool read(const std::string& filename) final;
 
+    /**
+     * \brief Set the name of the object, and of the durations measured for it
+     * \param name Name of the object
+     */
+    void setName(const std::string& name) final;
+
   private:
+    Timer::Slot _frameSlot{}; //!< Timer slot for the frame reception, named after the image
     Utils::ShmdataLogger _logger;
     std::unique_ptr<shmdata::Follower> _reader{nullptr};
 
@@ -30,6 +30,15 @@ Queue::Queue(RootObject* root)
 /*************/
 Queue::~Queue()
 {
+    Timer::get().releaseSlot(_switchSlot);
+}
+
+/*************/
+void Queue::setName(const string& name)
+{
+    BufferObject::setName(name);
+    Timer::get().releaseSlot(_switchSlot);
+    _switchSlot = Timer::get().acquireSlot("queue switch " + _name);
 }
 
 /*************/
@@ -47,6 +56,15 @@ string Queue::getDistantName() const
     return _name + DISTANT_NAME_SUFFIX;
 }
 
+/*************/
+bool Queue::waitForVirtualClock(uint64_t timeout)
+{
+    lock_guard<mutex> lock(_playlistMutex);
+    if (!_currentSource)
+        return true;
+    return _currentSource->waitForVirtualClock(timeout);
+}
+
 /*************/
 void Queue::update()
 {
@@ -55,19 +73,28 @@ void Queue::update()
     if (_playlist.size() == 0)
         return;
 
+    // Keep the current time when switching between the wall clock and the virtual clock
+    auto& timer = Timer::get();
+    if (timer.isVirtualClock() != _virtualClock)
+    {
+        _virtualClock = !_virtualClock;
+        if (_startTime >= 0)
+            _startTime = timer.getMediaTime() - max<int64_t>(_currentTime, 0);
+    }
+
     if (_startTime < 0)
-        _startTime = Timer::getTime();
+        _startTime = timer.getMediaTime();
 
     int64_t masterClockTime;
     bool masterClockPaused;
-    if (_useClock && Timer::get().getMasterClock<chrono::microseconds>(masterClockTime, masterClockPaused))
+    if (_useClock && timer.getMasterClock<chrono::microseconds>(masterClockTime, masterClockPaused))
     {
         _currentTime = masterClockTime;
     }
     else
     {
         auto previousTime = _currentTime;
-        _currentTime = Timer::getTime() - _startTime;
+        _currentTime = timer.getMediaTime() - _startTime;
 
         if (_paused)
         {
@@ -97,7 +124,7 @@ void Queue::update()
     if (!_useClock && _loop && sourceIndex >= _playlist.size())
     {
         sourceIndex = 0;
-        _startTime = Timer::getTime();
+        _startTime = timer.getMediaTime();
         _currentTime = 0;
     }
 
@@ -111,16 +138,37 @@ void Queue::update()
         }
 
         _currentSourceIndex = sourceIndex;
+        _switchPending = false;
+
+        // A preloaded source for another entry, after a seek or a playlist change, is of no use
+        if (_nextSource && _nextSourceIndex != _currentSourceIndex)
+        {
+            releaseSource(std::move(_nextSource), std::move(_nextSourceFuture));
+            _nextSourceIndex = -1;
+        }
 
         if (sourceIndex >= _playlist.size())
         {
             _currentSource = dynamic_pointer_cast<BufferObject>(_factory->create("image"));
             _root->sendMessage(_name, "source", {"image"});
+            _switching = false;
+        }
+        else if (_nextSource)
+        {
+            auto& sourceParameters = _playlist[_currentSourceIndex];
+
+            // Switch to the preloaded source. If it is still being opened, the switch happens on a later update
+            _switchBoundary = timer.getMediaTime() - max<int64_t>(_currentTime - sourceParameters.start, 0);
+            _switchDroppedFrames = 0;
+            _switchPending = true;
         }
         else
         {
             auto& sourceParameters = _playlist[_currentSourceIndex];
 
+            _switchBoundary = timer.getMediaTime() - max<int64_t>(_currentTime - sourceParameters.start, 0);
+            _switchDroppedFrames = 0;
+
             if (!_currentSource || _currentSource->getType() != sourceParameters.type)
                 _currentSource = dynamic_pointer_cast<BufferObject>(_factory->create(sourceParameters.type));
 
@@ -130,8 +178,9 @@ void Queue::update()
                 _currentSource = dynamic_pointer_cast<BufferObject>(_factory->create("image"));
             dynamic_pointer_cast<Image>(_currentSource)->zero();
             dynamic_pointer_cast<Image>(_currentSource)->setName(_name + DISTANT_NAME_SUFFIX);
+            _sourceTimestamp = _currentSource->getTimestamp();
 
-            _currentSource->setAttribute("file", {sourceParameters.filename});
+            _switching = _currentSource->setAttribute("file", {sourceParameters.filename});
 
             if (_useClock && !sourceParameters.freeRun)
             {
@@ -159,7 +208,16 @@ void Queue::update()
         }
     }
 
-    if (!_useClock && !_playlist[_currentSourceIndex].freeRun && _seeked)
+    // The previous source stays displayed until the preloaded one is opened, the update loop never waits for it
+    if (_switchPending)
+    {
+        if (_nextSourceFuture.wait_for(chrono::seconds(0)) == future_status::ready)
+            switchToNextSource();
+        else
+            ++_switchDroppedFrames;
+    }
+
+    if (!_switchPending && !_useClock && !_playlist[_currentSourceIndex].freeRun && _seeked)
     {
         // If we don't use the master clock, we want to seek accordingly in the file
         _currentSource->setAttribute("seek", {(float)(_currentTime - _playlist[_currentSourceIndex].start) / 1e6});
@@ -168,6 +226,130 @@ void Queue::update()
 
     if (_currentSource)
         _currentSource->update();
+
+    if (_switching)
+    {
+        if (_currentSource->getTimestamp() != _sourceTimestamp)
+            finishSwitch();
+        else
+            ++_switchDroppedFrames;
+    }
+
+    // Preload the next source so that its first frames are buffered when reaching its start
+    if (_currentSourceIndex < 0 || static_cast<uint32_t>(_currentSourceIndex) >= _playlist.size())
+        return;
+
+    if (!_nextSource && _preloadTime > 0.f && _playlist[_currentSourceIndex].stop - _currentTime <= static_cast<int64_t>(_preloadTime * 1e6))
+    {
+        auto nextIndex = static_cast<uint32_t>(_currentSourceIndex) + 1;
+        if (nextIndex >= _playlist.size() && !_useClock && _loop)
+            nextIndex = 0;
+        if (nextIndex < _playlist.size() && nextIndex != static_cast<uint32_t>(_currentSourceIndex))
+            preloadSource(nextIndex);
+    }
+
+    // Once opened, the preloaded source shows its first frame while paused
+    if (_nextSource && _nextSourceFuture.wait_for(chrono::seconds(0)) == future_status::ready)
+        _nextSource->update();
+}
+
+/*************/
+void Queue::preloadSource(uint32_t index)
+{
+    const auto& sourceParameters = _playlist[index];
+
+    _nextSource = dynamic_pointer_cast<BufferObject>(_factory->create(sourceParameters.type));
+    if (!_nextSource)
+        _nextSource = dynamic_pointer_cast<BufferObject>(_factory->create("image"));
+    dynamic_pointer_cast<Image>(_nextSource)->zero();
+    dynamic_pointer_cast<Image>(_nextSource)->setName(_name + DISTANT_NAME_SUFFIX);
+
+    _nextSourceIndex = index;
+    _nextSourceTimestamp = _nextSource->getTimestamp();
+
+    // The source stays paused on its first frame until the switch
+    _nextSource->setAttribute("pause", {1});
+
+    auto source = _nextSource;
+    auto useClock = _useClock && !sourceParameters.freeRun;
+    // Opening a file blocks on I/O for an unbounded time, network streams included. This stays off the ThreadPool,
+    // whose workers run the per frame copies and decodes, and happens at most once per transition
+    _nextSourceFuture = async(launch::async, [=]() {
+        auto loadStart = Timer::getTime();
+        auto isRead = source->setAttribute("file", {sourceParameters.filename});
+
+        if (useClock)
+        {
+            source->setAttribute("timeShift", {-(float)sourceParameters.start / 1e6});
+            source->setAttribute("useClock", {1});
+        }
+        else
+        {
+            source->setAttribute("useClock", {0});
+        }
+
+        for (const auto& arg : sourceParameters.args)
+        {
+            if (!arg.isNamed())
+                continue;
+
+            source->setAttribute(arg.getName(), arg.as<Values>());
+        }
+
+        Log::get() << Log::DEBUGGING << "Queue::preloadSource - Opened file " << sourceParameters.filename << " in " << (Timer::getTime() - loadStart) / 1000 << "ms"
+                   << Log::endl;
+        return isRead;
+    });
+}
+
+/*************/
+void Queue::switchToNextSource()
+{
+    auto& sourceParameters = _playlist[_currentSourceIndex];
+
+    _sourceTimestamp = _nextSourceTimestamp;
+    _switching = _nextSourceFuture.get();
+    _switchPending = false;
+
+    releaseSource(std::move(_currentSource));
+    _currentSource = std::move(_nextSource);
+    _nextSourceIndex = -1;
+    _currentSource->setAttribute("pause", {0});
+    _playing = true;
+
+    _root->sendMessage(_name, "source", {sourceParameters.type});
+
+    Log::get() << Log::MESSAGE << "Queue::" << __FUNCTION__ << " - Playing file: " << sourceParameters.filename << Log::endl;
+}
+
+/*************/
+void Queue::releaseSource(shared_ptr<BufferObject>&& source, future<bool>&& loading)
+{
+    // Assigning over a running future would wait for it, so finished releases are pruned instead
+    _releaseFutures.remove_if([](const future<void>& release) { return release.wait_for(chrono::seconds(0)) == future_status::ready; });
+
+    if (!source)
+        return;
+
+    // Not a ThreadPool task either: it waits for the loading future, which a pool task must not do,
+    // and destroying a source joins its reading threads
+    _releaseFutures.emplace_back(async(launch::async, [source = std::move(source), loading = std::move(loading)]() mutable {
+        if (loading.valid())
+            loading.wait();
+        source.reset();
+    }));
+}
+
+/*************/
+void Queue::finishSwitch()
+{
+    auto& timer = Timer::get();
+    _switchLatency = max<int64_t>(timer.getMediaTime() - _switchBoundary, 0);
+    _switching = false;
+
+    timer.setDuration(_switchSlot, _switchLatency);
+    Log::get() << Log::DEBUGGING << "Queue::" << __FUNCTION__ << " - Switched to file " << _playlist[_currentSourceIndex].filename << " in " << _switchLatency / 1000 << "ms, "
+               << _switchDroppedFrames << " frames dropped" << Log::endl;
 }
 
 /*************/
@@ -302,6 +484,9 @@ void Queue::registerAttributes()
         [&](const Values& args) {
             lock_guard<mutex> lock(_playlistMutex);
             _playlist.clear();
+            releaseSource(std::move(_nextSource), std::move(_nextSourceFuture));
+            _nextSourceIndex = -1;
+            _switchPending = false;
 
             for (auto& it : args)
             {
@@ -351,10 +536,20 @@ void Queue::registerAttributes()
     setAttributeParameter("playlist", true, true);
     setAttributeDescription("playlist", "Set the playlist as an array of [type, filename, start, end, (args)]");
 
+    addAttribute("preloadTime",
+        [&](const Values& args) {
+            _preloadTime = max(args[0].as<float>(), 0.f);
+            return true;
+        },
+        [&]() -> Values { return {_preloadTime}; },
+        {'n'});
+    setAttributeParameter("preloadTime", true, true);
+    setAttributeDescription("preloadTime", "Time before the start of the next source at which to open and preroll it, in seconds. Set to 0 to disable preloading");
+
     addAttribute("seek",
         [&](const Values& args) {
             int64_t seekTime = args[0].as<float>() * 1e6;
-            _startTime = Timer::getTime() - seekTime;
+            _startTime = Timer::get().getMediaTime() - seekTime;
             _seeked = true;
             return true;
         },
@@ -363,6 +558,20 @@ void Queue::registerAttributes()
     setAttributeParameter("seek", false, true);
     setAttributeDescription("seek", "Seek through the playlist");
 
+    addAttribute("switchDroppedFrames",
+        [&](const Values&) { return false; },
+        [&]() -> Values { return {_switchDroppedFrames}; },
+        {});
+    setAttributeParameter("switchDroppedFrames", false, true);
+    setAttributeDescription("switchDroppedFrames", "Number of frames without an image from the new source, during the last transition");
+
+    addAttribute("switchLatency",
+        [&](const Values&) { return false; },
+        [&]() -> Values { return {static_cast<float>(_switchLatency) / 1e3f}; },
+        {});
+    setAttributeParameter("switchLatency", false, true);
+    setAttributeDescription("switchLatency", "Duration from the start of the last source to its first frame, in ms");
+
     addAttribute("useClock",
         [&](const Values& args) {
             _useClock = args[0].as<int>();
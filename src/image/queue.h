@@ -25,6 +25,7 @@
 #ifndef SPLASH_QUEUE_H
 #define SPLASH_QUEUE_H
 
+#include <future>
 #include <glm/glm.hpp>
 #include <list>
 #include <memory>
@@ -94,6 +95,19 @@ class Queue : public BufferObject
      */
     void update();
 
+    /**
+     * \brief Wait for the current source to be up to date with the virtual clock, when rendering offline
+     * \param timeout Maximum duration to wait, in us
+     * \return Return true if the current source is up to date
+     */
+    bool waitForVirtualClock(uint64_t timeout) final;
+
+    /**
+     * \brief Set the name of the object, and of the durations measured for it
+     * \param name Name of the object
+     */
+    void setName(const std::string& name) final;
+
   private:
     std::unique_ptr<Factory> _factory;
 
@@ -122,6 +136,24 @@ class Queue : public BufferObject
     bool _seeked{false};
     int64_t _startTime{-1};   // Beginning of the current loop, in us
     int64_t _currentTime{-1}; // Elapsed time since _startTime
+    bool _virtualClock{false}; // True if following the virtual clock, when rendering offline
+
+    // The next source is opened and prerolled before its start, then switched to at the boundary
+    float _preloadTime{1.f};                        //!< Time before the start of the next source at which to preload it, in seconds. 0 disables preloading
+    std::shared_ptr<BufferObject> _nextSource{};    //!< Source being preloaded
+    int32_t _nextSourceIndex{-1};                   //!< Playlist index of the preloaded source
+    std::future<bool> _nextSourceFuture{};          //!< Task opening the preloaded source, returns whether the file was read
+    int64_t _nextSourceTimestamp{0};                //!< Timestamp of the preloaded source before opening, to detect its first frame
+    std::list<std::future<void>> _releaseFutures{}; //!< Tasks releasing the previous sources, off the update loop
+
+    // Measurement of the transitions between sources
+    bool _switchPending{false};       //!< True while the preloaded source is still being opened past its start
+    bool _switching{false};           //!< True while waiting for the first frame of the current source
+    int64_t _switchBoundary{0};       //!< Media time at which the current source should have started, in us
+    int64_t _sourceTimestamp{0};      //!< Timestamp of the current source when switched to
+    Timer::Slot _switchSlot{};        //!< Timer slot for the transition latency, named after the queue
+    int64_t _switchLatency{0};        //!< Time from the boundary to the first frame of the new source, for the last transition, in us
+    uint32_t _switchDroppedFrames{0}; //!< Updates without a frame from the new source, for the last transition
 
     /**
      * \brief Clean the playlist for holes and overlaps
@@ -129,6 +161,29 @@ class Queue : public BufferObject
      */
     void cleanPlaylist(std::vector<Source>& playlist);
 
+    /**
+     * \brief Create the source for the given playlist entry, and start opening it in a separate thread
+     * \param index Playlist index of the source
+     */
+    void preloadSource(uint32_t index);
+
+    /**
+     * \brief Make the preloaded source the current one, once it is opened
+     */
+    void switchToNextSource();
+
+    /**
+     * \brief Release the given source in a separate thread, as it can involve joining decoding threads
+     * \param source Source to release
+     * \param loading Task still loading the source, if any
+     */
+    void releaseSource(std::shared_ptr<BufferObject>&& source, std::future<bool>&& loading = {});
+
+    /**
+     * \brief Measure the transition to the current source, once its first frame is available
+     */
+    void finishSwitch();
+
     /**
      * Regist\brief er new functors to modify attributes
      */
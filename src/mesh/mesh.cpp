@@ -22,11 +22,25 @@ Mesh::Mesh(RootObject* root)
 /*************/
 Mesh::~Mesh()
 {
+    Timer::get().releaseSlot(_serializeSlot);
+    Timer::get().releaseSlot(_deserializeSlot);
 #ifdef DEBUG
     Log::get() << Log::DEBUGGING << "Mesh::~Mesh - Destructor" << Log::endl;
 #endif
 }
 
+/*************/
+void Mesh::setName(const string& name)
+{
+    BufferObject::setName(name);
+
+    auto& timer = Timer::get();
+    timer.releaseSlot(_serializeSlot);
+    timer.releaseSlot(_deserializeSlot);
+    _serializeSlot = timer.acquireSlot("serialize " + _name);
+    _deserializeSlot = timer.acquireSlot("deserialize " + _name);
+}
+
 /*************/
 void Mesh::init()
 {
@@ -137,7 +151,7 @@ shared_ptr<SerializedObject> Mesh::serialize() const
     auto obj = make_shared<SerializedObject>();
 
     if (Timer::get().isDebug())
-        Timer::get() << "serialize " + _name;
+        Timer::get() << _serializeSlot;
 
     // For this, we will use the getVertex, getUV, etc. methods to create a serialized representation of the mesh
     vector<vector<float>> data;
@@ -166,7 +180,7 @@ shared_ptr<SerializedObject> Mesh::serialize() const
     }
 
     if (Timer::get().isDebug())
-        Timer::get() >> ("serialize " + _name);
+        Timer::get() >> _serializeSlot;
 
     return obj;
 }
@@ -178,7 +192,7 @@ bool Mesh::deserialize(const shared_ptr<SerializedObject>& obj)
         return false;
 
     if (Timer::get().isDebug())
-        Timer::get() << "deserialize " + _name;
+        Timer::get() << _deserializeSlot;
 
     // First, we get the number of vertices
     int nbrVertices;
@@ -268,7 +282,7 @@ bool Mesh::deserialize(const shared_ptr<SerializedObject>& obj)
     }
 
     if (Timer::get().isDebug())
-        Timer::get() >> ("deserialize " + _name);
+        Timer::get() >> _deserializeSlot;
 
     return true;
 }
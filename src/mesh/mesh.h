@@ -68,6 +68,12 @@ class Mesh : public BufferObject
      */
     bool operator==(Mesh& otherMesh) const;
 
+    /**
+     * \brief Set the name of the object, and of the durations measured for it
+     * \param name Name of the object
+     */
+    void setName(const std::string& name) override;
+
     /**
      * \brief Get a 1D vector of all points of the mesh, in normalized coordinates
      * \return Return a vector representing all points of the mesh
@@ -133,6 +139,9 @@ class Mesh : public BufferObject
     bool _benchmark{false};
     int _planeSubdivisions{0};
 
+    Timer::Slot _serializeSlot{};   //!< Timer slot for serialization, named after the mesh
+    Timer::Slot _deserializeSlot{}; //!< Timer slot for deserialization, named after the mesh
+
     /**
      * \brief Register new functors to modify attributes
      */
@@ -20,6 +20,16 @@ Mesh_Shmdata::Mesh_Shmdata(RootObject* root)
 /*************/
 Mesh_Shmdata::~Mesh_Shmdata()
 {
+    _reader.reset();
+    Timer::get().releaseSlot(_frameSlot);
+}
+
+/*************/
+void Mesh_Shmdata::setName(const string& name)
+{
+    Mesh::setName(name);
+    Timer::get().releaseSlot(_frameSlot);
+    _frameSlot = Timer::get().acquireSlot("mesh_shmdata " + _name);
 }
 
 /*************/
@@ -116,14 +126,14 @@ void Mesh_Shmdata::onData(void* data, int /*data_size*/)
 
     lock_guard<shared_timed_mutex> lock(_writeMutex);
     if (Timer::get().isDebug())
-        Timer::get() << "mesh_shmdata " + _name;
+        Timer::get() << _frameSlot;
 
     _bufferMesh = std::move(newMesh);
     _meshUpdated = true;
     updateTimestamp();
 
     if (Timer::get().isDebug())
-        Timer::get() >> ("mesh_shmdata " + _name);
+        Timer::get() >> _frameSlot;
 }
 
 /*************/
@@ -66,11 +66,18 @@ class Mesh_Shmdata : public Mesh
      */
     bool read(const std::string& filename) final;
 
+    /**
+     * \brief Set the name of the object, and of the durations measured for it
+     * \param name Name of the object
+     */
+    void setName(const std::string& name) final;
+
   protected:
     std::string _caps{""};
     Utils::ShmdataLogger _logger;
     std::unique_ptr<shmdata::Follower> _reader{nullptr};
     bool _capsIsValid{false};
+    Timer::Slot _frameSlot{}; //!< Timer slot for the frame reception, named after the mesh
 
     /**
      * \brief Base init for the class
@@ -1,6 +1,6 @@
 #include "./utils/cgutils.h"
 
-#include <future>
+#include "./core/thread_pool.h"
 
 using namespace std;
 
@@ -10,9 +10,10 @@ namespace Splash
 /*************/
 void hapDecodeCallback(HapDecodeWorkFunction func, void* p, unsigned int count, void* /*info*/)
 {
-    vector<future<void>> threads;
+    TaskGroup chunks;
     for (unsigned int i = 0; i < count; ++i)
-        threads.push_back(async(launch::async, [=]() { func(p, i); }));
+        chunks.run([=]() { func(p, i); });
+    chunks.wait();
 }
 
 /*************/
@@ -25,7 +25,11 @@
 #ifndef SPLASH_LOG_H
 #define SPLASH_LOG_H
 
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdlib>
 #include <ctime>
 #include <deque>
 #include <fstream>
@@ -33,6 +37,7 @@
 #include <iostream>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -43,11 +48,17 @@
 #include "./core/spinlock.h"
 
 #define SPLASH_LOG_FILE "/var/log/splash.log"
+#define SPLASH_LOG_RING_SIZE 1024
 
 namespace Splash
 {
 
 /*************/
+/**
+ * Messages are queued in a lock-free ring, and written to the console and to
+ * the log file by a background thread. If the ring is full, messages are dropped
+ * and counted instead of blocking the caller.
+ */
 class Log
 {
   public:
@@ -82,20 +93,23 @@ class Log
     template <typename... T>
     void operator()(Priority p, T... args)
     {
-        std::lock_guard<Spinlock> lock(_mutex);
-        rec(p, args...);
+        std::string message;
+        addToString(message, args...);
+        push(p, message);
     }
 
     /**
      * \brief Shortcut for setting MESSAGE log
+     * Nothing is formatted if the message priority is lower than the verbosity
      * \param msg Message
      * \return Return this Log object
      */
     template <typename T>
     Log& operator<<(const T& msg)
     {
-        std::lock_guard<Spinlock> lock(_mutex);
-        addToString(_tempString, msg);
+        auto& pending = getPendingRecord();
+        if (pending.priority >= _verbosity.load(std::memory_order_relaxed))
+            addToString(pending.message, msg);
         return *this;
     }
 
@@ -106,8 +120,9 @@ class Log
      */
     Log& operator<<(const Value& v)
     {
-        std::lock_guard<Spinlock> lock(_mutex);
-        addToString(_tempString, v.as<std::string>());
+        auto& pending = getPendingRecord();
+        if (pending.priority >= _verbosity.load(std::memory_order_relaxed))
+            addToString(pending.message, v.as<std::string>());
         return *this;
     }
 
@@ -118,13 +133,13 @@ class Log
      */
     Log& operator<<(Log::Action action)
     {
-        std::lock_guard<Spinlock> lock(_mutex);
         if (action == endl)
         {
-            if (_tempPriority >= _verbosity)
-                rec(_tempPriority, _tempString);
-            _tempString.clear();
-            _tempPriority = MESSAGE;
+            auto& pending = getPendingRecord();
+            if (pending.priority >= _verbosity.load(std::memory_order_relaxed))
+                push(pending.priority, pending.message);
+            pending.message.clear();
+            pending.priority = MESSAGE;
         }
         return *this;
     }
@@ -136,16 +151,40 @@ class Log
      */
     Log& operator<<(Log::Priority p)
     {
-        std::lock_guard<Spinlock> lock(_mutex);
-        _tempPriority = p;
+        getPendingRecord().priority = p;
         return *this;
     }
 
+    /**
+     * \brief Wait for all the queued messages to be written
+     * \param timeout Maximum time to wait, in ms
+     */
+    void flush(uint32_t timeout = 1000)
+    {
+        auto target = _writeIndex.load(std::memory_order_acquire);
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+        while (_readIndex.load(std::memory_order_acquire) < target && std::chrono::steady_clock::now() < deadline)
+        {
+            _writerCondition.notify_one();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    /**
+     * \brief Get the number of messages dropped because the queue was full
+     * \return Return the number of dropped messages
+     */
+    uint64_t getDroppedCount() const { return _droppedCount.load(std::memory_order_relaxed); }
+
     /**
      * \brief Get the full logs
      * \return Return the full logs
      */
-    std::deque<std::pair<std::string, Priority>> getFullLogs() { return _logs; }
+    std::deque<std::pair<std::string, Priority>> getFullLogs()
+    {
+        std::lock_guard<Spinlock> lock(_mutex);
+        return _logs;
+    }
 
     /**
      * \brief Get the logs by priority
@@ -206,20 +245,42 @@ class Log
     void setLog(const std::string& log, Priority priority)
     {
         std::lock_guard<Spinlock> lock(_mutex);
-        _logs.push_back(std::pair<std::string, Priority>(log, priority));
-
-        if (_logs.size() > _logLength)
-        {
-            _logPointer = _logPointer > 0 ? _logPointer - 1 : _logPointer;
-            _logs.pop_front();
-        }
+        addToHistory(log, priority);
     }
 
   private:
+    /**
+     * Slot of the message ring
+     */
+    struct Record
+    {
+        std::atomic_ullong sequence{0};
+        Priority priority{MESSAGE};
+        std::chrono::system_clock::time_point time{};
+        std::string message{};
+    };
+
+    /**
+     * Message being built by a thread through operator<<
+     */
+    struct PendingRecord
+    {
+        Priority priority{MESSAGE};
+        std::string message{};
+    };
+
     /**
      * \brief Constructor
      */
-    Log() {}
+    Log()
+    {
+        for (uint64_t i = 0; i < _ring.size(); ++i)
+            _ring[i].sequence.store(i, std::memory_order_relaxed);
+
+        _writerThread = std::thread([&]() { writerLoop(); });
+        _writerThread.detach();
+        std::atexit([]() { Log::get().flush(); });
+    }
 
     /**
      * \brief Destructor
@@ -235,13 +296,19 @@ class Log
   private:
     mutable Spinlock _mutex;
     std::deque<std::pair<std::string, Priority>> _logs;
-    bool _logToFile{false};
+    std::atomic_bool _logToFile{false};
     uint32_t _logLength{500};
     int _logPointer{0};
-    Priority _verbosity{MESSAGE};
+    std::atomic<Priority> _verbosity{MESSAGE};
+
+    std::array<Record, SPLASH_LOG_RING_SIZE> _ring{};
+    std::atomic_ullong _writeIndex{0};
+    std::atomic_ullong _readIndex{0};
+    std::atomic_ullong _droppedCount{0};
 
-    std::string _tempString;
-    Priority _tempPriority{MESSAGE};
+    std::thread _writerThread{};
+    std::mutex _writerMutex{};
+    std::condition_variable _writerCondition{};
 
     /*****/
     template <typename T, typename... Ts>
@@ -268,17 +335,139 @@ class Log
     void addToString(std::string&) const { return; }
 
     /**
-     * \brief Set a new log message
+     * \brief Get the message being built by the calling thread
+     * \return Return the pending record
      */
-    template <typename... T>
-    void rec(Priority p, T... args)
+    static PendingRecord& getPendingRecord()
     {
-        std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
-        std::time_t now_c = std::chrono::system_clock::to_time_t(now);
+        static thread_local PendingRecord record;
+        return record;
+    }
+
+    /**
+     * \brief Queue a message for the writer thread, without blocking
+     * The message content is swapped with the one of the ring slot, which is empty
+     * \param p Message priority
+     * \param message Message, emptied on success
+     * \return Return false if the ring is full and the message was dropped
+     */
+    bool push(Priority p, std::string& message)
+    {
+        auto index = _writeIndex.load(std::memory_order_relaxed);
+        Record* record = nullptr;
+        while (true)
+        {
+            record = &_ring[index % SPLASH_LOG_RING_SIZE];
+            auto sequence = record->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(index);
+            if (diff == 0)
+            {
+                if (_writeIndex.compare_exchange_weak(index, index + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                _droppedCount.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else
+            {
+                index = _writeIndex.load(std::memory_order_relaxed);
+            }
+        }
+
+        record->priority = p;
+        record->time = std::chrono::system_clock::now();
+        record->message.swap(message);
+        record->sequence.store(index + 1, std::memory_order_release);
+
+        _writerCondition.notify_one();
+        return true;
+    }
+
+    /**
+     * \brief Add a message to the history, _mutex being locked
+     * \param message Message
+     * \param p Priority
+     */
+    void addToHistory(const std::string& message, Priority p)
+    {
+        _logs.push_back(std::pair<std::string, Priority>(message, p));
+        if (_logs.size() > _logLength)
+        {
+            _logPointer = _logPointer > 0 ? _logPointer - 1 : _logPointer;
+            _logs.pop_front();
+        }
+    }
+
+    /**
+     * \brief Format the queued messages and write them, in the writer thread
+     */
+    void writerLoop()
+    {
+        std::ofstream logFile;
+        uint64_t reportedDropCount = 0;
+
+        while (true)
+        {
+            auto readIndex = _readIndex.load(std::memory_order_relaxed);
+            auto& record = _ring[readIndex % SPLASH_LOG_RING_SIZE];
+            if (record.sequence.load(std::memory_order_acquire) != readIndex + 1)
+            {
+                auto dropCount = _droppedCount.load(std::memory_order_relaxed);
+                if (dropCount != reportedDropCount)
+                {
+                    std::string message = "Log::" + std::string(__FUNCTION__) + " - " + std::to_string(dropCount - reportedDropCount) + " messages dropped, the queue was full";
+                    reportedDropCount = dropCount;
+                    if (push(WARNING, message))
+                        continue;
+                }
+
+                std::unique_lock<std::mutex> lock(_writerMutex);
+                _writerCondition.wait_for(lock, std::chrono::milliseconds(10));
+                continue;
+            }
+
+            if (_logToFile && !logFile.is_open())
+                logFile.open(SPLASH_LOG_FILE, std::ostream::out | std::ostream::app);
+            else if (!_logToFile && logFile.is_open())
+                logFile.close();
+
+            auto timedMsg = format(record.priority, record.time, record.message);
+            auto priority = record.priority;
+            record.message.clear();
+            record.sequence.store(readIndex + SPLASH_LOG_RING_SIZE, std::memory_order_release);
+
+            if (logFile.is_open() && logFile.good())
+                logFile << timedMsg << "\n" << std::flush;
+
+            if (priority >= _verbosity)
+                toConsole(timedMsg);
+
+            {
+                std::lock_guard<Spinlock> lock(_mutex);
+                addToHistory(timedMsg, priority);
+            }
+
+            _readIndex.store(readIndex + 1, std::memory_order_release);
+        }
+    }
+
+    /**
+     * \brief Format a message with its date and priority
+     * \param p Message priority
+     * \param time Message time
+     * \param message Message
+     * \return Return the formatted message
+     */
+    std::string format(Priority p, std::chrono::system_clock::time_point time, const std::string& message) const
+    {
+        std::time_t time_t = std::chrono::system_clock::to_time_t(time);
+        std::tm localTime;
+        localtime_r(&time_t, &localTime);
         char time_c[64];
-        strftime(time_c, 64, "%FT%T", std::localtime(&now_c));
+        strftime(time_c, 64, "%FT%T", &localTime);
 
-        std::string timedMsg;
         std::string type;
         if (p == Priority::MESSAGE)
             type = std::string("[MESSAGE]");
@@ -289,31 +478,7 @@ class Log
         else if (p == Priority::ERROR)
             type = std::string(" [ERROR] ");
 
-        timedMsg = std::string(time_c) + std::string(" / ") + type + std::string(" / ");
-
-        addToString(timedMsg, args...);
-
-        // Write to log file, if we may
-        if (_logToFile)
-        {
-            std::ofstream logFile(SPLASH_LOG_FILE, std::ostream::out | std::ostream::app);
-            if (logFile.good())
-            {
-                logFile << timedMsg << "\n";
-                logFile.close();
-            }
-        }
-
-        // Write to console
-        if (p >= _verbosity)
-            toConsole(timedMsg);
-
-        _logs.push_back(std::pair<std::string, Priority>(timedMsg, p));
-        if (_logs.size() > _logLength)
-        {
-            _logPointer = _logPointer > 0 ? _logPointer - 1 : _logPointer;
-            _logs.erase(_logs.begin());
-        }
+        return std::string(time_c) + std::string(" / ") + type + std::string(" / ") + message;
     }
 
     /*****/
@@ -0,0 +1,46 @@
+#include "./utils/timer.h"
+
+#include "./utils/log.h"
+
+using namespace std;
+
+namespace Splash
+{
+
+/*************/
+uint32_t Timer::registerSlot(const string& name)
+{
+    auto slotIt = _slotIds.find(name);
+    if (slotIt != _slotIds.end())
+        return slotIt->second;
+
+    uint32_t id = 0;
+    if (!_freeSlotIds.empty())
+    {
+        id = _freeSlotIds.back();
+        _freeSlotIds.pop_back();
+        _slots[id]->name = name;
+    }
+    else
+    {
+        id = _slotCount.load(memory_order_relaxed);
+        if (id >= SPLASH_TIMER_MAX_SLOTS)
+        {
+            if (!_slotsExhausted)
+            {
+                _slotsExhausted = true;
+                Log::get() << Log::WARNING << "Timer::" << __FUNCTION__ << " - All " << SPLASH_TIMER_MAX_SLOTS << " slots are in use, durations such as " << name
+                           << " will not be measured" << Log::endl;
+            }
+            return 0;
+        }
+
+        _slots[id] = new SlotData(name);
+        _slotCount.store(id + 1, memory_order_release);
+    }
+
+    _slotIds.emplace(name, id);
+    return id;
+}
+
+} // namespace Splash
@@ -25,14 +25,24 @@
 #ifndef SPLASH_TIMER_H
 #define SPLASH_TIMER_H
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <limits>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "./config.h"
 #include "./core/coretypes.h"
 #include "./core/spinlock.h"
+#include "./utils/tracer.h"
+
+#define SPLASH_TIMER_MAX_SLOTS 4096
+#define SPLASH_TIMER_WINDOW_SIZE 256
 
 namespace Splash
 {
@@ -52,6 +62,29 @@ class Timer
         bool paused{false};
     };
 
+    /**
+     * Handle to a registered duration, to measure it without looking up its name
+     */
+    struct Slot
+    {
+        uint32_t id{0}; //!< Slot index, 0 being invalid
+        explicit operator bool() const { return id != 0; }
+    };
+
+    /**
+     * Statistics over the last SPLASH_TIMER_WINDOW_SIZE samples of a duration, in us
+     */
+    struct Stats
+    {
+        unsigned long long last{0};
+        unsigned long long min{0};
+        unsigned long long mean{0};
+        unsigned long long p50{0};
+        unsigned long long p99{0};
+        unsigned long long max{0};
+        unsigned long long count{0}; //!< Total number of samples since the slot was registered
+    };
+
     /**
      * \brief Get the singleton
      * \return Return the Timer singleton
@@ -86,64 +119,127 @@ class Timer
     bool isLoose() const { return _looseClock; }
 
     /**
-     * \brief Start a duration measurement
+     * \brief Get the slot for the given duration name, registering it if needed
+     * Lookups are cached per thread, so only the first one from a given thread takes a lock
      * \param name Duration name
+     * \return Return the slot, which is invalid if too many slots were registered
      */
-    void start(const std::string& name)
+    Slot getSlot(const std::string& name)
     {
-        if (!_enabled)
+        auto& cache = getSlotCache();
+        auto cacheIt = cache.find(name);
+        if (cacheIt != cache.end())
+            return {cacheIt->second};
+
+        std::lock_guard<std::mutex> lock(_registerMutex);
+        auto id = registerSlot(name);
+        if (id != 0)
+            cache.emplace(name, id);
+        return {id};
+    }
+
+    /**
+     * \brief Get the slot for the given duration name and hold it until releaseSlot is called
+     * Objects measuring durations named after themselves should use this, so that the slot is freed along with them
+     * \param name Duration name
+     * \return Return the slot, which is invalid if too many slots were registered
+     */
+    Slot acquireSlot(const std::string& name)
+    {
+        std::lock_guard<std::mutex> lock(_registerMutex);
+        auto id = registerSlot(name);
+        if (id != 0)
+            ++_slots[id]->holders;
+        return {id};
+    }
+
+    /**
+     * \brief Release a slot obtained from acquireSlot
+     * Once its last holder released it, the slot is unregistered and its id can be reused for another duration
+     * \param slot Duration slot, reset to invalid
+     */
+    void releaseSlot(Slot& slot)
+    {
+        if (!slot)
             return;
 
-        auto currentTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
-        auto timeIt = _timeMap.find(name);
-        if (timeIt == _timeMap.end())
-            _timeMap[name].store(currentTime, std::memory_order_acq_rel);
-        else
-            timeIt->second = currentTime;
+        std::lock_guard<std::mutex> lock(_registerMutex);
+        auto& data = *_slots[slot.id];
+        if (data.holders > 0 && --data.holders == 0)
+        {
+            _slotIds.erase(data.name);
+            data.name.clear();
+            data.lastStart.store(-1, std::memory_order_relaxed);
+            data.lastDuration.store(0, std::memory_order_relaxed);
+            data.sampleCount.store(0, std::memory_order_release);
+            _freeSlotIds.push_back(slot.id);
+            // Invalidates the per thread caches, which may still map the name to this id
+            _slotGeneration.fetch_add(1, std::memory_order_acq_rel);
+        }
+        slot = {};
+    }
+
+    /**
+     * \brief Start a duration measurement
+     * If the slot was already started from this thread, the previous start is replaced
+     * \param slot Duration slot
+     */
+    void start(Slot slot)
+    {
+        if (!_enabled || !slot)
+            return;
+
+        auto currentTime = getTime();
+        auto& starts = getThreadState().starts;
+        auto startIt = std::find_if(starts.begin(), starts.end(), [&](const StartEntry& entry) { return entry.slot == slot.id; });
+        if (startIt != starts.end())
+            starts.erase(startIt);
+        starts.push_back({slot.id, currentTime});
+
+        // Also kept in the slot, for durations which are stopped from another thread
+        _slots[slot.id]->lastStart.store(currentTime, std::memory_order_relaxed);
     }
 
+    void start(const std::string& name) { start(getSlot(name)); }
+
     /**
      * \brief End a duration measurement
-     * \param name Duration name
+     * \param slot Duration slot
      */
-    void stop(const std::string& name)
+    void stop(Slot slot)
     {
-        if (!_enabled)
+        if (!_enabled || !slot)
             return;
 
-        auto timeIt = _timeMap.find(name);
-        if (timeIt != _timeMap.end())
-        {
-            auto currentTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        auto currentTime = getTime();
+        int64_t startTime;
+        if (!popStart(slot, startTime))
+            return;
 
-            auto durationIt = _durationMap.find(name);
-            if (durationIt == _durationMap.end())
-                _durationMap[name].store(currentTime - timeIt->second.load(std::memory_order_acq_rel), std::memory_order_acq_rel);
-            else
-                durationIt->second = currentTime - timeIt->second.load(std::memory_order_acq_rel);
-        }
+        record(slot, currentTime - startTime);
+        if (Tracer::get().isEnabled())
+            Tracer::get().record(slot.id, startTime, currentTime - startTime);
     }
 
+    void stop(const std::string& name) { stop(getSlot(name)); }
+
     /**
      * \brief Wait for the specified timer to reach a certain value, in us
-     * \param name Duration name
+     * \param slot Duration slot
      * \param duration Desired duration
-     * \return Return false if the timer does not exist
+     * \return Return false if the timer has not been started
      */
-    bool waitUntilDuration(const std::string& name, unsigned long long duration)
+    bool waitUntilDuration(Slot slot, unsigned long long duration)
     {
-        if (!_enabled)
+        if (!_enabled || !slot)
             return false;
 
-        if (_timeMap.find(name) == _timeMap.end())
+        auto currentTime = getTime();
+        int64_t startTime;
+        if (!popStart(slot, startTime))
             return false;
 
-        auto currentTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
-        auto timeIt = _timeMap.find(name);
-        auto durationIt = _durationMap.find(name);
-        unsigned long long elapsed;
-
-        elapsed = currentTime - timeIt->second.load(std::memory_order_acq_rel);
+        unsigned long long elapsed = currentTime - startTime;
 
         timespec nap;
         nap.tv_sec = 0;
@@ -156,49 +252,124 @@ class Timer
             overtime = true;
         }
 
-        if (durationIt == _durationMap.end())
-            _durationMap[name].store(std::max(duration, elapsed), std::memory_order_acq_rel);
-        else
-            durationIt->second = std::max(duration, elapsed);
+        record(slot, std::max(duration, elapsed));
+        if (Tracer::get().isEnabled())
+            Tracer::get().record(slot.id, startTime, elapsed);
 
         nanosleep(&nap, NULL);
 
         return overtime;
     }
 
+    bool waitUntilDuration(const std::string& name, unsigned long long duration) { return waitUntilDuration(getSlot(name), duration); }
+
     /**
      * \brief Get the last occurence of the specified duration
-     * \param name Duration name
+     * \param slot Duration slot
      * \return Return the duration in us
      */
-    unsigned long long getDuration(const std::string& name) const
+    unsigned long long getDuration(Slot slot) const
     {
-        auto durationIt = _durationMap.find(name);
-        if (durationIt == _durationMap.end())
+        if (!slot)
             return 0;
-        return durationIt->second;
+        return _slots[slot.id]->lastDuration.load(std::memory_order_relaxed);
     }
 
+    unsigned long long getDuration(const std::string& name) const { return getDuration(findSlot(name)); }
+
     /**
-     * \brief Get the whole duration map
-     * \return Return the whole duration map
+     * \brief Get the name of a slot
+     * \param slot Duration slot
+     * \return Return the name, or an empty string if the slot is invalid
      */
-    const std::unordered_map<std::string, std::atomic_ullong>& getDurationMap() const { return _durationMap; }
+    std::string getSlotName(Slot slot) const
+    {
+        if (!slot || slot.id >= _slotCount.load(std::memory_order_acquire))
+            return {};
+        std::lock_guard<std::mutex> lock(_registerMutex);
+        return _slots[slot.id]->name;
+    }
+
+    /**
+     * \brief Get statistics over the last samples of the specified duration
+     * \param slot Duration slot
+     * \return Return the statistics, in us
+     */
+    Stats getStats(Slot slot) const
+    {
+        if (!slot)
+            return {};
+
+        const auto& data = *_slots[slot.id];
+        Stats stats;
+        stats.count = data.sampleCount.load(std::memory_order_acquire);
+        stats.last = data.lastDuration.load(std::memory_order_relaxed);
+        if (stats.count == 0)
+            return stats;
+
+        auto sampleCount = std::min<unsigned long long>(stats.count, SPLASH_TIMER_WINDOW_SIZE);
+        std::vector<unsigned long long> samples(sampleCount);
+        for (size_t i = 0; i < sampleCount; ++i)
+            samples[i] = data.samples[i].load(std::memory_order_relaxed);
+        std::sort(samples.begin(), samples.end());
+
+        unsigned long long sum = 0;
+        for (auto sample : samples)
+            sum += sample;
+
+        stats.min = samples.front();
+        stats.max = samples.back();
+        stats.mean = sum / sampleCount;
+        stats.p50 = samples[(sampleCount - 1) * 50 / 100];
+        stats.p99 = samples[(sampleCount - 1) * 99 / 100];
+        return stats;
+    }
+
+    Stats getStats(const std::string& name) const { return getStats(findSlot(name)); }
+
+    /**
+     * \brief Get the last value of all the measured durations
+     * \return Return a map of the durations, in us
+     */
+    std::unordered_map<std::string, unsigned long long> getDurationMap() const
+    {
+        std::unordered_map<std::string, unsigned long long> durations;
+        std::lock_guard<std::mutex> lock(_registerMutex);
+        auto slotCount = _slotCount.load(std::memory_order_acquire);
+        for (uint32_t id = 1; id < slotCount; ++id)
+            if (_slots[id]->sampleCount.load(std::memory_order_acquire) != 0)
+                durations.emplace(_slots[id]->name, _slots[id]->lastDuration.load(std::memory_order_relaxed));
+        return durations;
+    }
+
+    /**
+     * \brief Get the statistics of all the measured durations
+     * \return Return a map of the statistics, in us
+     */
+    std::unordered_map<std::string, Stats> getStatsMap() const
+    {
+        std::unordered_map<std::string, Stats> stats;
+        std::lock_guard<std::mutex> lock(_registerMutex);
+        auto slotCount = _slotCount.load(std::memory_order_acquire);
+        for (uint32_t id = 1; id < slotCount; ++id)
+            if (_slots[id]->sampleCount.load(std::memory_order_acquire) != 0)
+                stats.emplace(_slots[id]->name, getStats(Slot{id}));
+        return stats;
+    }
 
     /**
      * \brief Set an element in the duration map. Used for transmitting timings between pairs
-     * \param name Duration name
+     * \param slot Duration slot
      * \param value Duration in us
      */
-    void setDuration(const std::string& name, unsigned long long value)
+    void setDuration(Slot slot, unsigned long long value)
     {
-        auto durationIt = _durationMap.find(name);
-        if (durationIt == _durationMap.end())
-            _durationMap[name].store(value, std::memory_order_acq_rel);
-        else
-            durationIt->second = value;
+        if (slot)
+            record(slot, value);
     }
 
+    void setDuration(const std::string& name, unsigned long long value) { setDuration(getSlot(name), value); }
+
     /**
      * \brief Return the duration since the last call with this name, or 0 if it is the first time.
      * \param name Duration name
@@ -206,56 +377,55 @@ class Timer
      */
     unsigned long long sinceLastSeen(const std::string& name)
     {
-        if (_timeMap.find(name) == _timeMap.end())
+        auto slot = getSlot(name);
+        if (!slot || _slots[slot.id]->lastStart.load(std::memory_order_relaxed) < 0)
         {
-            start(name);
+            start(slot);
             return 0;
         }
 
-        stop(name);
-        unsigned long long duration = getDuration(name);
-        start(name);
+        stop(slot);
+        unsigned long long duration = getDuration(slot);
+        start(slot);
         return duration;
     }
 
     /**
      * Some facilities
      */
-    Timer& operator<<(const std::string& name)
+    Timer& operator<<(Slot slot)
     {
-        start(name);
-        _currentDuration.store(0, std::memory_order_acq_rel);
+        start(slot);
         return *this;
     }
 
+    Timer& operator<<(const std::string& name) { return operator<<(getSlot(name)); }
+
+    /**
+     * The duration is kept for the calling thread, and used by its next call to operator>>(slot)
+     */
     Timer& operator>>(unsigned long long duration)
     {
-        _timerMutex.lock(); // We lock the mutex to prevent this value to be reset by another call to timer
-        _currentDuration.store(duration, std::memory_order_acq_rel);
-        _durationThreadId = std::this_thread::get_id();
-        _isDurationSet = true;
+        getThreadState().pendingDuration = duration;
         return *this;
     }
 
-    bool operator>>(const std::string& name)
+    bool operator>>(Slot slot)
     {
-        unsigned long long duration = 0;
-        if (_isDurationSet && _durationThreadId == std::this_thread::get_id())
-        {
-            _isDurationSet = false;
-            duration = _currentDuration.load(std::memory_order_acq_rel);
-            _currentDuration.store(0, std::memory_order_acq_rel);
-            _timerMutex.unlock();
-        }
+        auto& pendingDuration = getThreadState().pendingDuration;
+        auto duration = pendingDuration;
+        pendingDuration = 0;
 
         bool overtime = false;
         if (duration > 0)
-            overtime = waitUntilDuration(name, duration);
+            overtime = waitUntilDuration(slot, duration);
         else
-            stop(name);
+            stop(slot);
         return overtime;
     }
 
+    bool operator>>(const std::string& name) { return operator>>(getSlot(name)); }
+
     unsigned long long operator[](const std::string& name) { return getDuration(name); }
 
     /**
@@ -306,6 +476,7 @@ class Timer
 
     /**
      * \brief Get the master clock time, corrected from the last update time
+     * When the virtual clock is enabled, it replaces the master clock
      * \param time Master clock time, unit based on template parameter
      * \param paused True if the clock is paused
      * \return Return true if the master clock is set
@@ -313,6 +484,13 @@ class Timer
     template <typename T>
     bool getMasterClock(int64_t& time, bool& paused) const
     {
+        if (_virtualClock.load(std::memory_order_acquire))
+        {
+            time = std::chrono::duration_cast<T>(std::chrono::microseconds(_virtualTime.load(std::memory_order_acquire))).count();
+            paused = false;
+            return true;
+        }
+
         if (!_clockSet)
         {
             paused = false;
@@ -349,19 +527,176 @@ class Timer
      */
     static inline int64_t getTime() { return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
 
+    /**
+     * \brief Enable or disable the virtual clock, used for offline rendering
+     * While enabled, media are played according to the virtual time instead of the wall time
+     * \param enabled If true, enable the virtual clock
+     */
+    void setVirtualClock(bool enabled) { _virtualClock.store(enabled, std::memory_order_release); }
+
+    /**
+     * \brief Get whether the virtual clock is enabled
+     * \return Return true if enabled
+     */
+    bool isVirtualClock() const { return _virtualClock.load(std::memory_order_acquire); }
+
+    /**
+     * \brief Set the virtual time
+     * \param time Virtual time, in us
+     */
+    void setVirtualTime(int64_t time) { _virtualTime.store(time, std::memory_order_release); }
+
+    /**
+     * \brief Get the virtual time
+     * \return Return the virtual time, in us
+     */
+    int64_t getVirtualTime() const { return _virtualTime.load(std::memory_order_acquire); }
+
+    /**
+     * \brief Get the time media playback is based upon
+     * \return Return the virtual time if the virtual clock is enabled, the current time otherwise, in us
+     */
+    int64_t getMediaTime() const { return isVirtualClock() ? getVirtualTime() : getTime(); }
+
+  private:
+    /**
+     * Data of a registered duration. Samples are written in a ring, without locking
+     */
+    struct SlotData
+    {
+        SlotData(const std::string& slotName)
+            : name(slotName)
+        {
+            for (auto& sample : samples)
+                sample.store(0, std::memory_order_relaxed);
+        }
+
+        std::string name; //!< Modified under _registerMutex, empty while the slot is free
+        uint32_t holders{0}; //!< Number of acquireSlot calls not yet released, modified under _registerMutex
+        std::atomic<int64_t> lastStart{-1};
+        std::atomic_ullong lastDuration{0};
+        std::atomic_ullong sampleCount{0};
+        std::array<std::atomic_ullong, SPLASH_TIMER_WINDOW_SIZE> samples;
+    };
+
+    struct StartEntry
+    {
+        uint32_t slot;
+        int64_t time;
+    };
+
+    /**
+     * Per thread state, so that measuring a duration does not need any lock
+     */
+    struct ThreadState
+    {
+        std::unordered_map<std::string, uint32_t> slots{}; //!< Cache of the slot ids for this thread
+        uint64_t slotGeneration{0};                        //!< Value of _slotGeneration the cache matches
+        std::vector<StartEntry> starts{};                  //!< Stack of started durations
+        unsigned long long pendingDuration{0};             //!< Duration set by operator>>(unsigned long long)
+    };
+
   private:
     Timer() {}
     ~Timer() {}
     Timer(const Timer&) = delete;
     const Timer& operator=(const Timer&) = delete;
 
+    /**
+     * \brief Get the state of the calling thread
+     * \return Return the thread state
+     */
+    static ThreadState& getThreadState()
+    {
+        static thread_local ThreadState state;
+        return state;
+    }
+
+    /**
+     * \brief Get the slot cache of the calling thread, emptied if slots were released since it was filled
+     * \return Return the cache
+     */
+    std::unordered_map<std::string, uint32_t>& getSlotCache() const
+    {
+        auto& state = getThreadState();
+        auto generation = _slotGeneration.load(std::memory_order_acquire);
+        if (state.slotGeneration != generation)
+        {
+            state.slots.clear();
+            state.slotGeneration = generation;
+        }
+        return state.slots;
+    }
+
+    /**
+     * \brief Register the given duration, or get its id if already registered. Must be called with _registerMutex locked
+     * \param name Duration name
+     * \return Return the slot id, or 0 if all slots are in use
+     */
+    uint32_t registerSlot(const std::string& name);
+
+    /**
+     * \brief Find the slot of the given duration, without registering it
+     * \param name Duration name
+     * \return Return the slot, invalid if not found
+     */
+    Slot findSlot(const std::string& name) const
+    {
+        auto& cache = getSlotCache();
+        auto cacheIt = cache.find(name);
+        if (cacheIt != cache.end())
+            return {cacheIt->second};
+
+        std::lock_guard<std::mutex> lock(_registerMutex);
+        auto slotIt = _slotIds.find(name);
+        if (slotIt == _slotIds.end())
+            return {};
+        return {slotIt->second};
+    }
+
+    /**
+     * \brief Remove the start of the given slot from the calling thread stack
+     * \param slot Duration slot
+     * \param startTime Start time, from this thread or else from the last start in any thread
+     * \return Return false if the slot was never started
+     */
+    bool popStart(Slot slot, int64_t& startTime)
+    {
+        auto& starts = getThreadState().starts;
+        for (auto startIt = starts.rbegin(); startIt != starts.rend(); ++startIt)
+        {
+            if (startIt->slot != slot.id)
+                continue;
+            startTime = startIt->time;
+            starts.erase(std::next(startIt).base());
+            return true;
+        }
+
+        startTime = _slots[slot.id]->lastStart.load(std::memory_order_relaxed);
+        return startTime >= 0;
+    }
+
+    /**
+     * \brief Add a sample to the given slot
+     * \param slot Duration slot
+     * \param value Duration in us
+     */
+    void record(Slot slot, unsigned long long value)
+    {
+        auto& data = *_slots[slot.id];
+        data.lastDuration.store(value, std::memory_order_relaxed);
+        auto index = data.sampleCount.fetch_add(1, std::memory_order_acq_rel);
+        data.samples[index % SPLASH_TIMER_WINDOW_SIZE].store(value, std::memory_order_relaxed);
+    }
+
   private:
-    std::unordered_map<std::string, std::atomic_ullong> _timeMap;
-    std::unordered_map<std::string, std::atomic_ullong> _durationMap;
-    std::atomic_ullong _currentDuration{0};
-    bool _isDurationSet{false};
-    std::thread::id _durationThreadId;
-    mutable Spinlock _timerMutex;
+    mutable std::mutex _registerMutex{};
+    std::unordered_map<std::string, uint32_t> _slotIds{};   //!< Slot ids by name, modified under _registerMutex
+    std::array<SlotData*, SPLASH_TIMER_MAX_SLOTS> _slots{}; //!< Slot data, never deallocated as other threads may still hold the ids
+    std::atomic_uint _slotCount{1};                         //!< Number of allocated slots, slot 0 being invalid
+    std::vector<uint32_t> _freeSlotIds{};                   //!< Released slots, reused before allocating new ones
+    std::atomic<uint64_t> _slotGeneration{0};               //!< Incremented whenever a slot is released
+    bool _slotsExhausted{false};                            //!< Set once the slot limit was hit, to warn only once
     mutable Spinlock _clockMutex;
     bool _enabled{true};
     bool _isDebug{false};
@@ -369,6 +704,8 @@ class Timer
     std::chrono::microseconds _lastMasterClockUpdate{};
     Timer::Point _clock;
     bool _clockSet{false};
+    std::atomic_bool _virtualClock{false}; //!< If true, media follow _virtualTime
+    std::atomic<int64_t> _virtualTime{0};  //!< Virtual time, in us
 };
 
 } // namespace Splash
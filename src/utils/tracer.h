@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2018 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @tracer.h
+ * The Tracer class, recording timed events for the Chrome trace format
+ */
+
+#ifndef SPLASH_TRACER_H
+#define SPLASH_TRACER_H
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <json/json.h>
+
+#define SPLASH_TRACER_RING_SIZE 65536
+
+namespace Splash
+{
+
+/*************/
+/**
+ * Records timed events in a lock-free ring, while tracing is enabled.
+ * Events only hold a name id, resolved when they are converted to JSON.
+ * Timestamps are in us, from the same clock as Timer::getTime().
+ */
+class Tracer
+{
+  public:
+    enum class Category : uint32_t
+    {
+        cpu = 0,
+        gpu
+    };
+
+    struct Event
+    {
+        uint32_t name{0};
+        uint32_t thread{0};
+        Category category{Category::cpu};
+        int64_t start{0};
+        int64_t duration{0};
+    };
+
+    /**
+     * \brief Get the singleton
+     * \return Return the Tracer singleton
+     */
+    static Tracer& get()
+    {
+        static auto instance = new Tracer;
+        return *instance;
+    }
+
+    /**
+     * \brief Get whether tracing is enabled
+     * \return Return true if enabled
+     */
+    bool isEnabled() const { return _enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * \brief Enable or disable tracing. Enabling it discards previous events
+     * The ring is allocated the first time tracing is enabled, and never freed
+     * \param enabled If true, enable tracing
+     */
+    void setEnabled(bool enabled)
+    {
+        if (enabled && !_ring.load(std::memory_order_acquire))
+        {
+            auto ring = new Slot[SPLASH_TRACER_RING_SIZE];
+            Slot* expected = nullptr;
+            if (!_ring.compare_exchange_strong(expected, ring, std::memory_order_acq_rel))
+                delete[] ring;
+        }
+
+        if (enabled && !_enabled)
+            _firstIndex.store(_writeIndex.load(std::memory_order_acquire), std::memory_order_release);
+        _enabled.store(enabled, std::memory_order_release);
+    }
+
+    /**
+     * \brief Record an event, without locking. The oldest events are overwritten when the ring is full
+     * \param name Event name id
+     * \param start Start time, in us
+     * \param duration Duration, in us
+     * \param category Event category
+     */
+    void record(uint32_t name, int64_t start, int64_t duration, Category category = Category::cpu)
+    {
+        auto ring = _ring.load(std::memory_order_acquire);
+        if (!ring)
+            return;
+
+        auto index = _writeIndex.fetch_add(1, std::memory_order_relaxed);
+        auto& slot = ring[index % SPLASH_TRACER_RING_SIZE];
+
+        // The sequence tells readers whether the slot is being written
+        slot.sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.name.store(name, std::memory_order_relaxed);
+        slot.thread.store(getThreadIndex(), std::memory_order_relaxed);
+        slot.category.store(static_cast<uint32_t>(category), std::memory_order_relaxed);
+        slot.start.store(start, std::memory_order_relaxed);
+        slot.duration.store(duration, std::memory_order_relaxed);
+        slot.sequence.store(index + 1, std::memory_order_release);
+    }
+
+    /**
+     * \brief Get the events recorded since tracing was enabled, and still in the ring
+     * \return Return the events
+     */
+    std::vector<Event> getEvents() const
+    {
+        auto ring = _ring.load(std::memory_order_acquire);
+        if (!ring)
+            return {};
+
+        auto lastIndex = _writeIndex.load(std::memory_order_acquire);
+        auto firstIndex = _firstIndex.load(std::memory_order_acquire);
+        if (lastIndex - firstIndex > SPLASH_TRACER_RING_SIZE)
+            firstIndex = lastIndex - SPLASH_TRACER_RING_SIZE;
+
+        std::vector<Event> events;
+        events.reserve(lastIndex - firstIndex);
+        for (auto index = firstIndex; index < lastIndex; ++index)
+        {
+            const auto& slot = ring[index % SPLASH_TRACER_RING_SIZE];
+            if (slot.sequence.load(std::memory_order_acquire) != index + 1)
+                continue;
+
+            Event event;
+            event.name = slot.name.load(std::memory_order_relaxed);
+            event.thread = slot.thread.load(std::memory_order_relaxed);
+            event.category = static_cast<Category>(slot.category.load(std::memory_order_relaxed));
+            event.start = slot.start.load(std::memory_order_relaxed);
+            event.duration = slot.duration.load(std::memory_order_relaxed);
+
+            // Skip the event if it has been overwritten while being read
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != index + 1)
+                continue;
+
+            events.push_back(event);
+        }
+
+        return events;
+    }
+
+    /**
+     * \brief Convert events to Chrome trace events
+     * \param events Events to convert
+     * \param pid Process id to set in the trace
+     * \param processName Process name to display
+     * \param getName Function returning the name of an event from its name id
+     * \param clockOffset Offset to add to the timestamps, in us
+     * \return Return a JSON array of trace events
+     */
+    static Json::Value toChromeTrace(
+        const std::vector<Event>& events, int pid, const std::string& processName, const std::function<std::string(uint32_t)>& getName, int64_t clockOffset = 0)
+    {
+        Json::Value traceEvents(Json::arrayValue);
+
+        Json::Value processEvent;
+        processEvent["name"] = "process_name";
+        processEvent["ph"] = "M";
+        processEvent["pid"] = pid;
+        processEvent["args"]["name"] = processName;
+        traceEvents.append(processEvent);
+
+        for (const auto& event : events)
+        {
+            Json::Value traceEvent;
+            traceEvent["name"] = getName(event.name);
+            traceEvent["cat"] = event.category == Category::gpu ? "gpu" : "cpu";
+            traceEvent["ph"] = "X";
+            traceEvent["ts"] = static_cast<Json::Int64>(event.start + clockOffset);
+            traceEvent["dur"] = static_cast<Json::Int64>(event.duration);
+            traceEvent["pid"] = pid;
+            // GPU events get their own track
+            traceEvent["tid"] = event.category == Category::gpu ? 0 : event.thread;
+            traceEvents.append(traceEvent);
+        }
+
+        return traceEvents;
+    }
+
+  private:
+    /**
+     * Slot of the event ring, only made of atomics so that it can be read while written
+     */
+    struct Slot
+    {
+        std::atomic_ullong sequence{0};
+        std::atomic_uint name{0};
+        std::atomic_uint thread{0};
+        std::atomic_uint category{0};
+        std::atomic<int64_t> start{0};
+        std::atomic<int64_t> duration{0};
+    };
+
+    Tracer() {}
+    ~Tracer() {}
+    Tracer(const Tracer&) = delete;
+    const Tracer& operator=(const Tracer&) = delete;
+
+    /**
+     * \brief Get a small index for the calling thread, 0 being kept for the GPU
+     * \return Return the thread index
+     */
+    uint32_t getThreadIndex()
+    {
+        static thread_local uint32_t threadIndex = _nextThreadIndex.fetch_add(1, std::memory_order_relaxed);
+        return threadIndex;
+    }
+
+  private:
+    std::atomic_bool _enabled{false};
+    std::atomic<Slot*> _ring{nullptr};    //!< Event ring, allocated when tracing is first enabled
+    std::atomic_ullong _writeIndex{0};    //!< Index of the next event to write
+    std::atomic_ullong _firstIndex{0};    //!< Index of the first event recorded since tracing was enabled
+    std::atomic_uint _nextThreadIndex{1}; //!< Next thread index, 0 being the GPU
+};
+
+} // namespace Splash
+
+#endif // SPLASH_TRACER_H
@@ -28,3 +28,79 @@ TEST_CASE("Testing Attribute")
     CHECK(attr()[0].as<int>() == 42);
     attr.unlock();
 }
+
+/*************/
+TEST_CASE("Testing Attribute generation")
+{
+    auto attr = Attribute("attribute", [&](const Values& args) { return args[0].as<int>() >= 0; }, nullptr, {'n'});
+    auto generation = attr.getGeneration();
+
+    CHECK(attr({42}) == true);
+    CHECK(attr.getGeneration() == generation + 1);
+
+    // Failed sets do not change the generation
+    CHECK(attr({-1}) == false);
+    CHECK(attr({"Patate"}) == false);
+    CHECK(attr.getGeneration() == generation + 1);
+
+    auto defaultAttr = Attribute("default");
+    generation = defaultAttr.getGeneration();
+    defaultAttr({1, 2});
+    defaultAttr({1, 2});
+    CHECK(defaultAttr.getGeneration() == generation + 2);
+}
+
+/*************/
+TEST_CASE("Testing interned names")
+{
+    auto firstId = NameRegistry::intern("interned");
+    auto otherId = NameRegistry::intern("notInterned");
+
+    CHECK(NameRegistry::intern("interned") == firstId);
+    CHECK(firstId != otherId);
+    CHECK(NameRegistry::getInternedName(firstId) == "interned");
+    CHECK(NameRegistry::intern("") == 0);
+}
+
+/*************/
+TEST_CASE("Testing AttributeHandle")
+{
+    float value = 0.f;
+    bool updatedParams = false;
+    auto attr = Attribute("attribute",
+        [&](const Values& args) {
+            value = args[0].as<float>();
+            return true;
+        },
+        [&]() -> Values { return {value}; },
+        {'n'});
+
+    // Without binding, the handle goes through the setter and getter
+    auto handle = AttributeHandle<float>(&attr, &updatedParams);
+    CHECK(handle.set(4.f));
+    CHECK(value == 4.f);
+    CHECK(handle.get() == 4.f);
+    CHECK(updatedParams);
+
+    // Once bound, the variable is accessed directly
+    attr.bind(&value);
+    auto generation = attr.getGeneration();
+    CHECK(handle.set(8.f));
+    CHECK(value == 8.f);
+    CHECK(attr.getGeneration() == generation + 1);
+    value = 16.f;
+    CHECK(handle.get() == 16.f);
+
+    // A handle of another type falls back to the getter
+    auto intHandle = AttributeHandle<int>(&attr, nullptr);
+    CHECK(intHandle.get() == 16);
+
+    attr.lock();
+    CHECK(!handle.set(32.f));
+    CHECK(value == 16.f);
+    attr.unlock();
+
+    auto valuesHandle = AttributeHandle<Values>(&attr, nullptr);
+    CHECK(valuesHandle.set({2.f}));
+    CHECK(valuesHandle.get()[0].as<float>() == 2.f);
+}
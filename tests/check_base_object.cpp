@@ -41,6 +41,7 @@ class GraphObjectMock : public GraphObject
             },
             [&]() -> Values { return {_float}; },
             {'n'});
+        setAttributeParameter("float", true, false, true);
 
         addAttribute("string",
             [&](const Values& args) {
@@ -110,3 +111,14 @@ TEST_CASE("Testing GraphObject attribute registering")
     object->setAttribute("someAttribute", {1337});
     CHECK(someString != otherString);
 }
+
+/*************/
+TEST_CASE("Testing GraphObject attribute coalescing flag")
+{
+    auto object = make_unique<GraphObjectMock>(nullptr);
+
+    // Coalescing is opt-in, having a getter is not enough
+    CHECK(object->isAttributeCoalesced("float"));
+    CHECK(!object->isAttributeCoalesced("integer"));
+    CHECK(!object->isAttributeCoalesced("inexistingAttribute"));
+}
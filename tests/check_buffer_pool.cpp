@@ -0,0 +1,104 @@
+#include <doctest.h>
+
+#include <chrono>
+
+#include "./core/buffer_pool.h"
+#include "./core/resizable_array.h"
+
+using namespace std;
+using namespace Splash;
+
+/*************/
+TEST_CASE("Testing BufferPool capacity buckets")
+{
+    CHECK(BufferPool::getCapacity(1024) == 0);
+    CHECK(BufferPool::getCapacity(SPLASH_BUFFER_POOL_MIN_SIZE) == SPLASH_BUFFER_POOL_MIN_SIZE);
+    for (size_t size = SPLASH_BUFFER_POOL_MIN_SIZE; size < (1ull << 28); size = size * 3 / 2 + 1)
+    {
+        auto capacity = BufferPool::getCapacity(size);
+        CHECK(capacity >= size);
+        CHECK(capacity <= size + size / 4);
+        CHECK(BufferPool::getCapacity(capacity) == capacity);
+    }
+}
+
+/*************/
+TEST_CASE("Testing BufferPool recycling through ResizableArray")
+{
+    BufferPool::get().clear();
+    auto stats = BufferPool::get().getStats();
+
+    const size_t size = 1 << 20;
+    char* firstPtr = nullptr;
+    {
+        auto array = ResizableArray<char>(size);
+        firstPtr = array.data();
+    }
+
+    auto releasedStats = BufferPool::get().getStats();
+    CHECK(releasedStats.misses == stats.misses + 1);
+    CHECK(releasedStats.residentSize == BufferPool::getCapacity(size));
+    CHECK(releasedStats.residentCount == 1);
+
+    // A buffer of a size falling in the same bucket reuses the memory
+    auto array = ResizableArray<char>(size - 16);
+    CHECK(array.data() == firstPtr);
+    auto reusedStats = BufferPool::get().getStats();
+    CHECK(reusedStats.hits == stats.hits + 1);
+    CHECK(reusedStats.residentSize == 0);
+
+    // Resizing within the capacity keeps the same memory
+    array.resize(size);
+    CHECK(array.data() == firstPtr);
+    CHECK(array.size() == size);
+}
+
+/*************/
+TEST_CASE("Testing BufferPool resident size limit")
+{
+    BufferPool::get().clear();
+    BufferPool::get().setMaxResidentSize(1 << 21);
+
+    {
+        auto large = ResizableArray<char>(1 << 21);
+        auto small = ResizableArray<char>(1 << 20);
+    }
+
+    // The smallest buffer is released first, then evicted to make room for the largest
+    auto stats = BufferPool::get().getStats();
+    CHECK(stats.residentCount == 1);
+    CHECK(stats.residentSize == 1 << 21);
+
+    BufferPool::get().setMaxResidentSize(SPLASH_BUFFER_POOL_MAX_RESIDENT_SIZE);
+    BufferPool::get().clear();
+}
+
+/*************/
+TEST_CASE("Testing BufferPool idle buckets trimming")
+{
+    BufferPool::get().clear();
+
+    {
+        auto array = ResizableArray<char>(1 << 20);
+    }
+    CHECK(BufferPool::get().getStats().residentCount == 1);
+
+    // Recently used buckets are kept
+    BufferPool::get().trim();
+    CHECK(BufferPool::get().getStats().residentCount == 1);
+
+    BufferPool::get().setIdleTime(chrono::milliseconds(0));
+    BufferPool::get().trim();
+    auto stats = BufferPool::get().getStats();
+    CHECK(stats.residentCount == 0);
+    CHECK(stats.residentSize == 0);
+
+    // A released buffer is kept until the next trim, even with no idle time
+    {
+        auto array = ResizableArray<char>(1 << 20);
+    }
+    CHECK(BufferPool::get().getStats().residentCount == 1);
+
+    BufferPool::get().setIdleTime(chrono::milliseconds(SPLASH_BUFFER_POOL_IDLE_TIME));
+    BufferPool::get().clear();
+}
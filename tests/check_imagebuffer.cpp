@@ -0,0 +1,57 @@
+#include <doctest.h>
+
+#include "./core/imagebuffer.h"
+
+using namespace std;
+using namespace Splash;
+
+/*************/
+TEST_CASE("Testing ImageBufferSpec planar YUV sizes")
+{
+    // Even sizes match the bits per pixel
+    auto spec = ImageBufferSpec(1920, 1080, 3, 12, ImageBufferSpec::Type::UINT8, "YUV420P");
+    CHECK(spec.isPlanarYUV());
+    CHECK(spec.chromaWidth() == 960);
+    CHECK(spec.chromaHeight() == 540);
+    CHECK(spec.rawSize() == 1920 * 1080 * 12 / 8);
+
+    // Odd sizes round the chroma planes up
+    spec = ImageBufferSpec(5, 3, 3, 12, ImageBufferSpec::Type::UINT8, "YUV420P");
+    CHECK(spec.chromaWidth() == 3);
+    CHECK(spec.chromaHeight() == 2);
+    CHECK(spec.rawSize() == 5 * 3 + 2 * 3 * 2);
+
+    spec = ImageBufferSpec(5, 3, 3, 12, ImageBufferSpec::Type::UINT8, "NV12");
+    CHECK(spec.rawSize() == 5 * 3 + 2 * 3 * 2);
+
+    spec = ImageBufferSpec(5, 3, 3, 32, ImageBufferSpec::Type::UINT16, "YUV422P10");
+    CHECK(spec.chromaWidth() == 3);
+    CHECK(spec.chromaHeight() == 3);
+    CHECK(spec.rawSize() == 2 * (5 * 3 + 2 * 3 * 3));
+
+    auto buffer = ImageBuffer(spec);
+    CHECK(buffer.getSize() == static_cast<size_t>(spec.rawSize()));
+
+    // Packed formats are not affected
+    spec = ImageBufferSpec(5, 3, 3, 16, ImageBufferSpec::Type::UINT8, "YUYV");
+    CHECK(!spec.isPlanarYUV());
+    CHECK(spec.rawSize() == 5 * 3 * 2);
+}
+
+/*************/
+TEST_CASE("Testing ImageBufferSpec comparison")
+{
+    auto spec = ImageBufferSpec(1920, 1080, 3, 12, ImageBufferSpec::Type::UINT8, "YUV420P");
+    auto other = spec;
+    CHECK(spec == other);
+
+    other.colorMatrix = ImageBufferSpec::ColorMatrix::BT709;
+    CHECK(spec != other);
+
+    other = spec;
+    other.fullRange = true;
+    CHECK(spec != other);
+
+    other.from_string(spec.to_string());
+    CHECK(spec == other);
+}
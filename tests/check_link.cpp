@@ -0,0 +1,236 @@
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <doctest.h>
+#include <zmq.hpp>
+
+#include "./core/link.h"
+#include "./core/root_object.h"
+#include "./core/serialized_object.h"
+
+#define SPLASH_CHECK_LINK_PORT 29100
+#define SPLASH_CHECK_LINK_TIMEOUT 3000
+
+using namespace std;
+using namespace Splash;
+
+/*************/
+class LinkRootMock : public RootObject
+{
+  public:
+    LinkRootMock(const string& name, int listenPort = 0)
+    {
+        setName(name);
+        _link = make_shared<Link>(this, name, listenPort);
+
+        addAttribute("message",
+            [&](const Values& args) {
+                lock_guard<mutex> lock(_receivedMutex);
+                _messages.push_back(args);
+                return true;
+            },
+            {'s'});
+
+        addAttribute("peerDesynced",
+            [&](const Values& args) {
+                lock_guard<mutex> lock(_receivedMutex);
+                _desyncedPeers.push_back(args[0].as<string>());
+                return true;
+            },
+            {'s'});
+
+        addAttribute("other",
+            [&](const Values& args) {
+                lock_guard<mutex> lock(_receivedMutex);
+                _messages.push_back({"other", args[0]});
+                return true;
+            },
+            {'s'});
+    }
+
+    ~LinkRootMock() override
+    {
+        // The link threads have to stop before the received data is destroyed
+        _link.reset();
+    }
+
+    Link* getLink() { return _link.get(); }
+
+    vector<Values> getMessages()
+    {
+        lock_guard<mutex> lock(_receivedMutex);
+        return _messages;
+    }
+
+    vector<string> getDesyncedPeers()
+    {
+        lock_guard<mutex> lock(_receivedMutex);
+        return _desyncedPeers;
+    }
+
+    map<string, string> getBuffers()
+    {
+        lock_guard<mutex> lock(_receivedMutex);
+        return _buffers;
+    }
+
+    template <typename T>
+    bool waitFor(T condition)
+    {
+        for (int i = 0; i < SPLASH_CHECK_LINK_TIMEOUT; ++i)
+        {
+            if (condition())
+                return true;
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+        return false;
+    }
+
+  protected:
+    void handleSerializedObject(const string& name, shared_ptr<SerializedObject> obj) override
+    {
+        lock_guard<mutex> lock(_receivedMutex);
+        _buffers[name] = string(obj->data(), obj->size());
+    }
+
+  private:
+    mutex _receivedMutex{};
+    vector<Values> _messages{};
+    map<string, string> _buffers{};
+    vector<string> _desyncedPeers{};
+};
+
+/*************/
+shared_ptr<SerializedObject> makeBuffer(const string& content)
+{
+    auto buffer = make_shared<SerializedObject>(content.size());
+    memcpy(buffer->data(), content.data(), content.size());
+    return buffer;
+}
+
+/*************/
+TEST_CASE("Testing Link through TCP on loopback")
+{
+    auto scene = make_unique<LinkRootMock>("scene", SPLASH_CHECK_LINK_PORT);
+    auto world = make_unique<LinkRootMock>("world");
+
+    world->getLink()->connectTo("scene", "127.0.0.1", SPLASH_CHECK_LINK_PORT);
+    scene->getLink()->connectTo("world");
+
+    // Messages go through the per-peer queue, in order
+    for (int i = 0; i < 16; ++i)
+        world->getLink()->sendMessage("scene", "message", {i});
+    REQUIRE(scene->waitFor([&]() { return scene->getMessages().size() == 16; }));
+    auto messages = scene->getMessages();
+    for (int i = 0; i < 16; ++i)
+        CHECK(messages[i][0].as<int>() == i);
+
+    // Buffers are received whole
+    auto content = string(1 << 20, 'a');
+    world->getLink()->sendBuffer("image", makeBuffer(content));
+    REQUIRE(scene->waitFor([&]() { return scene->getBuffers().count("image") != 0; }));
+    CHECK(scene->getBuffers()["image"] == content);
+
+    // And the other way around, from the listening side
+    scene->getLink()->sendMessage("world", "message", {"answer"});
+    REQUIRE(world->waitFor([&]() { return world->getMessages().size() == 1; }));
+    CHECK(world->getMessages()[0][0].as<string>() == "answer");
+}
+
+/*************/
+TEST_CASE("Testing Link message batching")
+{
+    auto scene = make_unique<LinkRootMock>("scene", SPLASH_CHECK_LINK_PORT);
+    auto world = make_unique<LinkRootMock>("world");
+
+    world->getLink()->connectTo("scene", "127.0.0.1", SPLASH_CHECK_LINK_PORT);
+    scene->getLink()->connectTo("world");
+
+    // Coalesced messages replace the queued one at its position, others are appended
+    world->getLink()->startBatch();
+    world->getLink()->sendMessage("scene", "message", {0});
+    world->getLink()->sendMessage("scene", "message", {1}, true);
+    world->getLink()->sendMessage("scene", "other", {"first"}, true);
+    world->getLink()->sendMessage("scene", "message", {2}, true);
+    world->getLink()->sendMessage("scene", "message", {3});
+    world->getLink()->sendMessage("scene", "other", {"second"}, true);
+
+    // Nothing is sent until the batch is flushed
+    this_thread::sleep_for(chrono::milliseconds(100));
+    CHECK(scene->getMessages().empty());
+
+    world->getLink()->flushBatch();
+    REQUIRE(scene->waitFor([&]() { return scene->getMessages().size() == 4; }));
+    auto messages = scene->getMessages();
+    CHECK(messages[0][0].as<int>() == 0);
+    CHECK(messages[1][0].as<int>() == 2);
+    CHECK(messages[2][0].as<string>() == "other");
+    CHECK(messages[2][1].as<string>() == "second");
+    CHECK(messages[3][0].as<int>() == 3);
+
+    // Once flushed, messages are sent right away, even the coalescable ones
+    world->getLink()->sendMessage("scene", "message", {4}, true);
+    world->getLink()->sendMessage("scene", "message", {5}, true);
+    REQUIRE(scene->waitFor([&]() { return scene->getMessages().size() == 6; }));
+    messages = scene->getMessages();
+    CHECK(messages[4][0].as<int>() == 4);
+    CHECK(messages[5][0].as<int>() == 5);
+}
+
+/*************/
+TEST_CASE("Testing Link with a stalled remote peer")
+{
+    auto world = make_unique<LinkRootMock>("world");
+
+    // Nobody listens on this port, so the messages pile up in the peer queue
+    world->getLink()->connectTo("scene", "127.0.0.1", SPLASH_CHECK_LINK_PORT + 10);
+    for (int i = 0; i < 2 * SPLASH_LINK_TCP_MAX_QUEUED_MESSAGES + 2; ++i)
+        world->getLink()->sendMessage("scene", "message", {i});
+
+    // Messages are never dropped, the peer is reported once as out of sync instead
+    REQUIRE(world->waitFor([&]() { return !world->getDesyncedPeers().empty(); }));
+    CHECK(world->getDesyncedPeers().size() == 1);
+    CHECK(world->getDesyncedPeers()[0] == "scene");
+
+    world->getLink()->disconnectFrom("scene");
+}
+
+/*************/
+TEST_CASE("Testing Link with malformed buffers from a remote host")
+{
+    auto scene = make_unique<LinkRootMock>("scene", SPLASH_CHECK_LINK_PORT);
+
+    zmq::context_t context(1);
+    zmq::socket_t socket(context, ZMQ_PUSH);
+    int lingerValue = 0;
+    socket.setsockopt(ZMQ_LINGER, &lingerValue, sizeof(lingerValue));
+    socket.connect(("tcp://127.0.0.1:" + to_string(SPLASH_CHECK_LINK_PORT + 1)).c_str());
+
+    auto sendParts = [&](const vector<string>& parts) {
+        for (size_t i = 0; i < parts.size(); ++i)
+        {
+            zmq::message_t msg(parts[i].size());
+            memcpy(msg.data(), parts[i].data(), parts[i].size());
+            socket.send(msg, i + 1 < parts.size() ? ZMQ_SNDMORE : 0);
+        }
+    };
+
+    // Truncated message, name without its null terminator, wrong transport size, unknown transport, extra part
+    sendParts({string("broken")});
+    sendParts({string("broken", 6), string(1, '\0'), "data"});
+    sendParts({string("broken\0", 7), string(4, '\0'), "data"});
+    sendParts({string("broken\0", 7), string(1, '\x7f'), "data"});
+    sendParts({string("broken\0", 7), string(1, '\0'), "data", "payload", "extra"});
+
+    // A valid buffer still goes through afterwards
+    sendParts({string("valid\0", 6), string(1, '\0'), "data"});
+    REQUIRE(scene->waitFor([&]() { return scene->getBuffers().count("valid") != 0; }));
+    CHECK(scene->getBuffers()["valid"] == "data");
+    CHECK(scene->getBuffers().count("broken") == 0);
+}
@@ -0,0 +1,67 @@
+#include <doctest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "./utils/log.h"
+
+using namespace std;
+using namespace Splash;
+
+/*************/
+TEST_CASE("Testing Log messages")
+{
+    auto& log = Log::get();
+    auto verbosity = log.getVerbosity();
+    log.setVerbosity(Log::MESSAGE);
+
+    log << Log::WARNING << "check_log - value " << 42 << Log::endl;
+    log << Log::DEBUGGING << "check_log - hidden" << Log::endl;
+    log.flush();
+
+    auto logs = log.getLogs(Log::WARNING, Log::DEBUGGING);
+    bool found = false;
+    for (const auto& message : logs)
+    {
+        CHECK(message.find("check_log - hidden") == string::npos);
+        if (message.find("[WARNING] / check_log - value 42") != string::npos)
+            found = true;
+    }
+    CHECK(found);
+
+    log.setVerbosity(verbosity);
+}
+
+/*************/
+TEST_CASE("Testing Log from multiple threads")
+{
+    auto& log = Log::get();
+    auto verbosity = log.getVerbosity();
+    log.setVerbosity(Log::WARNING);
+
+    // Messages built concurrently must not be mixed together
+    vector<thread> threads;
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([t]() {
+            for (int i = 0; i < 25; ++i)
+                Log::get() << Log::WARNING << "check_log_thread_" << t << "_" << t << Log::endl;
+        });
+    for (auto& thread : threads)
+        thread.join();
+    log.flush();
+
+    int count = 0;
+    for (const auto& message : log.getLogs(Log::WARNING))
+    {
+        auto position = message.find("check_log_thread_");
+        if (position == string::npos)
+            continue;
+        auto content = message.substr(position + 17);
+        CHECK(content.size() == 3);
+        CHECK(content[0] == content[2]);
+        ++count;
+    }
+    CHECK(count + log.getDroppedCount() == 100);
+
+    log.setVerbosity(verbosity);
+}
@@ -0,0 +1,50 @@
+#include <doctest.h>
+
+#include "./core/message_codec.h"
+
+using namespace std;
+using namespace Splash;
+
+/*************/
+TEST_CASE("Testing MessageCodec round trip")
+{
+    auto values = Values({1, -42, (int64_t)1 << 40, 3.14159, "some string", Values({"nested", 2, Values({-1.5, "deeper"})})});
+    values[1].setName("negative");
+    values[5].setName("nested");
+
+    vector<uint8_t> frame;
+    MessageCodec::startFrame(frame);
+    MessageCodec::encode(frame, "target", "attribute", values);
+    MessageCodec::encode(frame, "other", "empty", {});
+
+    vector<MessageCodec::Message> messages;
+    REQUIRE(MessageCodec::decode(frame.data(), frame.size(), messages));
+    REQUIRE(messages.size() == 2);
+
+    CHECK(messages[0].target == "target");
+    CHECK(messages[0].attribute == "attribute");
+    CHECK(messages[0].values == values);
+    CHECK(messages[0].values[1].getName() == "negative");
+
+    CHECK(messages[1].target == "other");
+    CHECK(messages[1].attribute == "empty");
+    CHECK(messages[1].values.empty());
+}
+
+/*************/
+TEST_CASE("Testing MessageCodec with malformed frames")
+{
+    vector<uint8_t> frame;
+    MessageCodec::startFrame(frame);
+    MessageCodec::encode(frame, "target", "attribute", {1, "string", Values({2.0, 3.0})});
+
+    vector<MessageCodec::Message> messages;
+    CHECK(!MessageCodec::decode(frame.data(), 0, messages));
+    // A frame holding only the version is empty, but any truncated message is rejected
+    CHECK(MessageCodec::decode(frame.data(), 1, messages));
+    for (size_t size = 2; size < frame.size(); ++size)
+        CHECK(!MessageCodec::decode(frame.data(), size, messages));
+
+    frame[0] = SPLASH_MESSAGE_CODEC_VERSION + 1;
+    CHECK(!MessageCodec::decode(frame.data(), frame.size(), messages));
+}
@@ -0,0 +1,75 @@
+#include <doctest.h>
+
+#include <cstring>
+
+#include "./core/serialized_object.h"
+
+using namespace std;
+using namespace Splash;
+
+/*************/
+TEST_CASE("Testing SerializedObject compression round trip")
+{
+    auto buffer = SerializedObject(1 << 16);
+    for (size_t i = 0; i < buffer.size(); ++i)
+        buffer.data()[i] = static_cast<char>(i / 256);
+
+    auto compressed = buffer.compress();
+    REQUIRE(compressed != nullptr);
+    CHECK(compressed->isCompressed());
+    CHECK(compressed->size() < buffer.size());
+    CHECK(compressed->compress() == nullptr);
+
+    REQUIRE(compressed->decompress());
+    CHECK(!compressed->isCompressed());
+    REQUIRE(compressed->size() == buffer.size());
+    CHECK(memcmp(compressed->data(), buffer.data(), buffer.size()) == 0);
+}
+
+/*************/
+TEST_CASE("Testing SerializedObject compression of incompressible data")
+{
+    auto buffer = SerializedObject(1 << 16);
+    uint32_t state = 42;
+    for (size_t i = 0; i < buffer.size(); ++i)
+    {
+        state = state * 1664525 + 1013904223;
+        buffer.data()[i] = static_cast<char>(state >> 24);
+    }
+    CHECK(buffer.compress() == nullptr);
+
+    // Corrupted data is rejected
+    buffer.setCompressed(true);
+    CHECK(!buffer.decompress());
+}
+
+/*************/
+TEST_CASE("Testing SerializedObject payload")
+{
+    auto payload = make_shared<vector<char>>(1 << 16, 42);
+
+    auto buffer = SerializedObject(16);
+    memset(buffer.data(), 1, buffer.size());
+    buffer.setPayload(payload, payload->data(), payload->size());
+    CHECK(buffer.hasPayload());
+    CHECK(payload.use_count() == 2);
+
+    // Copies share the payload
+    auto copy = buffer;
+    CHECK(payload.use_count() == 3);
+
+    copy.flatten();
+    CHECK(!copy.hasPayload());
+    CHECK(payload.use_count() == 2);
+    REQUIRE(copy.size() == 16 + payload->size());
+    CHECK(copy.data()[0] == 1);
+    CHECK(copy.data()[16] == 42);
+
+    // Compression gathers the data and the payload
+    auto compressed = buffer.compress();
+    REQUIRE(compressed != nullptr);
+    CHECK(!compressed->hasPayload());
+    REQUIRE(compressed->decompress());
+    CHECK(compressed->size() == copy.size());
+    CHECK(memcmp(compressed->data(), copy.data(), copy.size()) == 0);
+}
@@ -0,0 +1,40 @@
+#include <doctest.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "./graphics/shader.h"
+
+using namespace std;
+using namespace Splash;
+
+/*************/
+TEST_CASE("Testing Shader uniforms set through both setters")
+{
+    Shader::Uniform uniform;
+    uniform.type = "vec2";
+    uniform.elementSize = 2;
+
+    const auto typedValue = glm::vec2(3.f, 4.f);
+    const auto typedFloats = glm::value_ptr(typedValue);
+
+    // Values, then typed value, then the same Values again
+    CHECK(uniform.setValues({1.f, 2.f}));
+    CHECK(!uniform.setValues({1.f, 2.f}));
+    CHECK(uniform.stage(Shader::StagedType::vec2, typedFloats, nullptr, 2));
+    CHECK(uniform.values.empty());
+    CHECK(uniform.setValues({1.f, 2.f}));
+    CHECK(uniform.stagedType == Shader::StagedType::none);
+
+    // And the other way around
+    CHECK(uniform.stage(Shader::StagedType::vec2, typedFloats, nullptr, 2));
+    CHECK(!uniform.stage(Shader::StagedType::vec2, typedFloats, nullptr, 2));
+    CHECK(uniform.setValues({1.f, 2.f}));
+    CHECK(uniform.stage(Shader::StagedType::vec2, typedFloats, nullptr, 2));
+    CHECK(uniform.stagedType == Shader::StagedType::vec2);
+
+    // Integer values are compared on their own storage
+    const int typedInts[] = {5, 6};
+    CHECK(uniform.stage(Shader::StagedType::ivec2, nullptr, typedInts, 2));
+    CHECK(!uniform.stage(Shader::StagedType::ivec2, nullptr, typedInts, 2));
+}
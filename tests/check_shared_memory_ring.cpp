@@ -0,0 +1,61 @@
+#include <doctest.h>
+
+#include <cstring>
+#include <unistd.h>
+
+#include "./core/shared_memory_ring.h"
+
+using namespace std;
+using namespace Splash;
+
+/*************/
+SerializedObject makeBuffer(size_t size, char value)
+{
+    auto buffer = SerializedObject(size);
+    memset(buffer.data(), value, buffer.size());
+    return buffer;
+}
+
+/*************/
+TEST_CASE("Testing SharedMemoryRing write and read")
+{
+    SharedMemoryRing writer("/splash_check_shm_" + to_string(getpid()), 4);
+    SharedMemoryRing reader("/splash_check_shm_reader_" + to_string(getpid()), 4);
+
+    auto buffer = makeBuffer(4096, 42);
+    SharedMemoryRing::Descriptor descriptor;
+    REQUIRE(writer.write(buffer, 1, descriptor));
+    CHECK(descriptor.size == buffer.size());
+
+    auto received = reader.read(descriptor);
+    REQUIRE(received != nullptr);
+    CHECK(received->size() == buffer.size());
+    CHECK(memcmp(received->data(), buffer.data(), buffer.size()) == 0);
+}
+
+/*************/
+TEST_CASE("Testing SharedMemoryRing slot reuse")
+{
+    SharedMemoryRing writer("/splash_check_shm_" + to_string(getpid()), 1);
+    SharedMemoryRing reader("/splash_check_shm_reader_" + to_string(getpid()), 1);
+
+    // A slot held by a reader can not be overwritten
+    auto buffer = makeBuffer(1024, 1);
+    SharedMemoryRing::Descriptor firstDescriptor;
+    REQUIRE(writer.write(buffer, 1, firstDescriptor));
+    auto received = reader.read(firstDescriptor);
+    REQUIRE(received != nullptr);
+
+    SharedMemoryRing::Descriptor secondDescriptor;
+    CHECK(!writer.write(buffer, 1, secondDescriptor));
+
+    // Once released, it can be reused and the outdated descriptor is rejected
+    received.reset();
+    buffer = makeBuffer(1024, 2);
+    REQUIRE(writer.write(buffer, 1, secondDescriptor));
+    CHECK(reader.read(firstDescriptor) == nullptr);
+
+    received = reader.read(secondDescriptor);
+    REQUIRE(received != nullptr);
+    CHECK(received->data()[0] == 2);
+}
@@ -0,0 +1,129 @@
+#include <doctest.h>
+#include <string>
+
+#include "./core/small_vector.h"
+#include "./core/value.h"
+
+using namespace std;
+using namespace Splash;
+
+using IntVector = SmallVector<int, 4>;
+using StringVector = SmallVector<string, 2>;
+
+/*************/
+TEST_CASE("Testing SmallVector storage")
+{
+    StringVector vector;
+    CHECK(vector.empty());
+    CHECK(vector.isInline());
+
+    vector.push_back("first");
+    vector.push_back("second");
+    CHECK(vector.isInline());
+
+    vector.push_back("third");
+    CHECK(!vector.isInline());
+    CHECK(vector.size() == 3);
+    CHECK(vector.capacity() >= 3);
+    CHECK(vector[0] == "first");
+    CHECK(vector.back() == "third");
+
+    // Pushing one of its own elements must survive the growth of the storage
+    vector.push_back(vector[0]);
+    vector.push_back(vector[0]);
+    CHECK(vector.size() == 5);
+    CHECK(vector[4] == "first");
+
+    vector.resize(1);
+    CHECK(vector.size() == 1);
+    CHECK(vector.front() == "first");
+}
+
+/*************/
+TEST_CASE("Testing SmallVector insertion and removal")
+{
+    IntVector vector{2, 3};
+    vector.push_front(1);
+    vector.insert(vector.end(), {4, 5, 6});
+    CHECK(vector == IntVector({1, 2, 3, 4, 5, 6}));
+
+    vector.erase(vector.begin() + 1, vector.begin() + 3);
+    CHECK(vector == IntVector({1, 4, 5, 6}));
+
+    vector.pop_front();
+    vector.insert(vector.begin() + 1, 2, 0);
+    CHECK(vector == IntVector({4, 0, 0, 5, 6}));
+
+    int sum = 0;
+    for (auto it = vector.rbegin(); it != vector.rend(); ++it)
+        sum = sum * 10 + *it;
+    CHECK(sum == 65004);
+
+    CHECK_THROWS(vector.at(5));
+}
+
+/*************/
+TEST_CASE("Testing SmallVector copy and move")
+{
+    StringVector inlineVector{"a", "b"};
+    StringVector heapVector{"a", "b", "c"};
+
+    auto inlineCopy = inlineVector;
+    auto heapCopy = heapVector;
+    CHECK(inlineCopy == inlineVector);
+    CHECK(heapCopy == heapVector);
+
+    // Moving heap storage hands over the buffer, while inline elements are moved one by one
+    auto heapData = heapVector.data();
+    auto heapMoved = std::move(heapVector);
+    CHECK(heapMoved.data() == heapData);
+    CHECK(heapVector.empty());
+
+    auto inlineMoved = std::move(inlineVector);
+    CHECK(inlineMoved == inlineCopy);
+    CHECK(inlineVector.empty());
+
+    inlineMoved = heapCopy;
+    CHECK(inlineMoved == heapCopy);
+    inlineMoved.swap(inlineCopy);
+    CHECK(inlineMoved == StringVector({"a", "b"}));
+    CHECK(inlineCopy == heapCopy);
+}
+
+/*************/
+TEST_CASE("Testing Value moves")
+{
+    auto nested = Value(Values({1, "two", Values({3.0})}), "nested");
+    auto copy = nested;
+    auto moved = std::move(nested);
+    CHECK(moved == copy);
+    CHECK(moved.getName() == "nested");
+    CHECK(moved.size() == 3);
+
+    auto text = Value(string("a string too long for the small string optimization"));
+    auto movedText = std::move(text);
+    CHECK(movedText.as<string>() == "a string too long for the small string optimization");
+
+    // Values change of type when assigned to
+    movedText = moved;
+    CHECK(movedText.getType() == Value::Type::values);
+    moved = 42;
+    CHECK(moved.getType() == Value::Type::integer);
+    CHECK(moved.as<int>() == 42);
+    CHECK(!moved.isNamed());
+}
+
+/*************/
+TEST_CASE("Testing Values prefixing")
+{
+    // Prefixing a message in a single insert gives the same result as repeated push_front
+    auto message = Values({1, 2});
+    auto pushed = message;
+    pushed.push_front("attribute");
+    pushed.push_front("object");
+    message.insert(message.begin(), {"object", "attribute"});
+    CHECK(message == pushed);
+    CHECK(message[0].as<string>() == "object");
+    CHECK(message[1].as<string>() == "attribute");
+    CHECK(message[2].as<int>() == 1);
+}
@@ -0,0 +1,99 @@
+#include <doctest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "./core/task_queue.h"
+
+using namespace std;
+using namespace Splash;
+
+/*************/
+TEST_CASE("Testing TaskQueue order and coalescing")
+{
+    TaskQueue queue;
+    vector<int> results;
+    queue.push([&]() { results.push_back(0); });
+    queue.push([&]() { results.push_back(1); }, "key");
+    queue.push([&]() { results.push_back(2); });
+    queue.push([&]() { results.push_back(3); }, "key");
+    queue.push([&]() { results.push_back(4); }, "other");
+
+    CHECK(queue.run() == 4);
+    CHECK(results == vector<int>({0, 2, 3, 4}));
+    CHECK(queue.empty());
+
+    // Tasks added while running are left for the next call
+    results.clear();
+    queue.push([&]() { queue.push([&]() { results.push_back(1); }); });
+    CHECK(queue.run() == 1);
+    CHECK(results.empty());
+    CHECK(queue.run() == 1);
+    CHECK(results == vector<int>({1}));
+}
+
+/*************/
+TEST_CASE("Testing TaskQueue with multiple producers")
+{
+    TaskQueue queue;
+    const int producerCount = 4;
+    const int taskCount = 10000;
+
+    vector<thread> producers;
+    vector<int> counters(producerCount, 0);
+    vector<int> lastValues(producerCount, -1);
+    bool ordered = true;
+    for (int p = 0; p < producerCount; ++p)
+        producers.emplace_back([&, p]() {
+            for (int i = 0; i < taskCount; ++i)
+                queue.push([&, p, i]() {
+                    ordered = ordered && i > lastValues[p];
+                    lastValues[p] = i;
+                    ++counters[p];
+                });
+        });
+
+    int runCount = 0;
+    while (runCount < producerCount * taskCount)
+        runCount += queue.run();
+
+    for (auto& producer : producers)
+        producer.join();
+
+    CHECK(ordered);
+    for (int p = 0; p < producerCount; ++p)
+        CHECK(counters[p] == taskCount);
+}
+
+/*************/
+TEST_CASE("Testing TaskQueue run from several threads")
+{
+    TaskQueue queue;
+    atomic_bool started{false};
+    atomic_bool done{false};
+    queue.push([&]() {
+        started = true;
+        this_thread::sleep_for(chrono::milliseconds(50));
+        done = true;
+    });
+
+    auto runner = thread([&]() { queue.run(); });
+    while (!started)
+        this_thread::yield();
+
+    // A concurrent run waits for the running one, so the queued task is done when it returns
+    CHECK(queue.run() == 0);
+    CHECK(done);
+    runner.join();
+
+    // Tasks can run the queue themselves
+    int nestedCount = 0;
+    queue.push([&]() {
+        queue.push([&]() { ++nestedCount; });
+        queue.run();
+    });
+    CHECK(queue.run() == 1);
+    CHECK(nestedCount == 1);
+}
@@ -0,0 +1,58 @@
+#include <doctest.h>
+
+#include <atomic>
+#include <numeric>
+#include <vector>
+
+#include "./core/thread_pool.h"
+
+using namespace std;
+using namespace Splash;
+
+/*************/
+TEST_CASE("Testing ThreadPool futures")
+{
+    ThreadPool pool(4);
+    CHECK(pool.getWorkerCount() == 4);
+
+    vector<future<int>> futures;
+    for (int i = 0; i < 64; ++i)
+        futures.push_back(pool.submit([i]() { return i * i; }));
+
+    for (int i = 0; i < 64; ++i)
+        CHECK(futures[i].get() == i * i);
+
+    CHECK(pool.getStats().queued == 0);
+}
+
+/*************/
+TEST_CASE("Testing TaskGroup nested waits")
+{
+    // Each outer task waits for inner tasks, which would starve a pool without work stealing
+    ThreadPool pool(2);
+    atomic_int counter{0};
+    {
+        TaskGroup outer(pool);
+        for (int i = 0; i < 8; ++i)
+            outer.run([&]() {
+                TaskGroup inner(pool);
+                for (int j = 0; j < 8; ++j)
+                    inner.run([&]() { ++counter; });
+                inner.wait();
+            });
+        outer.wait();
+    }
+    CHECK(counter == 64);
+}
+
+/*************/
+TEST_CASE("Testing TaskGroup with a throwing task")
+{
+    ThreadPool pool(2);
+    atomic_int counter{0};
+    TaskGroup group(pool);
+    group.run([]() { throw runtime_error("expected"); });
+    group.run([&]() { ++counter; });
+    group.wait();
+    CHECK(counter == 1);
+}
@@ -0,0 +1,134 @@
+#include <doctest.h>
+#include <string>
+#include <thread>
+
+#include "./utils/timer.h"
+
+using namespace std;
+using namespace Splash;
+
+/*************/
+TEST_CASE("Testing Timer slots")
+{
+    auto& timer = Timer::get();
+    auto slot = timer.getSlot("check_timer_slot");
+    CHECK(static_cast<bool>(slot));
+    CHECK(timer.getSlot("check_timer_slot").id == slot.id);
+    CHECK(timer.getSlot("check_timer_other_slot").id != slot.id);
+
+    // A slot registered from another thread is shared
+    uint32_t threadSlotId = 0;
+    thread([&]() { threadSlotId = Timer::get().getSlot("check_timer_slot").id; }).join();
+    CHECK(threadSlotId == slot.id);
+
+    timer << slot;
+    this_thread::sleep_for(chrono::milliseconds(2));
+    timer >> slot;
+    CHECK(timer.getDuration(slot) >= 2000);
+    CHECK(timer["check_timer_slot"] == timer.getDuration(slot));
+    CHECK(timer.getDurationMap().count("check_timer_slot") == 1);
+    CHECK(timer.getDurationMap().count("check_timer_unknown") == 0);
+}
+
+/*************/
+TEST_CASE("Testing Timer slot release")
+{
+    auto& timer = Timer::get();
+    auto slot = timer.acquireSlot("check_timer_held_slot");
+    CHECK(static_cast<bool>(slot));
+    CHECK(timer.getSlot("check_timer_held_slot").id == slot.id);
+
+    // The slot stays registered until all its holders released it
+    auto otherHolder = timer.acquireSlot("check_timer_held_slot");
+    CHECK(otherHolder.id == slot.id);
+    timer.setDuration(slot, 42);
+    auto slotId = slot.id;
+    timer.releaseSlot(slot);
+    CHECK(!slot);
+    CHECK(timer.getDuration("check_timer_held_slot") == 42);
+
+    timer.releaseSlot(otherHolder);
+    CHECK(timer.getDurationMap().count("check_timer_held_slot") == 0);
+    CHECK(timer.getSlotName({slotId}).empty());
+
+    // Released ids are reused, and the per thread caches do not return them for the former name
+    auto reusedSlot = timer.acquireSlot("check_timer_reused_slot");
+    CHECK(reusedSlot.id == slotId);
+    CHECK(timer.getSlotName(reusedSlot) == "check_timer_reused_slot");
+    CHECK(timer.getStats(reusedSlot).count == 0);
+    CHECK(timer.getSlot("check_timer_held_slot").id != slotId);
+    timer.releaseSlot(reusedSlot);
+}
+
+/*************/
+TEST_CASE("Testing Timer statistics")
+{
+    auto& timer = Timer::get();
+    for (int i = 1; i <= 100; ++i)
+        timer.setDuration("check_timer_stats", i);
+
+    auto stats = timer.getStats("check_timer_stats");
+    CHECK(stats.count == 100);
+    CHECK(stats.last == 100);
+    CHECK(stats.min == 1);
+    CHECK(stats.max == 100);
+    CHECK(stats.mean == 50);
+    CHECK(stats.p50 == 50);
+    CHECK(stats.p99 == 99);
+
+    // Only the last samples are kept
+    for (int i = 0; i < SPLASH_TIMER_WINDOW_SIZE; ++i)
+        timer.setDuration("check_timer_stats", 1000);
+    stats = timer.getStats("check_timer_stats");
+    CHECK(stats.min == 1000);
+    CHECK(stats.p99 == 1000);
+}
+
+/*************/
+TEST_CASE("Testing Timer across threads")
+{
+    auto& timer = Timer::get();
+
+    // Started in a thread, stopped in another one
+    timer << "check_timer_cross_thread";
+    thread([]() { Timer::get() >> "check_timer_cross_thread"; }).join();
+    CHECK(timer.getStats("check_timer_cross_thread").count == 1);
+
+    // Nested measurements on a single thread
+    timer << "check_timer_outer";
+    timer << "check_timer_inner";
+    this_thread::sleep_for(chrono::milliseconds(1));
+    timer >> "check_timer_inner";
+    timer >> "check_timer_outer";
+    CHECK(timer.getDuration("check_timer_outer") >= timer.getDuration("check_timer_inner"));
+
+    // The duration to wait for is set per thread
+    timer << "check_timer_wait";
+    timer >> 2000 >> "check_timer_wait";
+    CHECK(timer.getDuration("check_timer_wait") >= 2000);
+}
+
+/*************/
+TEST_CASE("Testing Timer tracing")
+{
+    auto& timer = Timer::get();
+    auto& tracer = Tracer::get();
+
+    timer << "check_timer_untraced";
+    timer >> "check_timer_untraced";
+
+    tracer.setEnabled(true);
+    auto slot = timer.getSlot("check_timer_traced");
+    timer << slot;
+    timer >> slot;
+    tracer.setEnabled(false);
+
+    auto events = tracer.getEvents();
+    CHECK(events.size() == 1);
+    CHECK(events[0].name == slot.id);
+
+    auto trace = Tracer::toChromeTrace(events, 3, "check", [](uint32_t id) { return Timer::get().getSlotName({id}); });
+    CHECK(trace.size() == 2);
+    CHECK(trace[1]["name"].asString() == "check_timer_traced");
+    CHECK(trace[1]["pid"].asInt() == 3);
+}
@@ -0,0 +1,293 @@
+#!/usr/bin/env python3
+
+# This script generates synthetic multi-projector configurations, runs Splash
+# on them for a fixed duration and summarizes the recorded timings with
+# percentiles. It works fully offline: meshes are generated procedurally, and
+# the test video is generated through the ffmpeg command line tool, falling
+# back to an image pattern if it is not available.
+#
+# Examples:
+#   pipeline_benchmark.py generate -o /tmp/synth --scenes 2 --windows 2 --cameras 4
+#   pipeline_benchmark.py run --scenes 2 --windows 2 --cameras 4 --duration 30 --headless
+#   pipeline_benchmark.py run --config /tmp/synth/synthetic.json --json summary.json
+#   pipeline_benchmark.py summarize trace.json
+
+import argparse
+import json
+import math
+import os
+import shutil
+import signal
+import subprocess
+import sys
+import tempfile
+
+# Trace events summarized by default, matched by prefix
+DEFAULT_METRICS = ["loop_world", "loop_scene", "textureUpload", "swap", "decode"]
+PERCENTILES = [50, 90, 95, 99]
+
+
+def write_mesh(path, resolution):
+    """Write a half sphere facing the cameras, with UVs and normals, as a Wavefront OBJ file"""
+    with open(path, "w") as obj:
+        obj.write("o dome\n")
+        for j in range(resolution + 1):
+            theta = math.pi / 2.0 * j / resolution
+            for i in range(resolution + 1):
+                phi = 2.0 * math.pi * i / resolution
+                normal = (math.sin(theta) * math.cos(phi), math.sin(theta) * math.sin(phi), math.cos(theta))
+                obj.write("v {:.6f} {:.6f} {:.6f}\n".format(*normal))
+                obj.write("vt {:.6f} {:.6f}\n".format(i / resolution, j / resolution))
+                # Normals point inwards, as the surface is seen from inside
+                obj.write("vn {:.6f} {:.6f} {:.6f}\n".format(*[-n for n in normal]))
+
+        for j in range(resolution):
+            for i in range(resolution):
+                a = j * (resolution + 1) + i + 1
+                b = a + 1
+                c = a + resolution + 2
+                d = a + resolution + 1
+                obj.write("f {0}/{0}/{0} {1}/{1}/{1} {2}/{2}/{2} {3}/{3}/{3}\n".format(a, b, c, d))
+
+
+def write_video(path, width, height, framerate, duration, codec):
+    """Generate a test video with ffmpeg, return False if it could not be generated"""
+    ffmpeg = shutil.which("ffmpeg")
+    if ffmpeg is None:
+        return False
+
+    command = [ffmpeg, "-y", "-loglevel", "error", "-f", "lavfi",
+               "-i", "testsrc2=size={}x{}:rate={}".format(width, height, framerate),
+               "-t", str(duration), "-c:v", codec]
+    if codec == "libx264":
+        command += ["-pix_fmt", "yuv420p"]
+    command.append(path)
+
+    return subprocess.call(command) == 0
+
+
+def generate_configuration(directory, args):
+    """Generate a configuration with its mesh and video in the given directory, return its path"""
+    os.makedirs(directory, exist_ok=True)
+
+    write_mesh(os.path.join(directory, "dome.obj"), args.mesh_resolution)
+
+    video = {"type": "image_ffmpeg", "file": ["video.mov"], "loop": [1]}
+    width, height = args.video_size
+    if not write_video(os.path.join(directory, "video.mov"), width, height, args.video_framerate, args.video_duration, args.codec):
+        print("Unable to generate the test video with ffmpeg, using an image pattern instead", file=sys.stderr)
+        video = {"type": "image", "pattern": [1]}
+
+    window_width, window_height = args.window_size
+    scenes = {}
+    for scene_index in range(args.scenes):
+        objects = {
+            "dome": {"type": "mesh", "file": ["dome.obj"]},
+            "video": video,
+            "object": {"type": "object", "fill": ["texture"], "sideness": [0]},
+        }
+        links = [["dome", "object"], ["video", "object"]]
+
+        for window_index in range(args.windows):
+            objects["window_{}".format(window_index)] = {
+                "type": "window",
+                "decorated": [0],
+                "position": [window_index * window_width, 0],
+                "size": [window_width, window_height],
+                "srgb": [1],
+            }
+
+        # Cameras are spread around the dome, and over the windows
+        for camera_index in range(args.cameras):
+            camera_name = "camera_{}_{}".format(scene_index, camera_index)
+            warp_name = "{}_warp".format(camera_name)
+            angle = 2.0 * math.pi * (scene_index * args.cameras + camera_index) / (args.scenes * args.cameras)
+            objects[camera_name] = {
+                "type": "camera",
+                "eye": [0.2 * math.cos(angle), 0.2 * math.sin(angle), 0.1],
+                "target": [math.cos(angle), math.sin(angle), 0.5],
+                "up": [0, 0, 1],
+                "fov": [60],
+                "size": [window_width, window_height],
+            }
+            objects[warp_name] = {"type": "warp"}
+            links += [["object", camera_name], [camera_name, warp_name], [warp_name, "window_{}".format(camera_index % args.windows)]]
+
+        scenes["scene_{}".format(scene_index)] = {
+            "type": "scene",
+            "address": "localhost",
+            "spawn": 1,
+            "swapInterval": [args.swap_interval],
+            "objects": objects,
+            "links": links,
+        }
+
+    configuration = {
+        "description": "splashConfiguration",
+        "version": "0.7.20",
+        "scenes": scenes,
+        "world": {"framerate": [args.world_framerate]},
+    }
+
+    path = os.path.join(directory, "synthetic.json")
+    with open(path, "w") as config_file:
+        json.dump(configuration, config_file, indent=3, sort_keys=True)
+
+    return path
+
+
+def run_splash(splash, config, trace, duration, headless):
+    """Run Splash on the given configuration for the given duration, saving its trace"""
+    command = [splash, "-T", trace]
+    if headless:
+        command.append("-E")
+    command.append(config)
+
+    process = subprocess.Popen(command, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    try:
+        process.wait(timeout=duration)
+        print("Splash exited before the end of the benchmark", file=sys.stderr)
+        return False
+    except subprocess.TimeoutExpired:
+        pass
+
+    # Splash saves the trace when asked to quit, before stopping the Scenes
+    process.send_signal(signal.SIGTERM)
+    try:
+        process.wait(timeout=30)
+    except subprocess.TimeoutExpired:
+        process.kill()
+        print("Splash did not quit in time, the trace may be incomplete", file=sys.stderr)
+
+    return os.path.exists(trace)
+
+
+def percentile(values, p):
+    """Linearly interpolated percentile of sorted values"""
+    if not values:
+        return 0.0
+    rank = (len(values) - 1) * p / 100.0
+    lower = int(math.floor(rank))
+    upper = min(lower + 1, len(values) - 1)
+    return values[lower] + (values[upper] - values[lower]) * (rank - lower)
+
+
+def summarize(trace, metrics, warmup):
+    """Summarize the durations of the matching trace events, per process, in milliseconds"""
+    with open(trace) as trace_file:
+        events = json.load(trace_file)["traceEvents"]
+
+    process_names = {}
+    for event in events:
+        if event.get("ph") == "M" and event.get("name") == "process_name":
+            process_names[event["pid"]] = event["args"]["name"]
+
+    timed_events = [event for event in events if event.get("ph") == "X"]
+    if not timed_events:
+        return {}
+
+    # Events recorded while loading the configuration are skipped
+    start = min(event["ts"] for event in timed_events) + warmup * 1e6
+
+    durations = {}
+    for event in timed_events:
+        if event["ts"] < start:
+            continue
+        if metrics and not any(event["name"].startswith(metric) for metric in metrics):
+            continue
+        key = "{}: {}".format(process_names.get(event["pid"], event["pid"]), event["name"])
+        durations.setdefault(key, []).append(event["dur"] / 1000.0)
+
+    summary = {}
+    for key, values in sorted(durations.items()):
+        values.sort()
+        entry = {"count": len(values), "mean": sum(values) / len(values), "max": values[-1]}
+        for p in PERCENTILES:
+            entry["p{}".format(p)] = percentile(values, p)
+        summary[key] = entry
+
+    return summary
+
+
+def print_summary(summary):
+    columns = ["count", "mean"] + ["p{}".format(p) for p in PERCENTILES] + ["max"]
+    width = max([len(key) for key in summary] + [10])
+    print("{:<{}}".format("event (ms)", width) + "".join("{:>10}".format(column) for column in columns))
+    for key, entry in summary.items():
+        line = "{:<{}}".format(key, width) + "{:>10}".format(entry["count"])
+        line += "".join("{:>10.3f}".format(entry[column]) for column in columns[1:])
+        print(line)
+
+
+def add_generation_arguments(parser):
+    parser.add_argument("--scenes", type=int, default=1, help="Number of Scenes")
+    parser.add_argument("--windows", type=int, default=1, help="Number of windows per Scene")
+    parser.add_argument("--cameras", type=int, default=1, help="Number of cameras per Scene, spread over the windows")
+    parser.add_argument("--window-size", type=int, nargs=2, default=[1920, 1080], metavar=("WIDTH", "HEIGHT"), help="Window and camera size")
+    parser.add_argument("--mesh-resolution", type=int, default=64, help="Number of subdivisions of the generated dome")
+    parser.add_argument("--video-size", type=int, nargs=2, default=[1920, 1080], metavar=("WIDTH", "HEIGHT"), help="Test video size")
+    parser.add_argument("--video-framerate", type=int, default=30, help="Test video framerate")
+    parser.add_argument("--video-duration", type=int, default=10, help="Test video duration, in seconds, looped while running")
+    parser.add_argument("--codec", default="hap", help="ffmpeg encoder for the test video, e.g. hap, mjpeg or libx264")
+    parser.add_argument("--swap-interval", type=int, default=1, help="Swap interval of the Scenes, 0 to render as fast as possible")
+    parser.add_argument("--world-framerate", type=int, default=60, help="World loop framerate")
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Generate synthetic configurations and benchmark the Splash pipeline")
+    subparsers = parser.add_subparsers(dest="command")
+
+    generate_parser = subparsers.add_parser("generate", help="Generate a synthetic configuration")
+    generate_parser.add_argument("-o", "--output", required=True, help="Output directory")
+    add_generation_arguments(generate_parser)
+
+    run_parser = subparsers.add_parser("run", help="Run Splash on a configuration and summarize its timings")
+    run_parser.add_argument("--config", help="Configuration to run, a synthetic one is generated if not set")
+    run_parser.add_argument("--splash", default="splash", help="Path to the Splash executable")
+    run_parser.add_argument("--duration", type=float, default=20.0, help="Duration of the run, in seconds")
+    run_parser.add_argument("--warmup", type=float, default=3.0, help="Duration ignored at the start of the run, in seconds")
+    run_parser.add_argument("--headless", action="store_true", help="Render without any display server (needs GLFW 3.4)")
+    run_parser.add_argument("--all", action="store_true", help="Summarize all recorded events")
+    run_parser.add_argument("--trace", help="Path to save the trace to, kept after the run")
+    run_parser.add_argument("--json", help="Path to save the summary to, as JSON")
+    add_generation_arguments(run_parser)
+
+    summarize_parser = subparsers.add_parser("summarize", help="Summarize an existing trace")
+    summarize_parser.add_argument("trace", help="Trace saved by Splash")
+    summarize_parser.add_argument("--warmup", type=float, default=0.0, help="Duration ignored at the start of the trace, in seconds")
+    summarize_parser.add_argument("--all", action="store_true", help="Summarize all recorded events")
+    summarize_parser.add_argument("--json", help="Path to save the summary to, as JSON")
+
+    args = parser.parse_args()
+
+    if args.command == "generate":
+        print(generate_configuration(args.output, args))
+        sys.exit(0)
+    elif args.command == "run":
+        work_directory = tempfile.mkdtemp(prefix="splash_benchmark_")
+        config = args.config if args.config else generate_configuration(work_directory, args)
+        trace = args.trace if args.trace else os.path.join(work_directory, "trace.json")
+
+        splash = shutil.which(args.splash)
+        if splash is None:
+            print("Unable to find the Splash executable: {}".format(args.splash), file=sys.stderr)
+            sys.exit(1)
+
+        success = run_splash(splash, os.path.abspath(config), os.path.abspath(trace), args.duration, args.headless)
+        if not success:
+            print("The benchmark did not complete, no summary is available", file=sys.stderr)
+            sys.exit(1)
+
+        summary = summarize(trace, None if args.all else DEFAULT_METRICS, args.warmup)
+        if not args.trace:
+            shutil.rmtree(work_directory, ignore_errors=True)
+    elif args.command == "summarize":
+        summary = summarize(args.trace, None if args.all else DEFAULT_METRICS, args.warmup)
+    else:
+        parser.print_help()
+        sys.exit(1)
+
+    print_summary(summary)
+    if args.json:
+        with open(args.json, "w") as json_file:
+            json.dump(summary, json_file, indent=2)